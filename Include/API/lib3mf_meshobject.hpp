@@ -103,6 +103,18 @@ public:
 
 	void SetGeometry(const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer, const Lib3MF_uint64 nIndicesBufferSize, const sLib3MFTriangle * pIndicesBuffer);
 
+	Lib3MF_pvoid GetVertexData(Lib3MF_uint32 & nVertexCount, Lib3MF_uint32 & nStride);
+
+	Lib3MF_pvoid GetTriangleIndexData(Lib3MF_uint32 & nTriangleCount, Lib3MF_uint32 & nStride);
+
+	bool QuantizeVertices(const Lib3MF_uint32 nDecimalPrecision);
+
+	bool HasQuantizedVertices();
+
+	Lib3MF_uint32 AddVertices(const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer);
+
+	Lib3MF_uint32 AddTriangles(const Lib3MF_uint64 nIndicesBufferSize, const sLib3MFTriangle * pIndicesBuffer);
+
 	bool IsManifoldAndOriented();
 
 	bool IsMeshObject();
@@ -125,6 +137,10 @@ public:
 
 	void GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer);
 
+	void SetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nPropertiesArrayBufferSize, const sLib3MFTriangleProperties * pPropertiesArrayBuffer);
+
+	void GetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer);
+
 	void ClearAllProperties();
 };
 
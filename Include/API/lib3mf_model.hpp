@@ -58,6 +58,14 @@ private:
 
 	NMR::PModel m_model;
 
+	// Creates a new model with the attachments, materials, metadata and settings of this model
+	std::unique_ptr<CModel> createMergedModel(NMR::UniqueResourceIDMapping & oldToNewUniqueResourceIDs);
+
+	// Copies a mesh object of this model into a merged model once, together with the mesh objects its beam lattice refers to.
+	// Returns null for an object which is being copied already, i.e. for cyclic references.
+	NMR::CModelMeshObject * copyMeshObjectToMergedModel(NMR::CModel & newModel, NMR::CModelMeshObject * pSourceObject,
+		std::map<NMR::CModelMeshObject *, NMR::CModelMeshObject *> & CopiedMeshObjects, NMR::UniqueResourceIDMapping & oldToNewUniqueResourceIDs);
+
 protected:
 
 	/**
@@ -85,6 +93,18 @@ public:
 
 	void SetLanguage (const std::string & sLanguage);
 
+	bool GetUseMemoryArena ();
+
+	void SetUseMemoryArena (const bool bUseMemoryArena);
+
+	Lib3MF_uint64 GetMemoryArenaUsage (Lib3MF_uint64 & nReservedSize);
+
+	Lib3MF_uint64 GetMemoryUsage (Lib3MF_uint64 & nResourceMemoryUsage, Lib3MF_uint64 & nAttachmentMemoryUsage);
+
+	void SetTrackPeakMemoryUsage (const bool bTrackPeakMemoryUsage);
+
+	Lib3MF_uint64 GetPeakMemoryUsage ();
+
 	IWriter * QueryWriter (const std::string & sWriterClass);
 
 	IReader * QueryReader (const std::string & sReaderClass);
@@ -115,6 +135,8 @@ public:
 
 	IBuildItemIterator * GetBuildItems ();
 
+	IMeshInstanceIterator * GetMeshInstances ();
+
 	IResourceIterator * GetResources ();
 
 	IObjectIterator * GetObjects ();
@@ -139,6 +161,8 @@ public:
 
 	IModel * MergeToModel ();
 
+	IModel * MergeToInstancedModel ();
+
 	IMeshObject * AddMeshObject ();
 
 	IComponentsObject * AddComponentsObject ();
@@ -77,6 +77,8 @@ public:
 
 	Lib3MF_uint32 GetResourceID ();
 
+	Lib3MF_uint64 GetMemoryUsage ();
+
 	virtual IObject * AsObject();
 
 };
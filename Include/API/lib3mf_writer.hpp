@@ -44,6 +44,7 @@ Abstract: This is the class declaration of CWriter
 #include "Model/Writer/NMR_ModelWriter.h"
 #include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
 #include "Model/Writer/NMR_ModelWriter_STL.h"
+#include "Model/Writer/NMR_ModelWriteOperation.h"
 
 namespace Lib3MF {
 namespace Impl {
@@ -59,6 +60,9 @@ private:
 	* Put private members here.
 	*/
 	NMR::PModelWriter m_pWriter;
+	NMR::PModelWriteOperation m_pWriteOperation;
+
+	void checkNoWriteInProgress();
 
 protected:
 
@@ -74,23 +78,53 @@ public:
 	CWriter(std::string sWriterClass, NMR::PModel model);
 
 	NMR::CModelWriter& writer();
+
+	NMR::CModelWriter_3MF_Native& streamWriter();
+
+	void beginStream(NMR::PExportStream pStream);
 	/**
 	* Public member functions to implement.
 	*/
 
 	void WriteToFile(const std::string & sFilename) override;
 
+	IWriteOperation * WriteToFileAsync(const std::string & sFilename) override;
+
 	Lib3MF_uint64 GetStreamSize() override;
 
 	void WriteToBuffer(Lib3MF_uint64 nBufferBufferSize, Lib3MF_uint64* pBufferNeededCount, Lib3MF_uint8 * pBufferBuffer) override;
 
 	void WriteToCallback(const Lib3MFWriteCallback pTheWriteCallback, const Lib3MFSeekCallback pTheSeekCallback, const Lib3MF_pvoid pUserData) override;
 
+	void BeginStreamToFile(const std::string & sFilename) override;
+
+	void BeginStreamToCallback(const Lib3MFWriteCallback pTheWriteCallback, const Lib3MFSeekCallback pTheSeekCallback, const Lib3MF_pvoid pUserData) override;
+
+	void AppendObject(IObject* pObjectResource) override;
+
+	void FinishStream() override;
+
 	void SetProgressCallback(const Lib3MFProgressCallback pProgressCallback, const Lib3MF_pvoid pUserData) override;
 
 	Lib3MF_uint32 GetDecimalPrecision() override;
 
 	void SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision) override;
+
+	bool GetVertexCacheOptimization() override;
+
+	void SetVertexCacheOptimization(const bool bVertexCacheOptimization) override;
+
+	bool GetMeshDeduplication() override;
+
+	void SetMeshDeduplication(const bool bMeshDeduplication) override;
+
+	bool GetRigidMeshDeduplication() override;
+
+	void SetRigidMeshDeduplication(const bool bRigidMeshDeduplication) override;
+
+	bool GetReleaseStreamedMeshes() override;
+
+	void SetReleaseStreamedMeshes(const bool bReleaseStreamedMeshes) override;
 };
 
 }
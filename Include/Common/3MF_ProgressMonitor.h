@@ -33,6 +33,7 @@ Abstract: Progress Monitor
 
 #include "Common/3MF_ProgressTypes.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <stack>
@@ -58,6 +59,10 @@ namespace NMR
 		bool QueryCancelled(bool throwIfCancelled);
 		bool ReportProgressAndQueryCancelled(bool throwIfCancelled);
 
+		// Cancellation from outside of the callback, e.g. by another thread
+		void RequestCancel();
+		void ClearCancelRequest();
+
 		void IncrementProgress(double dProgressIncrement);
 		void SetProgressIdentifier(ProgressIdentifier identifier);
 		void SetMaxProgress(double);
@@ -73,6 +78,7 @@ namespace NMR
 		void* m_userData;
 		bool m_lastCallbackResult;
 		std::mutex m_callbackMutex;
+		std::atomic<bool> m_bCancelRequested;
 	};
 
 	typedef std::shared_ptr <CProgressMonitor> PProgressMonitor;
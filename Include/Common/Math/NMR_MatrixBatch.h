@@ -0,0 +1,53 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MatrixBatch.h defines transforms and normal calculations for arrays of
+vectors. They compute the same as the corresponding single vector functions,
+using SSE, AVX or NEON instructions where available.
+
+--*/
+
+#ifndef __NMR_MATRIXBATCH
+#define __NMR_MATRIXBATCH
+
+#include "Common/Math/NMR_Geometry.h" 
+#include <cstddef>
+
+namespace NMR {
+
+	// Applies mMatrix to nCount vectors, like fnMATRIX3_apply. pSource and pTarget may be identical, but must not
+	// overlap otherwise. The identity copies and pure translations only add, which keeps the sign of zero coordinates.
+	void fnMATRIX3_applyBatch(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount);
+
+	// Calculates the normals of nTriangleCount triangles, like fnVEC3_calcTriangleNormal.
+	// pVertices holds the three corners of each triangle consecutively. pNormals may be identical to pVertices.
+	void fnVEC3_calcTriangleNormalBatch(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount);
+
+}
+
+#endif // __NMR_MATRIXBATCH
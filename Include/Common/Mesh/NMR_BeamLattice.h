@@ -44,13 +44,12 @@ namespace NMR {
 	private:
 		friend class CMesh;
 
-		MESHNODES &m_Nodes;	// reference to the nodes of the parent mesh
 		MESHBEAMS m_Beams;
 		std::vector<PBEAMSET> m_pBeamSets;
 		
 		nfDouble m_dMinLength;
 	public:
-		CBeamLattice(_In_ MESHNODES &nodes);
+		CBeamLattice();
 
 		void clear();
 	};
@@ -48,19 +48,55 @@ You can only add nodes and faces to mesh. You cannot remove the existing structu
 #include "Common/Mesh/NMR_BeamLattice.h"
 
 #include <map>
+#include <memory>
+#include <set>
 
 namespace NMR {
 
+	class CMesh;
+
+	// A mesh to be merged, together with the transform which is applied to its nodes
+	typedef struct {
+		CMesh * m_pMesh;
+		NMATRIX3 m_mMatrix;
+	} MESHMERGEINSTANCE;
+
 	class CMesh {
 	private:
-		MESHNODES m_Nodes;
-		MESHFACES m_Faces;
+		// Node and face arrays are shared between copies of a mesh. A mesh takes its own copy
+		// of an array before modifying it, so copies only duplicate the geometry that is edited.
+		std::shared_ptr<MESHNODES> m_pNodes;
+		std::shared_ptr<MESHFACES> m_pFaces;
 		CBeamLattice m_BeamLattice;
 
+		// Quantized node storage. If active, the node array is empty and the nodes are packed into
+		// m_pQuantizedNodes with m_Quantization.m_nNodeBits bits each, with an origin and a step per axis.
+		// Quantized nodes are never modified in place and are shared between copies as well.
+		nfBool m_bQuantizedNodes;
+		std::shared_ptr<const std::vector<nfUint64>> m_pQuantizedNodes;
+		MESHNODEQUANTIZATION m_Quantization;
+
 		PMeshInformationHandler m_pMeshInformationHandler;
+		PMemoryArena m_pMemoryArena;
+
+		// Cached bounding box of all nodes. It grows with added nodes and is recalculated
+		// lazily after mutable access to the nodes, which might have moved them.
+		nfBool m_bOutboxValid;
+		nfBool m_bOutboxHasNaN;
+		NOUTBOX3 m_Outbox;
+
+		nfUint64 m_nModificationCount;
+
+		// Node and face arrays for modification, which are no longer shared afterwards
+		MESHNODES & getWritableNodes();
+		MESHFACES & getWritableFaces();
+
+		void calculateOutbox();
+		void mergeNodesIntoOutbox(_In_ nfUint32 nFirstIndex, _In_ nfUint32 nNodeCount);
 
 	public:
 		CMesh();
+		// Copies pMesh. The copy shares the node and face arrays of a valid mesh until either mesh modifies them.
 		CMesh(_In_opt_ CMesh * pMesh);
 
 		void mergeMesh(_In_opt_ CMesh * pMesh);
@@ -68,12 +104,29 @@ namespace NMR {
 		void mergeMesh(_In_opt_ CMesh * pMesh, _In_ NMATRIX3 mMatrix);
 		void addToMesh(_In_opt_ CMesh * pMesh, _In_ NMATRIX3 mMatrix);
 
-		_Ret_notnull_ MESHNODE * addNode(_In_ const NVEC3 vPosition);
-		_Ret_notnull_ MESHNODE * addNode(_In_ const nfFloat posX, _In_ const nfFloat posY, _In_ const nfFloat posZ);
-		_Ret_notnull_ MESHFACE * addFace(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ MESHNODE * pNode3);
-		_Ret_notnull_ MESHFACE * addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3);
-		_Ret_notnull_ MESHBEAM * addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+		// Merges all instances in order, with the same result as calling mergeMesh for each of them.
+		// Output ranges are assigned up front from the element counts before the merge, then nodes and faces
+		// are copied in parallel. Mesh information is copied afterwards, one range per instance.
+		// The mesh is unchanged, if any instance is invalid.
+		// nThreadCount = 0 uses the number of hardware threads.
+		void mergeMeshes(_In_ const std::vector<MESHMERGEINSTANCE> & Instances, _In_ nfUint32 nThreadCount = 0);
+
+		// Adding nodes or faces may relocate the storage and invalidates previously returned pointers.
+		// The add functions return the index of the new element.
+		nfUint32 addNode(_In_ const NVEC3 vPosition);
+		nfUint32 addNode(_In_ const nfFloat posX, _In_ const nfFloat posY, _In_ const nfFloat posZ);
+		nfUint32 addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3);
+		_Ret_notnull_ MESHBEAM * addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
 			_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
+
+		// Bulk versions of addNode and addFace. pCoordinates holds three coordinates per node and pNodeIndices
+		// three node indices per face. All elements are validated before any of them is added.
+		// Return the index of the first new element.
+		nfUint32 addNodes(_In_ const nfFloat * pCoordinates, _In_ nfUint32 nNodeCount);
+		nfUint32 addFaces(_In_ const nfUint32 * pNodeIndices, _In_ nfUint32 nFaceCount);
+
+		void reserveNodes(_In_ nfUint32 nNodeCount);
+		void reserveFaces(_In_ nfUint32 nFaceCount);
 		_Ret_notnull_ PBEAMSET addBeamSet();
 		
 		nfUint32 getNodeCount();
@@ -86,6 +139,39 @@ namespace NMR {
 		_Ret_notnull_ MESHBEAM * getBeam(_In_ nfUint32 nIdx);
 		_Ret_notnull_ PBEAMSET getBeamSet(_In_ nfUint32 nIdx);
 
+		// Contiguous access to all nodes (getNodeCount() elements) and faces (getFaceCount() elements).
+		_Ret_maybenull_ MESHNODE * getNodes();
+		_Ret_maybenull_ MESHFACE * getFaces();
+		// Same as getNodes and getFaces, for callers which do not modify the nodes or faces.
+		// getReadOnlyNodes returns null for quantized nodes, which are read with getNodePosition instead.
+		_Ret_maybenull_ const MESHNODE * getReadOnlyNodes();
+		_Ret_maybenull_ const MESHFACE * getReadOnlyFaces();
+		_Ret_notnull_ const MESHFACE * getReadOnlyFace(_In_ nfUint32 nIdx);
+
+		// Increased whenever nodes, faces or beams are added, cleared or handed out for modification.
+		// Results derived from the geometry stay valid as long as the count is unchanged.
+		nfUint64 getModificationCount();
+
+		// Read access to a node position, which does not leave quantized storage
+		NVEC3 getNodePosition(_In_ nfUint32 nIdx);
+
+		// Stores the node positions as fixed point values with nDecimalPrecision decimal digits. Coordinates are
+		// truncated the same way the model writer truncates them, so writing with the same decimal precision
+		// gives the same output as before. Each axis is stored relative to the smallest value of the mesh, in
+		// steps of the largest common divisor of the offsets, with as many bits as the extent needs. Nodes take
+		// less than half of the 12 bytes of float storage, if the extent needs no more than 15 bits per axis.
+		// Returns false and keeps the float storage, if an axis needs more than NMR_MESH_QUANTIZATIONMAXBITS bits.
+		// Any access to a mutable node or adding nodes returns the mesh to float storage.
+		nfBool quantizeNodes(_In_ nfUint32 nDecimalPrecision);
+		// Returns quantized nodes to float storage, e.g. for contiguous access with getReadOnlyNodes
+		void dequantizeNodes();
+		nfBool hasQuantizedNodes();
+		nfUint32 getQuantizationPrecision();
+		// Fixed point values of a quantized node, in units of 10^-getQuantizationPrecision()
+		void getQuantizedNode(_In_ nfUint32 nIdx, _Out_ nfInt64 * pValues);
+		MESHBEAMS & getBeams();
+		const MESHBEAMS & getReadOnlyBeams();
+
 		void setBeamLatticeMinLength(nfDouble dMinLength);
 		nfDouble getBeamLatticeMinLength();
 
@@ -106,7 +192,25 @@ namespace NMR {
 		_Ret_notnull_ CMeshInformationHandler * createMeshInformationHandler();
 		void clearMeshInformationHandler();
 		void patchMeshInformationResources(_In_ std::map<PackageResourceID, PackageResourceID> &oldToNewMapping);
+		// Bounding box of all nodes in mesh coordinates. Invalid (see fnOutboxIsValid), if the mesh has no nodes.
+		NOUTBOX3 getOutbox();
+		// Merges the transformed nodes into vOutBox. Uses the cached bounding box for the identity and for
+		// transforms that map axes onto axes, which give the same result as transforming every node.
 		void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix);
+
+		// Beams and mesh information allocated afterwards are placed in the arena, which is
+		// released as a whole. Nodes and faces stay in their contiguous arrays.
+		void setMemoryArena(_In_opt_ PMemoryArena pMemoryArena);
+		PMemoryArena getMemoryArena();
+
+		// Bytes held by nodes, faces, beams, beam sets and mesh information.
+		// Shared node and face arrays are counted by every mesh which holds them.
+		nfUint64 getMemoryUsage();
+		// Same as getMemoryUsage, but skips the node and face arrays listed in CountedBuffers and adds the
+		// others to it. Summing up several meshes with the same set counts each shared array once.
+		nfUint64 getMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers);
+		// True, if the node or face array is shared with a copy of the mesh
+		nfBool isSharingGeometry();
 	};
 
 	typedef std::shared_ptr <CMesh> PMesh;
@@ -0,0 +1,102 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshDuplicateFinder.h defines the class CMeshDuplicateFinder.
+
+The class CMeshDuplicateFinder collects meshes and reports for every added mesh,
+whether it equals a previously added one. Meshes are bucketed by a hash of their
+faces, per-face properties and either their node positions or, if rigid transforms
+are allowed, a rotation and translation invariant of their nodes. Candidates in the
+same bucket are compared element by element, so hash collisions never produce a
+false match.
+
+--*/
+
+#ifndef __NMR_MESHDUPLICATEFINDER
+#define __NMR_MESHDUPLICATEFINDER
+
+#include "Common/Mesh/NMR_Mesh.h" 
+#include "Common/Math/NMR_Matrix.h" 
+#include <vector>
+#include <unordered_map>
+
+// Largest node deviation of a rigid match, relative to the extent of the mesh
+#define NMR_MESHDUPLICATEFINDER_RELATIVETOLERANCE 1.0E-5
+// Relative step in which the size invariant of rigid matching is bucketed
+#define NMR_MESHDUPLICATEFINDER_SIZESTEP 1.0E-3
+
+namespace NMR {
+
+	typedef struct {
+		CMesh * m_pMesh;
+		nfUint64 m_nCategory;
+		nfDouble m_dCentroid[3];
+		// Largest distance of a node to the centroid
+		nfDouble m_dRadius;
+		// Nodes which span the reference frame of rigid matching
+		nfUint32 m_nFrameNode1;
+		nfUint32 m_nFrameNode2;
+		nfBool m_bHasFrame;
+	} MESHDUPLICATEENTRY;
+
+	class CMeshDuplicateFinder {
+	private:
+		nfBool m_bRigidTransforms;
+		std::vector<MESHDUPLICATEENTRY> m_Entries;
+		std::unordered_multimap<nfUint64, nfUint32> m_Buckets;
+
+		nfUint64 calculateKey(_In_ MESHDUPLICATEENTRY & Entry);
+		void calculateFrameNodes(_In_ MESHDUPLICATEENTRY & Entry);
+
+		nfBool hasEqualTopology(_In_ CMesh * pMesh1, _In_ CMesh * pMesh2);
+		nfBool hasEqualNodes(_In_ CMesh * pMesh1, _In_ CMesh * pMesh2);
+		nfBool findRigidTransform(_In_ MESHDUPLICATEENTRY & Entry1, _In_ MESHDUPLICATEENTRY & Entry2, _Out_ NMATRIX3 & mMatrix);
+		// Rounds mMatrix to its written form and checks that it maps the nodes of Entry1 onto those of Entry2
+		nfBool verifyTransform(_In_ MESHDUPLICATEENTRY & Entry1, _In_ MESHDUPLICATEENTRY & Entry2, _Inout_ NMATRIX3 & mMatrix);
+
+	public:
+		// If bRigidTransforms is set, meshes also match if their nodes are a rotated and translated
+		// copy of the nodes of another mesh, within NMR_MESHDUPLICATEFINDER_RELATIVETOLERANCE.
+		CMeshDuplicateFinder(_In_ nfBool bRigidTransforms);
+
+		// Returns true, if pMesh equals a previously added mesh of the same category. nIndex is the index of
+		// that mesh and mMatrix maps its nodes onto the nodes of pMesh. Transforms are verified after rounding
+		// them the way they are written (see fnMATRIX3_toString).
+		// Otherwise pMesh is added, nIndex is its new index and false is returned.
+		// Added meshes are referenced, not copied, and must not change while the finder is in use.
+		nfBool addMesh(_In_ CMesh * pMesh, _In_ nfUint64 nCategory, _Out_ nfUint32 & nIndex, _Out_ NMATRIX3 & mMatrix);
+
+		nfUint32 getMeshCount();
+		_Ret_notnull_ CMesh * getMesh(_In_ nfUint32 nIndex);
+	};
+
+	typedef std::shared_ptr <CMeshDuplicateFinder> PMeshDuplicateFinder;
+
+}
+
+#endif // __NMR_MESHDUPLICATEFINDER
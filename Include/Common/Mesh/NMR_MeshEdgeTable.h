@@ -0,0 +1,92 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshEdgeTable.h defines the class CMeshEdgeTable.
+
+The class CMeshEdgeTable holds the edge topology of a mesh: every edge is identified by
+its pair of nodes, and the table stores the edges of every face as well as the faces
+adjacent to every edge, including whether they use the edge in ascending or descending
+node order. The table is built by sorting packed 64 bit edge keys, in parallel for
+large meshes, and is a snapshot: it is not updated when the mesh changes.
+
+--*/
+
+#ifndef __NMR_MESHEDGETABLE
+#define __NMR_MESHEDGETABLE
+
+#include "Common/Mesh/NMR_Mesh.h" 
+#include <vector>
+
+#define NMR_MESHEDGETABLE_MINFACESPERTHREAD 65536
+
+namespace NMR {
+
+	class CMeshEdgeTable {
+	private:
+		// Edge of each face corner, i.e. the edge from node j to node j + 1 of face i is m_FaceEdges[3 * i + j]
+		std::vector<nfUint32> m_FaceEdges;
+		// Face corners of all edges, grouped by edge. The corners of edge e are
+		// m_EdgeCorners[m_EdgeStarts[e]] to m_EdgeCorners[m_EdgeStarts[e + 1] - 1]
+		std::vector<nfUint32> m_EdgeCorners;
+		std::vector<nfUint32> m_EdgeStarts;
+		// Nodes of each edge in ascending order
+		std::vector<nfUint64> m_EdgeKeys;
+		// Number of corners using the edge in ascending and in descending node order
+		std::vector<nfUint32> m_AscendingCounts;
+		std::vector<nfUint32> m_DescendingCounts;
+
+		void buildEdges(_In_ CMesh * pMesh, _In_ nfUint32 nThreadCount);
+	public:
+		CMeshEdgeTable() = delete;
+		// nThreadCount = 0 uses the number of hardware threads. The faces of pMesh must reference valid,
+		// pairwise different nodes (see CMesh::checkSanity).
+		CMeshEdgeTable(_In_ CMesh * pMesh, _In_ nfUint32 nThreadCount = 0);
+
+		nfUint32 getEdgeCount();
+		void getEdgeNodes(_In_ nfUint32 nEdgeIndex, _Out_ nfUint32 & nNodeIndex1, _Out_ nfUint32 & nNodeIndex2);
+		// Edge from node nCorner to node nCorner + 1 of a face
+		nfUint32 getFaceEdge(_In_ nfUint32 nFaceIndex, _In_ nfUint32 nCorner);
+
+		// Faces adjacent to an edge. A face is listed once for every corner that uses the edge.
+		nfUint32 getEdgeFaceCount(_In_ nfUint32 nEdgeIndex);
+		nfUint32 getEdgeFace(_In_ nfUint32 nEdgeIndex, _In_ nfUint32 nIndex);
+		nfUint32 getAscendingCount(_In_ nfUint32 nEdgeIndex);
+		nfUint32 getDescendingCount(_In_ nfUint32 nEdgeIndex);
+
+		// True, if every edge is shared by exactly two faces which use it in opposite directions
+		nfBool isManifoldAndOriented();
+
+		// Bytes held by the tables
+		nfUint64 getMemoryUsage();
+	};
+
+	typedef std::shared_ptr <CMeshEdgeTable> PMeshEdgeTable;
+
+}
+
+#endif // __NMR_MESHEDGETABLE
@@ -40,6 +40,7 @@ In addition, some constants are defined here.
 #include "Common/Math/NMR_Geometry.h" 
 #include "Common/NMR_PagedVector.h"
 #include <string>
+#include <vector>
 
 // The maximum allowed number of certain entities (2^31-1)
 #define NMR_MESH_MAXNODECOUNT 2147483647
@@ -49,25 +50,52 @@ In addition, some constants are defined here.
 
 #define NMR_MESH_MAXCOORDINATE 1000000000.0f
 
-#define NMR_MESH_NODEBLOCKCOUNT 256
+// Quantized node storage: each axis takes as many bits as its extent needs in steps of the mesh,
+// up to 32 bits, and the axes of all nodes are packed into one bit stream. At the default writer
+// precision of 6 decimal digits, a 100 unit extent takes 27 bits per axis; at 3 digits it takes 17 bits.
+#define NMR_MESH_QUANTIZATIONMAXBITS 32
+#define NMR_MESH_QUANTIZATIONMAXPRECISION 9
+
 #define NMR_MESH_EDGEBLOCKCOUNT 256
-#define NMR_MESH_FACEBLOCKCOUNT 256
 #define NMR_MESH_BEAMBLOCKCOUNT 256
 #define NMR_MESH_NODEEDGELINKBLOCKCOUNT 256
 
+// Merging meshes uses one thread per this many nodes or faces
+#define NMR_MESH_MINMERGEELEMENTSPERTHREAD 65536
+
+// Node positions are transformed in blocks of this size to extend a bounding box
+#define NMR_MESH_OUTBOXTRANSFORMBLOCKSIZE 256
+
 namespace NMR {
 
+	// Nodes and faces are stored contiguously and are identified by their position in the
+	// storage. Hence, all node positions of a mesh form one float array with three
+	// coordinates per node, and all faces form one index array with three indices per face.
 	typedef struct {
-		nfInt32 m_index;
 		NVEC3 m_position;
 	} MESHNODE;
-	typedef CPagedVector<MESHNODE, NMR_MESH_NODEBLOCKCOUNT> MESHNODES;
+	typedef std::vector<MESHNODE> MESHNODES;
+	static_assert(sizeof(MESHNODE) == sizeof(NVEC3), "MESHNODE arrays must be usable as NVEC3 arrays");
+
+	// Fixed point encoding of quantized nodes. Axis j of a node is stored as an unsigned m_nBits[j] bit
+	// value q, which stands for m_nOrigin[j] + q * m_nStep[j] in units of 10^-m_nPrecision.
+	typedef struct {
+		nfInt64 m_nOrigin[3];
+		nfInt64 m_nStep[3];
+		nfUint32 m_nBits[3];
+		nfUint32 m_nNodeBits;
+		nfUint32 m_nNodeCount;
+		nfUint32 m_nPrecision;
+		nfInt32 m_nFactor;
+	} MESHNODEQUANTIZATION;
 
 	typedef struct {
-		nfInt32 m_index;
 		nfInt32 m_nodeindices[3];
 	} MESHFACE;
-	typedef CPagedVector<MESHFACE, NMR_MESH_FACEBLOCKCOUNT> MESHFACES;
+	typedef std::vector<MESHFACE> MESHFACES;
+
+	static_assert(sizeof(MESHNODE) == 3 * sizeof(nfFloat), "MESHNODE must be tightly packed");
+	static_assert(sizeof(MESHFACE) == 3 * sizeof(nfInt32), "MESHFACE must be tightly packed");
 
 	typedef struct BEAMSET {
 		std::vector<nfUint32> m_Refs;
@@ -0,0 +1,81 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshVertexCacheOptimizer.h defines the class CMeshVertexCacheOptimizer.
+
+The class CMeshVertexCacheOptimizer computes an output order of a mesh, which
+improves the locality of the vertex indices: Faces are reordered for a
+post-transform vertex cache (Forsyth's linear-speed algorithm) and nodes are
+renumbered in order of their first use. The mesh itself is not modified.
+
+--*/
+
+#ifndef __NMR_MESHVERTEXCACHEOPTIMIZER
+#define __NMR_MESHVERTEXCACHEOPTIMIZER
+
+#include "Common/Mesh/NMR_Mesh.h" 
+#include <vector>
+
+#define NMR_VERTEXCACHE_SIZE 32
+#define NMR_VERTEXCACHE_MAXVALENCESCORE 64
+#define NMR_VERTEXCACHE_UNASSIGNED 0xFFFFFFFF
+
+namespace NMR {
+
+	class CMeshVertexCacheOptimizer {
+	private:
+		std::vector<nfUint32> m_FaceOrder;
+		std::vector<nfUint32> m_NodeOrder;
+		std::vector<nfUint32> m_NodeMap;
+
+		nfFloat m_CachePositionScores[NMR_VERTEXCACHE_SIZE];
+		nfFloat m_ValenceScores[NMR_VERTEXCACHE_MAXVALENCESCORE];
+
+		nfFloat calculateVertexScore(_In_ nfInt32 nCachePosition, _In_ nfUint32 nRemainingValence);
+		void orderFaces(_In_ CMesh * pMesh);
+		void orderNodes(_In_ CMesh * pMesh);
+	public:
+		CMeshVertexCacheOptimizer() = delete;
+		CMeshVertexCacheOptimizer(_In_ CMesh * pMesh);
+
+		// Original index of the face that is written at position nIndex
+		nfUint32 getFaceIndex(_In_ nfUint32 nIndex);
+		// Original index of the node that is written at position nIndex
+		nfUint32 getNodeIndex(_In_ nfUint32 nIndex);
+		// Output position of the node with original index nNodeIndex
+		nfUint32 mapNodeIndex(_In_ nfUint32 nNodeIndex);
+
+		// Bytes held by the output order tables
+		nfUint64 getMemoryUsage();
+	};
+
+	typedef std::shared_ptr <CMeshVertexCacheOptimizer> PMeshVertexCacheOptimizer;
+
+}
+
+#endif // __NMR_MESHVERTEXCACHEOPTIMIZER
@@ -42,6 +42,9 @@ This is a derived class for Importing the binary STL and color STL Mesh Format.
 
 #include <vector>
 
+// Number of facets which are read and transformed at once
+#define NMR_STL_IMPORTCHUNKSIZE 4096
+
 namespace NMR {
 
 #pragma pack (1)
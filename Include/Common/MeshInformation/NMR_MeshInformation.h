@@ -51,20 +51,33 @@ namespace NMR {
 		PMeshInformationContainer m_pContainer;
 		nfUint64 m_nInternalID;
 
+		// Record of a freshly added or reset face, filled by invalidateFace on first use
+		std::vector<MESHINFORMATIONFACEDATA> m_InvalidRecord;
+		_Ret_notnull_ const MESHINFORMATIONFACEDATA * getInvalidRecord();
+
 	public:
 		CMeshInformation();
 		virtual ~CMeshInformation() = default;
 
+		// getFaceData returns a writable record and expands compressed storage to one record per face.
+		// Use readFaceData and setFaceData to keep uniform or run-length data compressed.
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * getFaceData(nfUint32 nFaceIndex);
-		_Ret_notnull_ MESHINFORMATIONFACEDATA * addFaceData(_In_ nfUint32 nNewFaceCount);
+		_Ret_notnull_ const MESHINFORMATIONFACEDATA * readFaceData(nfUint32 nFaceIndex);
+		void setFaceData(nfUint32 nFaceIndex, _In_ const MESHINFORMATIONFACEDATA * pData);
+		void readFaceDataRange(nfUint32 nStartIndex, nfUint32 nCount, _Out_ MESHINFORMATIONFACEDATA * pBuffer);
+		void setFaceDataRange(nfUint32 nStartIndex, nfUint32 nCount, _In_ const MESHINFORMATIONFACEDATA * pBuffer);
+		void addFaceData(_In_ nfUint32 nNewFaceCount);
 		void resetFaceInformation(_In_ nfUint32 nFaceIndex);
 		void resetAllFaceInformation();
+		nfUint64 getMemoryUsage();
 
 		virtual void invalidateFace(_In_ MESHINFORMATIONFACEDATA * pData) = 0;
 
 		virtual eMeshInformationType getType() = 0;
 		virtual void cloneDefaultInfosFrom(_In_ CMeshInformation * pOtherInformation) = 0;
 		virtual void cloneFaceInfosFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex) = 0;
+		// Same as cloneFaceInfosFrom for nCount consecutive faces
+		virtual void cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount);
 		virtual PMeshInformation cloneInstance(_In_ nfUint32 nCurrentFaceCount) = 0;
 		virtual void permuteNodeInformation(_In_ nfUint32 nFaceIndex, _In_ nfUint32 nNodeIndex1, _In_ nfUint32 nNodeIndex2, _In_ nfUint32 nNodeIndex3) = 0;
 		virtual void mergeInformationFrom (_In_ CMeshInformation * pInformation) = 0;
@@ -37,29 +37,84 @@ This class provides a memory container for holding the texture information state
 #include "Common/MeshInformation/NMR_MeshInformationTypes.h"
 #include "Common/NMR_Types.h"
 #include "Common/NMR_Local.h"
+#include "Common/NMR_MemoryArena.h"
 
 #include <vector>
 #include <memory>
+#include <atomic>
 
 #define MESHINFORMATIONCOUNTER_BUFFERSIZE 256
 
+// Run-length storage is replaced by the dense table as soon as it holds more than
+// MESHINFORMATION_MINRUNCOUNT runs and less than MESHINFORMATION_RUNDENSITY faces per run.
+#define MESHINFORMATION_MINRUNCOUNT 64
+#define MESHINFORMATION_RUNDENSITY 4
+
+// Writes shift or re-encode all runs after the written face. A write which would move more than
+// MESHINFORMATION_MAXSHIFTEDRUNS runs converts to the dense table instead, which bounds its cost.
+#define MESHINFORMATION_MAXSHIFTEDRUNS 1024
+
 namespace NMR {
 
 	class CMeshInformationContainer {
 	private:
 		nfUint32 m_nFaceCount;
 		nfUint32 m_nRecordSize;
+
+		// Dense storage: one record per face
+		nfBool m_bIsDense;
 		std::vector<MESHINFORMATIONFACEDATA *> m_DataBlocks;
 		MESHINFORMATIONFACEDATA * m_CurrentDataBlock;
+		PMemoryArena m_pMemoryArena;
+
+		// Run-length storage: run i covers the faces from m_RunStarts[i] up to the start of run i + 1
+		// and stores one record for all of them in m_RunRecords.
+		std::vector<nfUint32> m_RunStarts;
+		std::vector<MESHINFORMATIONFACEDATA> m_RunRecords;
+		// Run of the last lookup. It is only a hint, so concurrent readers may overwrite it.
+		std::atomic<nfUint32> m_nLastRun;
+
+		nfUint32 findRun(_In_ nfUint32 nIdx);
+		nfUint32 getRunEnd(_In_ nfUint32 nRun);
+		_Ret_notnull_ MESHINFORMATIONFACEDATA * getRunRecord(_In_ nfUint32 nRun);
+		nfBool runHasRecord(_In_ nfUint32 nRun, _In_ const MESHINFORMATIONFACEDATA * pData);
+		void insertRun(_In_ nfUint32 nRun, _In_ nfUint32 nStart, _In_ const MESHINFORMATIONFACEDATA * pData);
+		void appendRun(_In_ nfUint32 nStart, _In_ const MESHINFORMATIONFACEDATA * pData);
+		void eraseRun(_In_ nfUint32 nRun);
+		void mergeRunWithNeighbours(_In_ nfUint32 nRun);
+
+		_Ret_notnull_ MESHINFORMATIONFACEDATA * allocateDataBlock();
+		void releaseDataBlocks();
+		void makeDense();
+		void checkRunDensity();
+		nfBool exceedsShiftedRuns(_In_ nfUint32 nRun);
+		void checkFaceRange(_In_ nfUint32 nStartIdx, _In_ nfUint32 nCount);
 
 	public:
 		CMeshInformationContainer();
-		CMeshInformationContainer(nfUint32 nCurrentFaceCount, nfUint32 nRecordSize);
+		CMeshInformationContainer(nfUint32 nCurrentFaceCount, nfUint32 nRecordSize, _In_opt_ PMemoryArena pMemoryArena = nullptr);
 		~CMeshInformationContainer();
-		_Ret_notnull_ MESHINFORMATIONFACEDATA * addFaceData(nfUint32 nNewFaceCount);
+
+		// Appends a face with a copy of pData (or zeros, if pData is null)
+		void addFaceData(nfUint32 nNewFaceCount, _In_opt_ const MESHINFORMATIONFACEDATA * pData = nullptr);
+
+		// Returns a writable record. Run-length storage is converted to the dense table first.
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * getFaceData(nfUint32 nIdx);
 
+		// Read and write access that keeps the compressed representation
+		_Ret_notnull_ const MESHINFORMATIONFACEDATA * readFaceData(nfUint32 nIdx);
+		void setFaceData(nfUint32 nIdx, _In_ const MESHINFORMATIONFACEDATA * pData);
+		void setAllFaceData(_In_ const MESHINFORMATIONFACEDATA * pData);
+
+		// Bulk copies of nCount consecutive records from and to a packed buffer
+		void readFaceDataRange(nfUint32 nStartIdx, nfUint32 nCount, _Out_ MESHINFORMATIONFACEDATA * pBuffer);
+		void setFaceDataRange(nfUint32 nStartIdx, nfUint32 nCount, _In_ const MESHINFORMATIONFACEDATA * pBuffer);
+
 		nfUint32 getCurrentFaceCount();
+		nfUint32 getRecordSize();
+		nfBool isDense();
+		PMemoryArena getMemoryArena();
+		nfUint64 getMemoryUsage();
 		void clear();
 	};
 
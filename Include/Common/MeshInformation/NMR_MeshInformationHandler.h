@@ -57,10 +57,12 @@ namespace NMR {
 		PMeshInformation getPInformationIndexed(_In_ nfUint32 nIdx);
 		CMeshInformation * getInformationByType(_In_ nfUint32 nChannel, _In_ eMeshInformationType eType);
 		nfUint32 getInformationCount();
+		nfUint64 getMemoryUsage();
 
 		void addInfoTableFrom(_In_ CMeshInformationHandler * pOtherInfoHandler, _In_ nfUint32 nCurrentFaceCount);
 		void cloneDefaultInfosFrom(_In_ CMeshInformationHandler * pOtherInfoHandler);
 		void cloneFaceInfosFrom(_In_ nfUint32 nFaceIdx, _In_ CMeshInformationHandler * pOtherInfoHandler, _In_ nfUint32 nOtherFaceIndex);
+		void cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIdx, _In_ CMeshInformationHandler * pOtherInfoHandler, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount);
 		void permuteNodeInformation(_In_ nfUint32 nFaceIdx, _In_ nfUint32 nNodeIndex1, _In_ nfUint32 nNodeIndex2, _In_ nfUint32 nNodeIndex3);
 		void resetFaceInformation(_In_ nfUint32 nFaceIdx);
 
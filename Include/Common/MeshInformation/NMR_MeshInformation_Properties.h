@@ -37,12 +37,29 @@ NMR_MeshInformation_Properties.h defines the Property Information Class.
 #include "Model/Classes/NMR_ModelTypes.h"
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace NMR {
 
+	// Property IDs below this limit are mapped with a dense array per resource
+	#define MESHINFORMATION_PROPERTYINDEX_DENSELIMIT 65536
+	#define MESHINFORMATION_PROPERTYINDEX_UNMAPPED 0xFFFFFFFF
+
 	class CMeshInformation_PropertyIndexMapping {
 	private:
-		std::map<std::pair <nfUint32, ModelPropertyID>, nfUint32> m_IDMap;
+		struct sResourceIndexMap {
+			std::vector<nfUint32> m_DenseIndices;
+			std::unordered_map<ModelPropertyID, nfUint32> m_SparseIndices;
+		};
+
+		std::unordered_map<nfUint32, sResourceIndexMap> m_ResourceMaps;
+
+		// Consecutive lookups mostly hit the same resource
+		nfUint32 m_nLastResourceID;
+		sResourceIndexMap * m_pLastResourceMap;
+
+		sResourceIndexMap * findResourceMap(nfUint32 nResourceID);
 	public:
 		CMeshInformation_PropertyIndexMapping();
 
@@ -64,13 +81,14 @@ namespace NMR {
 	protected:
 	public:
 		CMeshInformation_Properties();
-		CMeshInformation_Properties(nfUint32 nCurrentFaceCount);
+		CMeshInformation_Properties(nfUint32 nCurrentFaceCount, _In_opt_ PMemoryArena pMemoryArena = nullptr);
 
 		void invalidateFace(_In_ MESHINFORMATIONFACEDATA * pData) override;
 
 		eMeshInformationType getType() override;
 		void cloneDefaultInfosFrom(_In_ CMeshInformation * pOtherInformation) override;
 		void cloneFaceInfosFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex) override;
+		void cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount) override;
 		PMeshInformation cloneInstance(_In_ nfUint32 nCurrentFaceCount) override;
 		void permuteNodeInformation(_In_ nfUint32 nFaceIndex, _In_ nfUint32 nNodeIndex1, _In_ nfUint32 nNodeIndex2, _In_ nfUint32 nNodeIndex3) override;
 		nfUint32 getBackupSize() override;
@@ -484,6 +484,9 @@ Core framework error codes (0x2XXX)
 // Invalid slice vertex index
 #define NMR_ERROR_INVALIDSLICEVERTEX 0x2041
 
+// A pipe stream has been aborted by its reader or writer
+#define NMR_ERROR_PIPEABORTED 0x2042
+
 /*-------------------------------------------------------------------
 Model error codes (0x8XXX)
 -------------------------------------------------------------------*/
@@ -1103,6 +1106,24 @@ Model error codes (0x8XXX)
 // Version 093 of the core-specification is not fully supported
 #define NMR_ERROR_VERSION093_NOT_SUPPORTED 0x80E7
 
+// A streaming write has not been started
+#define NMR_ERROR_STREAMWRITERNOTACTIVE 0x80E8
+
+// A streaming write is already in progress
+#define NMR_ERROR_STREAMWRITERACTIVE 0x80E9
+
+// Object has already been written to the stream
+#define NMR_ERROR_OBJECTALREADYSTREAMED 0x80EA
+
+// Object references an object that has not been written to the stream yet
+#define NMR_ERROR_REFERENCEDOBJECTNOTSTREAMED 0x80EB
+
+// A write operation of the model writer is still in progress
+#define NMR_ERROR_WRITEINPROGRESS 0x80EC
+
+// Mesh deduplication is not supported by streaming writes
+#define NMR_ERROR_STREAMDEDUPLICATIONNOTSUPPORTED 0x80ED
+
 
 /*-------------------------------------------------------------------
 XML Parser Error Constants (0x9XXX)
@@ -0,0 +1,132 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MemoryArena.h defines a chunked bump allocator, which can be shared by all
+bulk data of a model. Freed blocks are kept for later allocations of the same size,
+large blocks go back to the heap, and all chunks are released at once when the last
+owner of the arena is destroyed.
+
+--*/
+
+#ifndef __NMR_MEMORYARENA
+#define __NMR_MEMORYARENA
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+#define NMR_MEMORYARENA_DEFAULTCHUNKSIZE (1024 * 1024)
+
+namespace NMR {
+
+	class CMemoryArena {
+	private:
+		std::mutex m_Mutex;
+		std::vector<nfByte *> m_Chunks;
+		// Chunks of single large allocations, which are deleted when they are deallocated
+		std::set<nfByte *> m_LargeChunks;
+		// Deallocated blocks by size and alignment, which are handed out again before the current chunk is used
+		std::map<std::pair<size_t, size_t>, std::vector<void *>> m_FreeBlocks;
+		nfByte * m_pCurrent;
+		size_t m_nRemaining;
+		size_t m_nChunkSize;
+		nfUint64 m_nReservedSize;
+		nfUint64 m_nUsedSize;
+
+		_Ret_notnull_ nfByte * allocateChunk(_In_ size_t nSize);
+
+	public:
+		CMemoryArena(_In_ size_t nChunkSize = NMR_MEMORYARENA_DEFAULTCHUNKSIZE);
+		~CMemoryArena();
+
+		CMemoryArena(const CMemoryArena &) = delete;
+		CMemoryArena & operator=(const CMemoryArena &) = delete;
+
+		// Returns uninitialized memory, which stays valid until it is deallocated or the arena is destroyed
+		_Ret_notnull_ void * allocate(_In_ size_t nSize, _In_ size_t nAlignment = alignof(std::max_align_t));
+		// Returns a block for reuse. nSize and nAlignment must be the values it was allocated with.
+		void deallocate(_In_opt_ void * pData, _In_ size_t nSize, _In_ size_t nAlignment = alignof(std::max_align_t));
+
+		nfUint64 getReservedSize();
+		nfUint64 getUsedSize();
+		nfUint32 getChunkCount();
+	};
+
+	typedef std::shared_ptr <CMemoryArena> PMemoryArena;
+
+	// STL allocator on top of an optional arena. Without an arena, the global heap is used.
+	template <class T>
+	class CArenaAllocator {
+	public:
+		typedef T value_type;
+
+		PMemoryArena m_pMemoryArena;
+
+		CArenaAllocator() {
+		}
+
+		CArenaAllocator(_In_ PMemoryArena pMemoryArena) : m_pMemoryArena(pMemoryArena) {
+		}
+
+		template <class U>
+		CArenaAllocator(_In_ const CArenaAllocator<U> & Other) : m_pMemoryArena(Other.m_pMemoryArena) {
+		}
+
+		T * allocate(_In_ size_t nCount) {
+			if (m_pMemoryArena)
+				return static_cast<T *>(m_pMemoryArena->allocate(nCount * sizeof(T), alignof(T)));
+			return static_cast<T *>(::operator new(nCount * sizeof(T)));
+		}
+
+		void deallocate(_In_ T * pData, _In_ size_t nCount) {
+			if (m_pMemoryArena)
+				m_pMemoryArena->deallocate(pData, nCount * sizeof(T), alignof(T));
+			else
+				::operator delete(pData);
+		}
+
+		template <class U>
+		bool operator==(_In_ const CArenaAllocator<U> & Other) const {
+			return m_pMemoryArena == Other.m_pMemoryArena;
+		}
+
+		template <class U>
+		bool operator!=(_In_ const CArenaAllocator<U> & Other) const {
+			return m_pMemoryArena != Other.m_pMemoryArena;
+		}
+	};
+
+}
+
+#endif // __NMR_MEMORYARENA
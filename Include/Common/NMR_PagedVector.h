@@ -28,6 +28,9 @@ Abstract:
 
 NMR_PagedVector.h defines a vector class which allocates its memory block-wise, leading to 
 significant performance improvements against a standard template library vector.
+The block size is a compile-time power of two, so elements are addressed by shift and mask.
+Sequential access should use the block-wise iterators or forEachBlock, which avoid the
+per-element index computation and bounds check of getData.
 
 --*/
 
@@ -37,50 +40,117 @@ significant performance improvements against a standard template library vector.
 #include "Common/NMR_Local.h"
 #include "Common/NMR_Types.h"
 #include "Common/NMR_Exception.h"
+#include "Common/NMR_MemoryArena.h"
 #include <vector>
-
 #include <array>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <new>
 
 namespace NMR {
 
-	template <class T, unsigned int DEFAULTBLOCKSIZE = 1024>
+	constexpr nfUint32 fnPagedVectorBlockShift(nfUint32 nBlockSize) {
+		return (nBlockSize <= 1) ? 0 : 1 + fnPagedVectorBlockShift(nBlockSize >> 1);
+	}
+
+	template <class T, unsigned int BLOCKSIZE = 1024>
 	class CPagedVector {
-		nfUint32 m_nBlockSize;
+		static_assert((BLOCKSIZE > 0) && ((BLOCKSIZE & (BLOCKSIZE - 1)) == 0), "CPagedVector block size must be a power of two");
+
+		static const nfUint32 BLOCKMASK = BLOCKSIZE - 1;
+		static const nfUint32 BLOCKSHIFT = fnPagedVectorBlockShift(BLOCKSIZE);
+
 		nfUint32 m_nCount;
 		T * m_pHeadBlock;
 		std::vector<T *> m_pBlocks;
+		PMemoryArena m_pMemoryArena;
+
 	public:
 
+		// Forward iterator, which only changes blocks at block boundaries
+		template <class V, class E>
+		class CIterator {
+			V * m_pVector;
+			nfUint32 m_nIndex;
+			E * m_pCurrent;
+			E * m_pBlockEnd;
+
+			void enterBlock() {
+				if (m_nIndex < m_pVector->m_nCount) {
+					m_pCurrent = m_pVector->m_pBlocks[m_nIndex >> BLOCKSHIFT] + (m_nIndex & BLOCKMASK);
+					m_pBlockEnd = m_pCurrent + (BLOCKSIZE - (m_nIndex & BLOCKMASK));
+				}
+				else {
+					m_pCurrent = nullptr;
+					m_pBlockEnd = nullptr;
+				}
+			}
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef E value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef E * pointer;
+			typedef E & reference;
+
+			CIterator(_In_ V * pVector, _In_ nfUint32 nIndex) : m_pVector(pVector), m_nIndex(nIndex) {
+				enterBlock();
+			}
+
+			E & operator*() const { return *m_pCurrent; }
+			E * operator->() const { return m_pCurrent; }
+			nfUint32 getIndex() const { return m_nIndex; }
+
+			CIterator & operator++() {
+				m_nIndex++;
+				m_pCurrent++;
+				if (m_pCurrent == m_pBlockEnd)
+					enterBlock();
+				return *this;
+			}
+
+			CIterator operator++(int) {
+				CIterator Result(*this);
+				++(*this);
+				return Result;
+			}
+
+			bool operator==(const CIterator & Other) const { return m_nIndex == Other.m_nIndex; }
+			bool operator!=(const CIterator & Other) const { return m_nIndex != Other.m_nIndex; }
+		};
+
+		typedef CIterator<CPagedVector, T> iterator;
+		typedef CIterator<const CPagedVector, const T> const_iterator;
+
 		CPagedVector() {
 			m_nCount = 0;
 			m_pHeadBlock = NULL;
-			m_nBlockSize = DEFAULTBLOCKSIZE;
-			if (m_nBlockSize == 0)
-				throw CNMRException(NMR_ERROR_INVALIDBLOCKSIZE);
 		}
 
-		CPagedVector(_In_ nfUint32 nBlockSize) {
-			m_nCount = 0;
-			m_pHeadBlock = NULL;
-			m_nBlockSize = nBlockSize;
-			if (m_nBlockSize == 0)
-				throw CNMRException(NMR_ERROR_INVALIDBLOCKSIZE);
-		}
+		CPagedVector(const CPagedVector &) = delete;
+		CPagedVector & operator=(const CPagedVector &) = delete;
 
 		~CPagedVector() {
 			clearAllData();
 		}
 
-		nfUint32 getCount() {
+		nfUint32 getCount() const {
 			return m_nCount;
 		}
 
 		_Ret_notnull_ T * allocData() {
-			nfUint32 nIdx = (m_nCount % m_nBlockSize);
+			nfUint32 nIdx = (m_nCount & BLOCKMASK);
 
 			// Allocate new node block if necessary
 			if (nIdx == 0) {
-				m_pHeadBlock = new T[m_nBlockSize];
+				if (m_pMemoryArena) {
+					m_pHeadBlock = static_cast<T *>(m_pMemoryArena->allocate(sizeof(T) * BLOCKSIZE, alignof(T)));
+					for (nfUint32 j = 0; j < BLOCKSIZE; j++)
+						new (&m_pHeadBlock[j]) T;
+				}
+				else {
+					m_pHeadBlock = new T[BLOCKSIZE];
+				}
 				m_pBlocks.push_back(m_pHeadBlock);
 			}
 
@@ -96,41 +166,68 @@ namespace NMR {
 		}
 
 		T& allocDataRef(_Out_ nfUint32& nNewIndex) {
-			nfUint32 nIdx = (m_nCount % m_nBlockSize);
-
-			// Allocate new node block if necessary
-			if (nIdx == 0) {
-				m_pHeadBlock = new T[m_nBlockSize];
-				m_pBlocks.push_back(m_pHeadBlock);
-			}
-
 			nNewIndex = m_nCount;
-			m_nCount++;
-
-			return m_pHeadBlock[nIdx];
+			return *allocData();
 		}
 
 		_Ret_notnull_ T * getData(_In_ nfUint32 nIdx) {
 			if (nIdx >= m_nCount)
 				throw CNMRException(NMR_ERROR_INVALIDINDEX);
 
-			T * block = m_pBlocks[nIdx / m_nBlockSize];
-			return &block[nIdx % m_nBlockSize];
+			return &m_pBlocks[nIdx >> BLOCKSHIFT][nIdx & BLOCKMASK];
 		}
 
 		T& getDataRef(_In_ nfUint32 nIdx) {
-			if (nIdx >= m_nCount)
-				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+			return *getData(nIdx);
+		}
 
-			T* block = m_pBlocks[nIdx / m_nBlockSize];
-			return block[nIdx % m_nBlockSize];
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, m_nCount); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, m_nCount); }
+
+		// Calls Visitor(T * pData, nfUint32 nCount, nfUint32 nStartIndex) for each block with its used elements
+		template <typename F>
+		void forEachBlock(F Visitor) {
+			nfUint32 nStartIndex = 0;
+			for (auto iIterator = m_pBlocks.begin(); iIterator != m_pBlocks.end(); iIterator++) {
+				nfUint32 nCount = std::min(m_nCount - nStartIndex, (nfUint32)BLOCKSIZE);
+				Visitor(*iIterator, nCount, nStartIndex);
+				nStartIndex += nCount;
+			}
+		}
+
+		template <typename F>
+		void forEachBlock(F Visitor) const {
+			nfUint32 nStartIndex = 0;
+			for (auto iIterator = m_pBlocks.begin(); iIterator != m_pBlocks.end(); iIterator++) {
+				nfUint32 nCount = std::min(m_nCount - nStartIndex, (nfUint32)BLOCKSIZE);
+				Visitor((const T *)*iIterator, nCount, nStartIndex);
+				nStartIndex += nCount;
+			}
+		}
+
+		// Blocks allocated afterwards are taken from the arena and are returned to it when they are cleared.
+		// May only be called while no block is allocated.
+		void setMemoryArena(_In_ PMemoryArena pMemoryArena) {
+			static_assert(std::is_trivially_destructible<T>::value, "CPagedVector can only place trivially destructible types in a memory arena");
+			if (!m_pBlocks.empty())
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
+			m_pMemoryArena = pMemoryArena;
+		}
+
+		PMemoryArena getMemoryArena() const {
+			return m_pMemoryArena;
 		}
 
 		void clearAllData() {
 			for (auto iIterator = m_pBlocks.begin(); iIterator != m_pBlocks.end(); iIterator++)
 			{
 				T * pBlock = *iIterator;
-				delete[] pBlock;
+				if (m_pMemoryArena)
+					m_pMemoryArena->deallocate(pBlock, sizeof(T) * BLOCKSIZE, alignof(T));
+				else
+					delete[] pBlock;
 			}
 
 			m_pBlocks.clear();
@@ -138,8 +235,13 @@ namespace NMR {
 			m_pHeadBlock = NULL;
 		}
 
-		nfUint32 getBlockSize() {
-			return m_nBlockSize;
+		nfUint32 getBlockSize() const {
+			return BLOCKSIZE;
+		}
+
+		// Bytes held by the allocated blocks and the block table
+		nfUint64 getMemoryUsage() const {
+			return (nfUint64)m_pBlocks.size() * BLOCKSIZE * sizeof(T) + (nfUint64)m_pBlocks.capacity() * sizeof(T *);
 		}
 	};
 
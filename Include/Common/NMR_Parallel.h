@@ -0,0 +1,85 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_Parallel.h defines a helper which splits an index range into consecutive
+chunks and processes them on separate threads.
+
+--*/
+
+#ifndef __NMR_PARALLEL
+#define __NMR_PARALLEL
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace NMR {
+
+	// Number of threads to use for nCount elements, if each thread should process at least nMinCountPerThread
+	// of them. nThreadCount == 0 selects the number of hardware threads.
+	inline nfUint32 fnParallel_ThreadCount(_In_ nfUint32 nThreadCount, _In_ size_t nCount, _In_ size_t nMinCountPerThread)
+	{
+		if (nThreadCount == 0)
+			nThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		size_t nMaxThreadCount = std::max(nCount / std::max(nMinCountPerThread, (size_t)1), (size_t)1);
+		return (nfUint32)std::min((size_t)nThreadCount, nMaxThreadCount);
+	}
+
+	// Calls fnWork(nThread, nBegin, nEnd) for nThreadCount consecutive ranges of [0, nCount).
+	// The calling thread processes the first range. fnWork must not throw. If a thread cannot be started,
+	// the threads started before are joined and the exception is passed on.
+	template <typename F> void fnParallel_Run(_In_ nfUint32 nThreadCount, _In_ size_t nCount, _In_ F fnWork)
+	{
+		if (nThreadCount <= 1) {
+			fnWork(0, (size_t)0, nCount);
+			return;
+		}
+
+		// Reserved up front, so that only starting a thread can throw
+		std::vector<std::thread> Threads;
+		Threads.reserve(nThreadCount - 1);
+		try {
+			for (nfUint32 nThread = 1; nThread < nThreadCount; nThread++)
+				Threads.emplace_back(fnWork, nThread, nCount * nThread / nThreadCount, nCount * (nThread + 1) / nThreadCount);
+		}
+		catch (...) {
+			// Threads started so far still work on the caller's data
+			for (auto & Thread : Threads)
+				Thread.join();
+			throw;
+		}
+		fnWork(0, (size_t)0, nCount / nThreadCount);
+		for (auto & Thread : Threads)
+			Thread.join();
+	}
+
+}
+
+#endif // __NMR_PARALLEL
@@ -60,6 +60,9 @@ namespace NMR
 		CUUID(const std::string & string);
 		std::string toString() const;
 
+		// Returns a UUID which only depends on this UUID and sName, for elements that are generated from this one
+		CUUID derive(_In_ const std::string & sName) const;
+
 		bool set(const nfChar* pString);
 
 		CUUID& operator=(const CUUID& uuid);
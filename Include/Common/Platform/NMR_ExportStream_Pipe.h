@@ -0,0 +1,112 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ExportStream_Pipe.h defines a bounded, thread-safe ExportStream that hands
+the written data over to a consumer thread in chunks. CExportStreamPump is such
+a consumer, which copies the data of a pipe into another ExportStream.
+
+--*/
+
+#ifndef _NMR_EXPORT_STREAM_PIPE
+#define _NMR_EXPORT_STREAM_PIPE
+
+#include "Common/Platform/NMR_ExportStream.h"
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define NMR_EXPORTSTREAM_PIPE_CHUNKSIZE (256 * 1024)
+#define NMR_EXPORTSTREAM_PIPE_MAXCHUNKS 16
+
+namespace NMR {
+
+	class CExportStream_Pipe : public CExportStream {
+	private:
+		std::mutex m_Mutex;
+		std::condition_variable m_ChunkAvailable;
+		std::condition_variable m_SpaceAvailable;
+
+		std::deque<std::vector<nfByte>> m_Chunks;
+		std::vector<nfByte> m_CurrentChunk;
+		nfUint32 m_nChunkSize;
+		nfUint32 m_nMaxChunks;
+		nfUint64 m_nPosition;
+		nfBool m_bClosed;
+		nfBool m_bAborted;
+
+		void pushCurrentChunk();
+
+	public:
+		CExportStream_Pipe() = delete;
+		CExportStream_Pipe(_In_ nfUint32 nChunkSize, _In_ nfUint32 nMaxChunks);
+
+		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfBool seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed);
+		virtual nfUint64 getPosition();
+		virtual nfUint64 writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite);
+		virtual nfBool isSeekable();
+
+		// Hands over the last partial chunk and signals the end of the data
+		void close();
+		// Releases all waiting threads, subsequent reads and writes fail
+		void abort();
+
+		// Blocks until a chunk is available. Returns false at the end of the data.
+		nfBool readChunk(_Out_ std::vector<nfByte> & Chunk);
+	};
+
+	typedef std::shared_ptr <CExportStream_Pipe> PExportStream_Pipe;
+
+	class CExportStreamPump {
+	private:
+		PExportStream_Pipe m_pSource;
+		PExportStream m_pTarget;
+		std::thread m_Thread;
+		std::exception_ptr m_pException;
+
+		void run();
+
+	public:
+		CExportStreamPump() = delete;
+		CExportStreamPump(_In_ PExportStream_Pipe pSource, _In_ PExportStream pTarget);
+		~CExportStreamPump();
+
+		// Closes the source pipe, waits until all data has been written and rethrows errors of the target stream
+		void finish();
+	};
+
+}
+
+#endif // _NMR_EXPORT_STREAM_PIPE
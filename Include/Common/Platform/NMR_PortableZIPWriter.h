@@ -52,14 +52,18 @@ namespace NMR {
 		nfBool m_bIsFinished;
 
 		nfBool m_bWriteZIP64;
+		nfBool m_bWriteDataDescriptors;
 		nfUint16 m_nVersionMade;
 		nfUint16 m_nVersionNeeded;
 
 		std::list<PPortableZIPWriterEntry> m_Entries;
 		PExportStream m_pCurrentStream;
+
+		void patchLocalHeader();
+		void writeDataDescriptor();
 	public:
 		CPortableZIPWriter() = delete;
-		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64);
+		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64, _In_ nfBool bWriteDataDescriptors);
 		~CPortableZIPWriter();
 
 		PExportStream createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp);
@@ -51,6 +51,8 @@ NMR_PortableZIPWriterTypes.h defines a portable and fast writer of ZIP files
 
 #define ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD 0x0001
 
+#define ZIPFILEGENERALPURPOSEFLAG_DATADESCRIPTOR 0x0008
+
 #define ZIPFILECOMPRESSION_UNCOMPRESSED 0
 #define ZIPFILECOMPRESSION_DEFLATED 8
 #define ZIPFILEMAXFILENAMELENGTH 32000
@@ -98,6 +100,32 @@ namespace NMR {
 		}
 	} ZIPLOCALFILEDESCRIPTOR;
 
+	typedef struct {
+		nfUint32 m_nSignature;
+		nfUint32 m_nCRC32;
+		nfUint32 m_nCompressedSize;
+		nfUint32 m_nUnCompressedSize;
+		void swapByteOrder() {
+			m_nSignature = swapBytes(m_nSignature);
+			m_nCRC32 = swapBytes(m_nCRC32);
+			m_nCompressedSize = swapBytes(m_nCompressedSize);
+			m_nUnCompressedSize = swapBytes(m_nUnCompressedSize);
+		}
+	} ZIPDATADESCRIPTOR;
+
+	typedef struct {
+		nfUint32 m_nSignature;
+		nfUint32 m_nCRC32;
+		nfUint64 m_nCompressedSize;
+		nfUint64 m_nUnCompressedSize;
+		void swapByteOrder() {
+			m_nSignature = swapBytes(m_nSignature);
+			m_nCRC32 = swapBytes(m_nCRC32);
+			m_nCompressedSize = swapBytes(m_nCompressedSize);
+			m_nUnCompressedSize = swapBytes(m_nUnCompressedSize);
+		}
+	} ZIP64DATADESCRIPTOR;
+
 	typedef struct {
 		nfUint16 m_nTag;
 		nfUint16 m_nFieldSize;
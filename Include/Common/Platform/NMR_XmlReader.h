@@ -65,6 +65,9 @@ namespace NMR {
 		virtual nfBool MoveToNextAttribute() = 0;
 		virtual nfBool IsDefault() = 0;
 		virtual void CloseElement();
+
+		// Bytes held by the parse buffers of the reader
+		virtual nfUint64 getMemoryUsage();
 	};
 
 	typedef std::shared_ptr<CXmlReader> PXmlReader;
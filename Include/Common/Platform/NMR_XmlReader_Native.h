@@ -170,6 +170,7 @@ namespace NMR {
 		virtual nfBool IsDefault();
 		virtual void CloseElement();
 
+		virtual nfUint64 getMemoryUsage();
 	};
 
 	typedef std::shared_ptr<CXmlReader_Native> PXmlReader_Native;
@@ -91,6 +91,16 @@ namespace NMR {
 
 	typedef std::map<NMR::PackageResourceID, NMR::PackageResourceID> UniqueResourceIDMapping;
 
+	class CModelMeshObject;
+	class CModelBuildItem;
+
+	// A mesh object referenced by a build item, with the transform accumulated along its component path
+	typedef struct {
+		CModelMeshObject * m_pMeshObject;
+		NMATRIX3 m_mTransform;
+		CModelBuildItem * m_pBuildItem;
+	} MODELMESHINSTANCE;
+
 	class CModel {
 	private:
 		std::string m_sCurPath;
@@ -99,7 +109,8 @@ namespace NMR {
 		std::unordered_map<std::string, PUUID> usedUUIDs;	// datastructure used to ensure that UUIDs within one model (package) are unique
 
 		// Object Resources of the model
-		std::map<PackageResourceID, PModelResource> m_ResourceMap;
+		// Indexed by unique ID, which the resource handler assigns consecutively
+		std::vector<PModelResource> m_ResourceMap;
 		CResourceHandler m_resourceHandler;
 	private:
 		std::vector<PModelResource> m_Resources;
@@ -107,6 +118,10 @@ namespace NMR {
 		// Model Build Items
 		std::vector<PModelBuildItem> m_BuildItems;
 
+		// Flattened mesh instances of all build items. Rebuilt on demand after the build or a component changed.
+		std::vector<MODELMESHINSTANCE> m_MeshInstances;
+		nfBool m_bMeshInstancesValid;
+
 		// build's UUID. Empty if none defined
 		PUUID m_buildUUID;
 
@@ -120,6 +135,16 @@ namespace NMR {
 		// Model Metadata
 		PModelMetaDataGroup m_MetaDataGroup;
 
+		// Optional arena for the bulk data of meshes and slices. Null, if the global heap is used.
+		PMemoryArena m_pMemoryArena;
+
+		// Peak memory usage, sampled by readers and writers
+		nfBool m_bTrackPeakMemoryUsage;
+		nfUint64 m_nPeakMemoryUsage;
+		// Resource usage of the last sample and the number of resources it covers
+		nfUint32 m_nSampledResourceCount;
+		nfUint64 m_nSampledResourceMemoryUsage;
+
 		// Model Attachments
 		std::vector<PModelAttachment> m_Attachments;
 		std::unordered_map<std::string, PModelAttachment> m_AttachmentURIMap;
@@ -156,6 +181,15 @@ namespace NMR {
 
 		// Merge all build items into one mesh
 		void mergeToMesh(_In_ CMesh * pMesh);
+		// Appends the mesh objects referenced by all build items, with the transforms accumulated along their component paths
+		void collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances);
+		// Cached result of collectMeshInstances. The reference is valid until the next build or component change.
+		const std::vector<MODELMESHINSTANCE> & getMeshInstances();
+		void invalidateMeshInstances();
+		// Maps every mesh object, whose mesh equals the mesh of a mesh object earlier in the sorted object list,
+		// onto that mesh object and the transform from its mesh onto the duplicate. If bRigidTransforms is set, rotated
+		// and translated copies count as duplicates. Objects with beams, slices or of type other are never mapped.
+		void findDuplicateMeshes(_In_ nfBool bRigidTransforms, _Out_ std::map<CModelMeshObject *, MODELMESHINSTANCE> & Duplicates);
 
 		// Units setter/getter
 		void setUnit(_In_ eModelUnit Unit);
@@ -167,13 +201,39 @@ namespace NMR {
 		void setLanguage(_In_ std::string sLanguage);
 		std::string getLanguage();
 
+		// Memory arena handling. Data allocated before stays where it is.
+		void setUseMemoryArena(_In_ nfBool bUseMemoryArena);
+		nfBool getUseMemoryArena();
+		PMemoryArena getMemoryArena();
+
+		// Memory accounting: bytes held by resources and attachments. Node and face arrays which are shared
+		// between mesh objects are counted once.
+		nfUint64 getMemoryUsage();
+		nfUint64 getResourceMemoryUsage();
+		nfUint64 getAttachmentMemoryUsage();
+
+		// Peak memory tracking. Enabling resets the peak to the current usage.
+		// Readers and writers sample the usage together with their transient buffers.
+		void setTrackPeakMemoryUsage(_In_ nfBool bTrackPeakMemoryUsage);
+		nfBool getTrackPeakMemoryUsage();
+		nfUint64 getPeakMemoryUsage();
+		void samplePeakMemoryUsage(_In_ nfUint64 nTransientMemoryUsage);
+		// Same as samplePeakMemoryUsage for readers, which sample after every resource they add. Only the
+		// resources added since the last sample are summed up, the others are taken from that sample.
+		void sampleAddedResourcesPeakMemoryUsage(_In_ nfUint64 nTransientMemoryUsage);
+
 		// General Resource Handling
 		PModelResource findResource(_In_ std::string path, ModelResourceID nID);
 		PModelResource findResource(_In_ PackageResourceID nID);
 		PModelResource findResource(_In_ PPackageResourceID pID);
+		PModelResource findResource(_In_ PackageResourcePathHandle nPathHandle, ModelResourceID nID);
 
 		PPackageResourceID findPackageResourceID(_In_ std::string path, ModelResourceID nID);
 		PPackageResourceID findPackageResourceID(_In_ PackageResourceID nID);
+		PPackageResourceID findPackageResourceID(_In_ PackageResourcePathHandle nPathHandle, ModelResourceID nID);
+
+		// Resolves a path once for repeated lookups of IDs in the same model part
+		PackageResourcePathHandle getPathHandle(_In_ const std::string & path);
 		
 		nfUint32 getResourceCount();
 		PModelResource getResource(_In_ nfUint32 nIndex);
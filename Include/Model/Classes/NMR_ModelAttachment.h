@@ -61,6 +61,9 @@ namespace NMR {
 
 		void setStream(_In_ PImportStream pStream);
 		void setRelationShipType(_In_ const std::string sRelationShipType);
+
+		// Bytes of the attachment data held in memory. Streams of files or callbacks are not counted.
+		nfUint64 getMemoryUsage();
 	};
 
 	typedef std::shared_ptr <CModelAttachment> PModelAttachment;
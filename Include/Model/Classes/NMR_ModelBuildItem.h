@@ -92,6 +92,7 @@ namespace NMR {
 
 		// Merge the build item to the given mesh
 		void mergeToMesh(_In_ CMesh * pMesh);
+		void collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances);
 
 		// Returns a unique handle to identify the build item
 		nfUint32 getHandle();
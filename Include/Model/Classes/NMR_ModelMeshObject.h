@@ -51,6 +51,13 @@ namespace NMR {
 	private:
 		PMesh m_pMesh; 
 		PModelMeshBeamLatticeAttributes m_pBeamLatticeAttributes;
+
+		// Result of the last manifold check, which is reused while the mesh is unchanged
+		nfBool m_bHasManifoldResult;
+		nfBool m_bManifoldAndOriented;
+		nfUint64 m_nManifoldModificationCount;
+
+		nfBool checkManifoldAndOriented();
 	public:
 		CModelMeshObject() = delete;
 		CModelMeshObject(_In_ const ModelResourceID sID, _In_ CModel * pModel);
@@ -60,7 +67,9 @@ namespace NMR {
 		_Ret_notnull_ CMesh * getMesh ();
 		void setMesh (_In_ PMesh pMesh);
 
-		void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix) override;
+		void collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances, _In_ const NMATRIX3 mMatrix) override;
+		// Merges the meshes of all instances into pMesh, with their transforms applied
+		static void mergeInstancesToMesh(_In_ CMesh * pMesh, _In_ const std::vector<MODELMESHINSTANCE> & Instances);
 
 		void setObjectType(_In_ eModelObjectType ObjectType) override;
 
@@ -72,7 +81,7 @@ namespace NMR {
 
 		virtual nfBool isValidForBeamLattices();
 
-		// check, if the mesh is manifold and oriented
+		// check, if the mesh is manifold and oriented. The result is cached until the mesh is modified.
 		virtual nfBool isManifoldAndOriented();
 
 		_Ret_notnull_ PModelMeshBeamLatticeAttributes getBeamLatticeAttributes();
@@ -80,6 +89,9 @@ namespace NMR {
 
 		void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix) override;
 
+		nfUint64 getMemoryUsage() override;
+		nfUint64 getDistinctMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers) override;
+
 	};
 
 	typedef std::shared_ptr <CModelMeshObject> PModelMeshObject;
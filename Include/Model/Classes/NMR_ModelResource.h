@@ -66,8 +66,15 @@ namespace NMR {
 		void clearResourceIndexMap();
 		virtual void buildResourceIndexMap();
 		nfBool hasResourceIndexMap();
+		// Property IDs by resource index, for callers mapping many indices. Changes when the map is rebuilt.
+		const std::vector<ModelPropertyID> & getResourceIndexMap();
 
 		_Ret_notnull_ CModel * getModel();
+
+		// Bytes held by the bulk data of the resource, e.g. geometry
+		virtual nfUint64 getMemoryUsage();
+		// Same as getMemoryUsage, but counts buffers shared with resources summed up before only once
+		virtual nfUint64 getDistinctMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers);
 	};
 
 	typedef std::shared_ptr <CModelResource> PModelResource;
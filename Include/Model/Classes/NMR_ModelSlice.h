@@ -37,20 +37,25 @@ A Model Slice represents a single slice as vertices and polygons
 #include "Common/NMR_Types.h"
 #include "Common/Mesh/NMR_MeshTypes.h"
 #include "Model/Classes/NMR_ModelResource.h"
+#include "Common/NMR_MemoryArena.h"
 
 #include <vector>
 
 namespace NMR {
+	typedef std::vector<SLICENODE, CArenaAllocator<SLICENODE>> SLICENODES;
+	typedef std::vector<nfUint32, CArenaAllocator<nfUint32>> SLICEPOLYGON;
+
 	class CSlice {
 	private:
-		std::vector<SLICENODE> m_Vertices;
-		std::vector<std::vector<nfUint32>> m_Polygons;
+		PMemoryArena m_pMemoryArena;
+		SLICENODES m_Vertices;
+		std::vector<SLICEPOLYGON> m_Polygons;
 
 		nfDouble m_dZTop;
 
 	public:
 		CSlice() = delete;
-		CSlice(nfDouble dZTop);
+		CSlice(nfDouble dZTop, _In_opt_ PMemoryArena pMemoryArena = nullptr);
 		CSlice(CSlice&);
 		~CSlice();
 
@@ -83,6 +88,9 @@ namespace NMR {
 		bool allPolygonsAreClosed();
 
 		bool isPolygonValid(nfUint32 nPolygonIndex);
+
+		// Bytes held by vertices and polygons
+		nfUint64 getMemoryUsage();
 	};
 
 	typedef std::shared_ptr <CSlice> PSlice;
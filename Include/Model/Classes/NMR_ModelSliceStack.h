@@ -81,6 +81,8 @@ namespace NMR {
 		void SetOwnPath(std::string);
 
 		bool areAllPolygonsClosed();
+
+		nfUint64 getMemoryUsage() override;
 	};
 
 	typedef std::shared_ptr<CModelSliceStack> PModelSliceStack;
@@ -34,6 +34,7 @@ NMR_PackageResourceID.h defines the PackageResourceID Class.
 #define __NMR_PACKAGERESOURCEID
 
 #include "Model/Classes/NMR_ModelTypes.h"
+#include "Common/NMR_Types.h"
 #include <string>
 
 #include <memory>
@@ -43,6 +44,10 @@ NMR_PackageResourceID.h defines the PackageResourceID Class.
 
 namespace NMR {
 
+	// Registered model part path. Lookups by path handle neither hash nor compare the path string,
+	// so callers resolving many IDs of the same part obtain the handle once.
+	typedef nfUint32 PackageResourcePathHandle;
+
 	class CPackageResourceID {
 	private:
 		std::string m_path;
@@ -63,13 +68,21 @@ namespace NMR {
 
 	class CResourceHandler {
 	private:
-		// unique IDs to CPackageResourceID
-		std::unordered_map<PackageResourceID, PPackageResourceID> m_resourceIDs;
-		std::map<std::pair<ModelResourceID, std::string>, PPackageResourceID> m_IdAndPathToResourceIDs;
+		// CPackageResourceIDs, indexed by unique ID - 1. Unique IDs are assigned consecutively.
+		std::vector<PPackageResourceID> m_resourceIDs;
+		std::unordered_map<std::string, PackageResourcePathHandle> m_PathHandles;
+		// CPackageResourceIDs by path handle and model resource ID, see makePathAndIdKey
+		std::unordered_map<nfUint64, PPackageResourceID> m_PathAndIdToResourceIDs;
+
+		static nfUint64 makePathAndIdKey(PackageResourcePathHandle nPathHandle, ModelResourceID id);
 	public:
 		PPackageResourceID getNewResourceID(std::string path, ModelResourceID id);	// this is supposed to be the only way to generate a CPackageResourceID
 		PPackageResourceID findResourceID(PackageResourceID id);
 		PPackageResourceID findResourceID(std::string path, ModelResourceID id);
+		PPackageResourceID findResourceID(PackageResourcePathHandle nPathHandle, ModelResourceID id);
+
+		// Returns the handle of a path and registers the path, if it is new. Handles stay valid until clear.
+		PackageResourcePathHandle getPathHandle(const std::string & path);
 
 		void FlattenIDs();
 
@@ -40,8 +40,22 @@ A triangles reader model node is a parser for the triangles node of an XML Model
 #include "Model/Classes/NMR_ModelComponent.h"
 #include "Model/Classes/NMR_ModelObject.h"
 
+#include <unordered_map>
+
+// Resource IDs below this value are cached in a directly indexed table, larger ones in a hash table
+#define NMR_MODELREADER_TRIANGLES_DIRECTRESOURCEIDS 65536
+
 namespace NMR {
 
+	// A pid of the triangles element, resolved once for all triangles using it
+	typedef struct {
+		// Unique ID of the resource, 0 if the pid is not a resource ID of the model part
+		PackageResourceID m_nUniqueID;
+		PModelResource m_pResource;
+		const ModelPropertyID * m_pPropertyIDs;
+		nfUint32 m_nPropertyCount;
+	} MODELREADERTRIANGLESRESOURCE;
+
 	class CModelReaderNode100_Triangles : public CModelReaderNode {
 	protected:
 		CMesh * m_pMesh;
@@ -51,6 +65,16 @@ namespace NMR {
 		ModelResourceIndex m_nDefaultResourceIndex;
 		ModelResourceID m_nUsedResourceID;
 
+		PackageResourcePathHandle m_nPathHandle;
+		CMeshInformation_Properties * m_pProperties;
+
+		// Resolved pids. The lookup tables hold indices into m_Resources plus one, 0 for pids not resolved yet.
+		std::vector<MODELREADERTRIANGLESRESOURCE> m_Resources;
+		std::vector<nfUint32> m_DirectResourceEntries;
+		std::unordered_map<ModelResourceID, nfUint32> m_ResourceEntries;
+
+		_Ret_notnull_ MODELREADERTRIANGLESRESOURCE * resolveResource(_In_ ModelResourceID nResourceID);
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader);
 
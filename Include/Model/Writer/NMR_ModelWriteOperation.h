@@ -0,0 +1,85 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelWriteOperation.h defines an asynchronous write of a model. The model is
+serialized and compressed on a worker thread, while a second thread writes the
+compressed package to the target stream.
+
+--*/
+
+#ifndef __NMR_MODELWRITEOPERATION
+#define __NMR_MODELWRITEOPERATION
+
+#include "Model/Writer/NMR_ModelWriter.h"
+#include "Common/Platform/NMR_ExportStream_Pipe.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace NMR {
+
+	class CModelWriteOperation {
+	private:
+		PModelWriter m_pWriter;
+		PExportStream m_pTargetStream;
+		PExportStream_Pipe m_pPipe;
+		nfBool m_bPreviousBackgroundCompression;
+
+		std::thread m_Thread;
+		// Serializes joining the thread, so that concurrent finish calls and the destructor join it only once
+		std::mutex m_JoinMutex;
+		std::mutex m_Mutex;
+		std::condition_variable m_FinishedCondition;
+		nfBool m_bFinished;
+		nfBool m_bCancelled;
+		std::exception_ptr m_pException;
+
+		void run();
+		void joinThread();
+
+	public:
+		CModelWriteOperation() = delete;
+		// Starts the write immediately. The model must not be modified until the operation has finished.
+		CModelWriteOperation(_In_ PModelWriter pWriter, _In_ PExportStream pTargetStream);
+		~CModelWriteOperation();
+
+		nfBool isFinished();
+		// Returns true, if the operation has finished within the timeout
+		nfBool waitFor(_In_ nfUint32 nTimeoutMilliseconds);
+		void cancel();
+		// Waits for the operation and rethrows its error, if any
+		void finish();
+	};
+
+	typedef std::shared_ptr <CModelWriteOperation> PModelWriteOperation;
+
+}
+
+#endif // __NMR_MODELWRITEOPERATION
@@ -44,6 +44,11 @@ namespace NMR {
 	class CModelWriter {
 	private:
 		nfUint32 m_nDecimalPrecision;
+		nfBool m_bBackgroundCompression;
+		nfBool m_bVertexCacheOptimization;
+		nfBool m_bMeshDeduplication;
+		nfBool m_bRigidMeshDeduplication;
+		nfBool m_bReleaseStreamedMeshes;
 	protected:
 		PModel m_pModel;
 		PProgressMonitor m_pProgressMonitor;
@@ -60,6 +65,28 @@ namespace NMR {
 
 		void SetDecimalPrecision(nfUint32);
 		nfUint32 GetDecimalPrecision();
+
+		// Compress the model data on a separate thread while it is being serialized
+		void SetBackgroundCompression(nfBool bBackgroundCompression);
+		nfBool GetBackgroundCompression();
+
+		// Reorder faces and nodes of meshes for index locality when writing
+		void SetVertexCacheOptimization(nfBool bVertexCacheOptimization);
+		nfBool GetVertexCacheOptimization();
+
+		// Write mesh objects whose mesh duplicates an earlier mesh object as components of that object.
+		// With rigid deduplication, rotated and translated copies are written this way, too.
+		void SetMeshDeduplication(nfBool bMeshDeduplication);
+		nfBool GetMeshDeduplication();
+		void SetRigidMeshDeduplication(nfBool bRigidMeshDeduplication);
+		nfBool GetRigidMeshDeduplication();
+
+		// Clear the mesh of each object once it has been written by an incremental write
+		void SetReleaseStreamedMeshes(nfBool bReleaseStreamedMeshes);
+		nfBool GetReleaseStreamedMeshes();
+
+		void RequestCancel();
+		void ClearCancelRequest();
 	};
 
 	typedef std::shared_ptr <CModelWriter> PModelWriter;
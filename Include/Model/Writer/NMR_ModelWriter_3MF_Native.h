@@ -37,6 +37,11 @@ using LibZ and a native XML writer implementation.
 
 #include "Common/OPC/NMR_OpcPackageWriter.h" 
 #include "Model/Writer/NMR_ModelWriter_3MF.h" 
+#include "Model/Writer/v100/NMR_ModelWriterNode100_Model.h" 
+#include "Common/Platform/NMR_XmlWriter_Native.h" 
+
+#include <memory>
+#include <set>
 
 #define MODELWRITER_NATIVE_BUFFERSIZE 65536
 
@@ -48,6 +53,13 @@ namespace NMR {
 		CModel * m_pModel;
 		std::vector<nfByte> m_aSliceStreamBuffer;
 
+		// State of an incremental (streaming) write
+		POpcPackageWriter m_pStreamPackageWriter;
+		POpcPackagePart m_pStreamModelPart;
+		PXmlWriter_Native m_pStreamXMLWriter;
+		std::unique_ptr<CModelWriterNode100_Model> m_pStreamModelNode;
+		std::set<PackageResourceID> m_StreamedObjects;
+
 		// These are OPC dependent functions
 		virtual void createPackage(_In_ CModel * pModel);
 		virtual void writePackageToStream(_In_ PExportStream pStream);
@@ -56,10 +68,21 @@ namespace NMR {
 		std::string generateRelationShipID();
 		void addAttachments(_In_ CModel * pModel, _In_ POpcPackageWriter pPackageWriter, _In_ POpcPackagePart pModelPart);
 		void addSlicerefAttachments();
+		void writePackageParts(_In_ POpcPackageWriter pPackageWriter, _In_ POpcPackagePart pModelPart);
+
+		void writeStreamedObject(_In_ CModelObject * pObject);
+		void resetStream();
 
 	public:
 		CModelWriter_3MF_Native() = delete;
 		CModelWriter_3MF_Native(_In_ PModel pModel);
+
+		// Incremental writing: objects are serialized as they are appended. Their geometry is only released if requested.
+		// Build items and all objects that have not been appended explicitly are written on finish.
+		void beginStream(_In_ PExportStream pStream);
+		void appendObject(_In_ PackageResourceID nResourceID);
+		void finishStream();
+		nfBool isStreaming();
 	};
 
 }
@@ -39,6 +39,7 @@ This is the class for exporting the 3mf mesh node.
 #include "Model/Classes/NMR_ModelMeshObject.h" 
 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/Mesh/NMR_MeshVertexCacheOptimizer.h"
 
 #include "Common/Platform/NMR_XmlWriter.h"
 #include <array>
@@ -64,6 +65,8 @@ namespace NMR {
 
 		nfBool m_bWriteMaterialExtension;
 		nfBool m_bWriteBeamLatticeExtension;
+		nfBool m_bOptimizeVertexCache;
+		nfUint64 m_nTransientMemoryUsage;
 
 		// Internal functions for an efficient and buffered output of raw XML data
 		std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> m_VertexLine;
@@ -79,10 +82,12 @@ namespace NMR {
 		const int m_nPutDoubleFactor;
 		__NMR_INLINE void putFloat(_In_ const nfFloat fValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos);
 		__NMR_INLINE void putDouble(_In_ const nfDouble dValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos);
+		__NMR_INLINE void putFixedPoint(_In_ const nfInt64 nValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos);
 
 	protected:
 		__NMR_INLINE void putVertexString(_In_ const nfChar * pszString);
 		__NMR_INLINE void putVertexFloat(_In_ const nfFloat fValue);
+		__NMR_INLINE void putVertexFixedPoint(_In_ const nfInt64 nValue);
 
 		__NMR_INLINE void putTriangleString(_In_ const nfChar * pszString);
 		__NMR_INLINE void putTriangleUInt32(_In_ const nfUint32 nValue);
@@ -94,17 +99,22 @@ namespace NMR {
 		__NMR_INLINE void putBeamRefString(_In_ const nfChar * pszString);
 		__NMR_INLINE void putBeamRefUInt32(_In_ const nfUint32 nValue);
 
-		__NMR_INLINE void writeVertexData(_In_ MESHNODE * pNode);
-		__NMR_INLINE void writeFaceData_Plain(_In_ MESHFACE * pFace, _In_opt_ const nfChar * pszAdditionalString);
-		__NMR_INLINE void writeFaceData_OneProperty(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex, _In_opt_ const nfChar * pszAdditionalString);
-		__NMR_INLINE void writeFaceData_ThreeProperties(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex1, _In_ const ModelResourceIndex nPropertyIndex2, _In_ const ModelResourceIndex nPropertyIndex3, _In_opt_ const nfChar * pszAdditionalString);
-		__NMR_INLINE void writeBeamData(_In_ MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode);
+		__NMR_INLINE void writeVertexData(_In_ const NVEC3 & vPosition);
+		__NMR_INLINE void writeVertexData_FixedPoint(_In_ const nfInt64 * pValues);
+		__NMR_INLINE void writeFaceData_Plain(_In_ const MESHFACE * pFace, _In_opt_ const nfChar * pszAdditionalString);
+		__NMR_INLINE void writeFaceData_OneProperty(_In_ const MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex, _In_opt_ const nfChar * pszAdditionalString);
+		__NMR_INLINE void writeFaceData_ThreeProperties(_In_ const MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex1, _In_ const ModelResourceIndex nPropertyIndex2, _In_ const ModelResourceIndex nPropertyIndex3, _In_opt_ const nfChar * pszAdditionalString);
+		__NMR_INLINE void writeBeamData(_In_ const MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode);
 		__NMR_INLINE void writeRefData(_In_ INT nRefID);
 	public:
 		CModelWriterNode100_Mesh() = delete;
 		CModelWriterNode100_Mesh(_In_ CModelMeshObject * pModelMeshObject, _In_ CXmlWriter * pXMLWriter, _In_ PProgressMonitor pProgressMonitor,
-			_In_ PMeshInformation_PropertyIndexMapping pPropertyIndexMapping, _In_ int nPosAfterDecPoint, _In_ nfBool bWriteMaterialExtension, _In_ nfBool m_bWriteBeamLatticeExtension);
+			_In_ PMeshInformation_PropertyIndexMapping pPropertyIndexMapping, _In_ int nPosAfterDecPoint, _In_ nfBool bWriteMaterialExtension, _In_ nfBool m_bWriteBeamLatticeExtension,
+			_In_ nfBool bOptimizeVertexCache);
 		virtual void writeToXML();
+
+		// Bytes of temporary tables allocated during the last writeToXML call
+		nfUint64 getTransientMemoryUsage();
 	};
 
 }
@@ -42,6 +42,8 @@ This is the class for exporting the 3mf model stream root node.
 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 
+#include <set>
+
 
 namespace NMR {
 
@@ -61,12 +63,23 @@ namespace NMR {
 		nfBool m_bWriteObjects;
 		nfBool m_bIsRootModel;
 		nfBool m_bWriteCustomNamespaces;
-
+		// Custom namespaces declared on the model element. Later ones are declared on the elements that use them.
+		std::set<std::string> m_RootNameSpaces;
+		nfBool m_bOptimizeVertexCache;
+		nfBool m_bDeduplicateMeshes;
+		nfBool m_bRigidMeshDeduplication;
+		// Mesh objects which are written as a component of an equal mesh object
+		std::map<CModelMeshObject *, MODELMESHINSTANCE> m_MeshDuplicates;
+		nfUint64 m_nPeakTransientMemoryUsage;
+
+		void writeModelStartElement();
 		void writeModelMetaData();
 		void writeMetaData(_In_ PModelMetaData pMetaData);
 		void writeMetaDataGroup(_In_ PModelMetaDataGroup pMetaDataGroup);
+		void writeMetaDataGroupNameSpaces(_In_ PModelMetaDataGroup pMetaDataGroup);
 
 		void writeResources();
+		void writeNonObjectResources();
 		void writeBaseMaterials();
 		void writeTextures2D();
 		void writeColors();
@@ -83,6 +96,7 @@ namespace NMR {
 		void writeSliceStack(_In_ CModelSliceStack *pSliceStack);
 
 		void writeComponentsObject(_In_ CModelComponentsObject * pComponentsObject);
+		void writeMeshDuplicateComponents(_In_ CModelMeshObject * pDuplicateObject, _In_ const MODELMESHINSTANCE & Instance);
 
 		ModelResourceID generateOutputResourceID();
 
@@ -95,6 +109,18 @@ namespace NMR {
 		CModelWriterNode100_Model(_In_ CModel * pModel, _In_ CXmlWriter * pXMLWriter, _In_ PProgressMonitor pProgressMonitor, _In_ nfUint32 nDecimalPrecision, _In_ nfBool bWritesRootModel);
 		
 		virtual void writeToXML();
+
+		void setOptimizeVertexCache(_In_ nfBool bOptimizeVertexCache);
+		// Duplicate meshes are detected when all objects are written at once, not in incremental writing
+		void setMeshDeduplication(_In_ nfBool bDeduplicateMeshes, _In_ nfBool bRigidTransforms);
+
+		// Largest amount of temporary memory a single object node needed so far
+		nfUint64 getPeakTransientMemoryUsage();
+
+		// Incremental writing: header and non-object resources, single objects, resource end and build
+		void writeStreamHeader();
+		void writeObject(_In_ CModelObject * pObject);
+		void writeStreamFooter();
 	};
 
 }
@@ -173,12 +173,8 @@ Lib3MF_uint32 CBeamLattice::AddBeam (const sLib3MFBeam BeamInfo)
 	if (!isBeamValid(m_mesh.getNodeCount(), BeamInfo))
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-	// retrieve nodes and add beam
-	NMR::MESHNODE * pNodes[2];
-	for (int j = 0; j < 2; j++)
-		pNodes[j] = m_mesh.getNode(BeamInfo.m_Indices[j]);
-
-	NMR::MESHBEAM * pMeshBeam = m_mesh.addBeam(pNodes[0], pNodes[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
+	// add beam
+	NMR::MESHBEAM * pMeshBeam = m_mesh.addBeam(BeamInfo.m_Indices[0], BeamInfo.m_Indices[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
 	return pMeshBeam->m_index;
 }
 
@@ -211,11 +207,7 @@ void CBeamLattice::SetBeams(const Lib3MF_uint64 nBeamInfoBufferSize, const sLib3
 		if (!isBeamValid(m_mesh.getNodeCount(), *pBeamInfoCurrent))
 			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-		NMR::MESHNODE * pNodes[2];
-		for (int j = 0; j < 2; j++)
-			pNodes[j] = m_mesh.getNode(pBeamInfoCurrent->m_Indices[j]);
-		
-		m_mesh.addBeam(pNodes[0], pNodes[1], pBeamInfoCurrent->m_Radii[0], pBeamInfoCurrent->m_Radii[1], (int)pBeamInfoCurrent->m_CapModes[0], (int)pBeamInfoCurrent->m_CapModes[1]);
+		m_mesh.addBeam(pBeamInfoCurrent->m_Indices[0], pBeamInfoCurrent->m_Indices[1], pBeamInfoCurrent->m_Radii[0], pBeamInfoCurrent->m_Radii[1], (int)pBeamInfoCurrent->m_CapModes[0], (int)pBeamInfoCurrent->m_CapModes[1]);
 		pBeamInfoCurrent++;
 	}
 
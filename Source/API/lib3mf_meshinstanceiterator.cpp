@@ -0,0 +1,126 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium (Original Author)
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: This is a stub class definition of CMeshInstanceIterator
+
+*/
+
+#include "lib3mf_meshinstanceiterator.hpp"
+#include "lib3mf_interfaceexception.hpp"
+
+#include "lib3mf_meshobject.hpp"
+#include "lib3mf_builditem.hpp"
+#include "lib3mf_utils.hpp"
+// Include custom headers here.
+
+
+using namespace Lib3MF::Impl;
+
+/*************************************************************************************************************************
+ Class definition of CMeshInstanceIterator 
+**************************************************************************************************************************/
+
+CMeshInstanceIterator::CMeshInstanceIterator()
+{
+	m_nCurrentIndex = -1;
+}
+
+void CMeshInstanceIterator::addMeshInstance(NMR::PModelResource pMeshObject, NMR::PModelBuildItem pBuildItem, const NMR::NMATRIX3 & mTransform)
+{
+	sMeshInstance Instance;
+	Instance.m_pMeshObject = pMeshObject;
+	Instance.m_pBuildItem = pBuildItem;
+	Instance.m_mTransform = mTransform;
+	m_Instances.push_back(Instance);
+}
+
+const CMeshInstanceIterator::sMeshInstance & CMeshInstanceIterator::currentInstance()
+{
+	Lib3MF_int32 nInstanceCount = (Lib3MF_int32)m_Instances.size();
+	if ((m_nCurrentIndex < 0) || (m_nCurrentIndex >= nInstanceCount))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_ITERATORINVALIDINDEX);
+
+	return m_Instances[m_nCurrentIndex];
+}
+
+bool CMeshInstanceIterator::MoveNext ()
+{
+	Lib3MF_int32 nInstanceCount = (Lib3MF_int32)m_Instances.size();
+	m_nCurrentIndex++;
+
+	// Check new Index
+	if (m_nCurrentIndex >= nInstanceCount) {
+		m_nCurrentIndex = nInstanceCount;
+		return false;
+	}
+	else {
+		return true;
+	}
+}
+
+bool CMeshInstanceIterator::MovePrevious ()
+{
+	m_nCurrentIndex--;
+
+	// Check new Index
+	if (m_nCurrentIndex <= -1) {
+		m_nCurrentIndex = -1;
+		return false;
+	}
+	else {
+		return true;
+	}
+}
+
+IMeshObject * CMeshInstanceIterator::GetCurrentMeshObject ()
+{
+	return CMeshObject::fnCreateMeshObjectFromModelResource(currentInstance().m_pMeshObject, true);
+}
+
+IBuildItem * CMeshInstanceIterator::GetCurrentBuildItem ()
+{
+	return new CBuildItem(currentInstance().m_pBuildItem);
+}
+
+sLib3MFTransform CMeshInstanceIterator::GetCurrentTransform ()
+{
+	return MatrixToTransform(currentInstance().m_mTransform);
+}
+
+IMeshInstanceIterator * CMeshInstanceIterator::Clone ()
+{
+	auto pInstances = std::unique_ptr<CMeshInstanceIterator>(new CMeshInstanceIterator());
+
+	for (auto iIterator = m_Instances.begin(); iIterator != m_Instances.end(); iIterator++)
+		pInstances->addMeshInstance(iIterator->m_pMeshObject, iIterator->m_pBuildItem, iIterator->m_mTransform);
+
+	return pInstances.release();
+}
+
+Lib3MF_uint64 CMeshInstanceIterator::Count()
+{
+	return m_Instances.size();
+}
@@ -35,9 +35,15 @@ Abstract: This is a stub class definition of CMeshObject
 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include <cmath>
+#include <cstddef>
 
 using namespace Lib3MF::Impl;
 
+// Triangle properties are copied in bulk between the API buffers and the mesh information records
+static_assert(sizeof(sLib3MFTriangleProperties) == sizeof(NMR::MESHINFORMATION_PROPERTIES), "Triangle property layouts differ");
+static_assert(offsetof(sLib3MFTriangleProperties, m_ResourceID) == offsetof(NMR::MESHINFORMATION_PROPERTIES, m_nResourceID), "Triangle property layouts differ");
+static_assert(offsetof(sLib3MFTriangleProperties, m_PropertyIDs) == offsetof(NMR::MESHINFORMATION_PROPERTIES, m_nPropertyIDs), "Triangle property layouts differ");
+
 /*************************************************************************************************************************
  Class definition of CMeshObject 
  **************************************************************************************************************************/
@@ -65,7 +71,7 @@ NMR::CMeshInformation_Properties* CMeshObject::getMeshInformationProperties()
 	NMR::CMeshInformation_Properties * pInformation = dynamic_cast<NMR::CMeshInformation_Properties *> (pInformationHandler->getInformationByType(0, NMR::emiProperties));
 
 	if (pInformation == nullptr) {
-		NMR::PMeshInformation_Properties pNewInformation = std::make_shared<NMR::CMeshInformation_Properties>(pMesh->getFaceCount());
+		NMR::PMeshInformation_Properties pNewInformation = std::make_shared<NMR::CMeshInformation_Properties>(pMesh->getFaceCount(), pMesh->getMemoryArena());
 		pInformationHandler->addInformation(pNewInformation);
 
 		pInformation = pNewInformation.get();
@@ -112,17 +118,17 @@ void CMeshObject::SetVertex (const Lib3MF_uint32 nIndex, const sLib3MFPosition C
 
 sLib3MFPosition CMeshObject::GetVertex(const Lib3MF_uint32 nIndex)
 {
-	NMR::MESHNODE* node = mesh()->getNode(nIndex);
+	NMR::NVEC3 vPosition = mesh()->getNodePosition(nIndex);
 	sLib3MFPosition pos;
-	pos.m_Coordinates[0] = node->m_position.m_fields[0];
-	pos.m_Coordinates[1] = node->m_position.m_fields[1];
-	pos.m_Coordinates[2] = node->m_position.m_fields[2];
+	pos.m_Coordinates[0] = vPosition.m_fields[0];
+	pos.m_Coordinates[1] = vPosition.m_fields[1];
+	pos.m_Coordinates[2] = vPosition.m_fields[2];
 	return pos;
 }
 
 Lib3MF_uint32 CMeshObject::AddVertex (const sLib3MFPosition Coordinates)
 {
-	return mesh()->addNode(Coordinates.m_Coordinates[0], Coordinates.m_Coordinates[1], Coordinates.m_Coordinates[2])->m_index;
+	return mesh()->addNode(Coordinates.m_Coordinates[0], Coordinates.m_Coordinates[1], Coordinates.m_Coordinates[2]);
 }
 
 void CMeshObject::GetVertices(Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64* pVerticesNeededCount, sLib3MFPosition * pVerticesBuffer)
@@ -133,12 +139,23 @@ void CMeshObject::GetVertices(Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64*
 
 	if (nVerticesBufferSize >= nodeCount && pVerticesBuffer)
 	{
-		for (Lib3MF_uint32 i = 0; i < nodeCount; i++)
-		{
-			const NMR::MESHNODE* node = mesh()->getNode(i);
-			pVerticesBuffer[i].m_Coordinates[0] = node->m_position.m_fields[0];
-			pVerticesBuffer[i].m_Coordinates[1] = node->m_position.m_fields[1];
-			pVerticesBuffer[i].m_Coordinates[2] = node->m_position.m_fields[2];
+		if (mesh()->hasQuantizedNodes()) {
+			for (Lib3MF_uint32 i = 0; i < nodeCount; i++)
+			{
+				NMR::NVEC3 vPosition = mesh()->getNodePosition(i);
+				pVerticesBuffer[i].m_Coordinates[0] = vPosition.m_fields[0];
+				pVerticesBuffer[i].m_Coordinates[1] = vPosition.m_fields[1];
+				pVerticesBuffer[i].m_Coordinates[2] = vPosition.m_fields[2];
+			}
+		}
+		else {
+			const NMR::MESHNODE* nodes = mesh()->getReadOnlyNodes();
+			for (Lib3MF_uint32 i = 0; i < nodeCount; i++)
+			{
+				pVerticesBuffer[i].m_Coordinates[0] = nodes[i].m_position.m_fields[0];
+				pVerticesBuffer[i].m_Coordinates[1] = nodes[i].m_position.m_fields[1];
+				pVerticesBuffer[i].m_Coordinates[2] = nodes[i].m_position.m_fields[2];
+			}
 		}
 	}
 }
@@ -146,7 +163,7 @@ void CMeshObject::GetVertices(Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64*
 sLib3MFTriangle CMeshObject::GetTriangle (const Lib3MF_uint32 nIndex)
 {
 	sLib3MFTriangle t;
-	NMR::MESHFACE* mf = mesh()->getFace(nIndex);
+	const NMR::MESHFACE* mf = mesh()->getReadOnlyFace(nIndex);
 
 	t.m_Indices[0] = mf->m_nodeindices[0];
 	t.m_Indices[1] = mf->m_nodeindices[1];
@@ -166,7 +183,7 @@ void CMeshObject::SetTriangle (const Lib3MF_uint32 nIndex, const sLib3MFTriangle
 
 Lib3MF_uint32 CMeshObject::AddTriangle(const sLib3MFTriangle Indices)
 {
-	return mesh()->addFace(Indices.m_Indices[0], Indices.m_Indices[1], Indices.m_Indices[2])->m_index;
+	return mesh()->addFace(Indices.m_Indices[0], Indices.m_Indices[1], Indices.m_Indices[2]);
 }
 
 void CMeshObject::GetTriangleIndices (Lib3MF_uint64 nIndicesBufferSize, Lib3MF_uint64* pIndicesNeededCount, sLib3MFTriangle * pIndicesBuffer)
@@ -177,12 +194,12 @@ void CMeshObject::GetTriangleIndices (Lib3MF_uint64 nIndicesBufferSize, Lib3MF_u
 
 	if (nIndicesBufferSize >= faceCount && pIndicesBuffer)
 	{
+		const NMR::MESHFACE* faces = mesh()->getReadOnlyFaces();
 		for (Lib3MF_uint32 i = 0; i < faceCount; i++)
 		{
-			const NMR::MESHFACE* face = mesh()->getFace(i);
-			pIndicesBuffer[i].m_Indices[0] = face->m_nodeindices[0];
-			pIndicesBuffer[i].m_Indices[1] = face->m_nodeindices[1];
-			pIndicesBuffer[i].m_Indices[2] = face->m_nodeindices[2];
+			pIndicesBuffer[i].m_Indices[0] = faces[i].m_nodeindices[0];
+			pIndicesBuffer[i].m_Indices[1] = faces[i].m_nodeindices[1];
+			pIndicesBuffer[i].m_Indices[2] = faces[i].m_nodeindices[2];
 		}
 	}
 }
@@ -217,13 +234,12 @@ void CMeshObject::SetTriangleProperties(const Lib3MF_uint32 nIndex, const sLib3M
 {
 	NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
 
-	NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nIndex);
-	if (pFaceData != nullptr) {
-		pFaceData->m_nResourceID = Properties.m_ResourceID;
-		for (unsigned j = 0; j < 3; j++) {
-			pFaceData->m_nPropertyIDs[j] = Properties.m_PropertyIDs[j];
-		}
+	NMR::MESHINFORMATION_PROPERTIES FaceData;
+	FaceData.m_nResourceID = Properties.m_ResourceID;
+	for (unsigned j = 0; j < 3; j++) {
+		FaceData.m_nPropertyIDs[j] = Properties.m_PropertyIDs[j];
 	}
+	pInformation->setFaceData(nIndex, (const NMR::MESHINFORMATIONFACEDATA*)&FaceData);
 
 }
 
@@ -231,7 +247,7 @@ void CMeshObject::GetTriangleProperties(const Lib3MF_uint32 nIndex, sLib3MFTrian
 {
 	NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
 
-	NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nIndex);
+	const NMR::MESHINFORMATION_PROPERTIES * pFaceData = (const NMR::MESHINFORMATION_PROPERTIES*)pInformation->readFaceData(nIndex);
 	if (pFaceData != nullptr) {
 		sProperty.m_ResourceID = pFaceData->m_nResourceID;
 		for (unsigned j = 0; j < 3; j++) {
@@ -260,22 +276,11 @@ void CMeshObject::SetAllTriangleProperties(const Lib3MF_uint64 nPropertiesArrayB
 
 	NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
 
-	const sLib3MFTriangleProperties * pProperty = pPropertiesArrayBuffer;
-
-	for (uint32_t nIndex = 0; nIndex < nFaceCount; nIndex++) {
-		NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nIndex);
-		if (pFaceData != nullptr) {
-			pFaceData->m_nResourceID = pProperty->m_ResourceID;
-			for (unsigned j = 0; j < 3; j++) {
-				pFaceData->m_nPropertyIDs[j] = pProperty->m_PropertyIDs[j];
-			}
-		}
-		pProperty++;
-	}
+	pInformation->setFaceDataRange(0, nFaceCount, (const NMR::MESHINFORMATIONFACEDATA*)pPropertiesArrayBuffer);
 
 	// Prepare an object-level property, if it makes sense to do so
 	if ((nFaceCount > 0) && (pInformation->getDefaultData() == nullptr)) {
-		NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(0);
+		const NMR::MESHINFORMATION_PROPERTIES * pFaceData = (const NMR::MESHINFORMATION_PROPERTIES*)pInformation->readFaceData(0);
 		std::unique_ptr<NMR::MESHINFORMATION_PROPERTIES> pDefaultFaceData(new NMR::MESHINFORMATION_PROPERTIES);
 		pDefaultFaceData->m_nResourceID = pFaceData->m_nResourceID;
 		for (unsigned j = 0; j < 3; j++) {
@@ -298,20 +303,41 @@ void CMeshObject::GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferS
 	{
 		NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
 
-		sLib3MFTriangleProperties * pProperty = pPropertiesArrayBuffer;
+		pInformation->readFaceDataRange(0, nFaceCount, (NMR::MESHINFORMATIONFACEDATA*)pPropertiesArrayBuffer);
+	}
+}
+
+void CMeshObject::SetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint64 nPropertiesArrayBufferSize, const sLib3MFTriangleProperties * pPropertiesArrayBuffer)
+{
+	uint32_t nFaceCount = mesh()->getFaceCount();
 
-		uint32_t nIndex;
-		for (nIndex = 0; nIndex < nFaceCount; nIndex++) {
+	if ((nStartIndex > nFaceCount) || (nPropertiesArrayBufferSize > nFaceCount - nStartIndex))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPROPERTYCOUNT);
+	if (nPropertiesArrayBufferSize == 0)
+		return;
+	if (pPropertiesArrayBuffer == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-			NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nIndex);
-			if (pFaceData != nullptr) {
-				pProperty->m_ResourceID = pFaceData->m_nResourceID;
-				for (unsigned j = 0; j < 3; j++) {
-					pProperty->m_PropertyIDs[j] = pFaceData->m_nPropertyIDs[j];
-				}
-			}
-			pProperty++;
-		}
+	NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
+
+	pInformation->setFaceDataRange(nStartIndex, (uint32_t)nPropertiesArrayBufferSize, (const NMR::MESHINFORMATIONFACEDATA*)pPropertiesArrayBuffer);
+}
+
+void CMeshObject::GetTrianglePropertiesRange(const Lib3MF_uint32 nStartIndex, const Lib3MF_uint32 nCount, Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer)
+{
+	uint32_t nFaceCount = mesh()->getFaceCount();
+
+	if ((nStartIndex > nFaceCount) || (nCount > nFaceCount - nStartIndex))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pPropertiesArrayNeededCount)
+		*pPropertiesArrayNeededCount = nCount;
+
+	if (nPropertiesArrayBufferSize >= nCount && pPropertiesArrayBuffer)
+	{
+		NMR::CMeshInformation_Properties * pInformation = getMeshInformationProperties();
+
+		pInformation->readFaceDataRange(nStartIndex, nCount, (NMR::MESHINFORMATIONFACEDATA*)pPropertiesArrayBuffer);
 	}
 }
 
@@ -330,37 +356,72 @@ void CMeshObject::SetGeometry(const Lib3MF_uint64 nVerticesBufferSize, const sLi
 	// Clear old mesh
 	pMesh->clear();
 
-	// Rebuild Mesh Coordinates
-	const sLib3MFPosition * pVertex = pVerticesBuffer;
-	for (Lib3MF_uint64 nIndex = 0; nIndex < nVerticesBufferSize; nIndex++) {
-		for (int j = 0; j < 3; j++) {
-			if (std::fabs(pVertex->m_Coordinates[j]) > NMR_MESH_MAXCOORDINATE)
-				throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
-		}
-		pMesh->addNode(pVertex->m_Coordinates[0], pVertex->m_Coordinates[1], pVertex->m_Coordinates[2]);
+	AddVertices(nVerticesBufferSize, pVerticesBuffer);
+	AddTriangles(nIndicesBufferSize, pIndicesBuffer);
+}
 
-		pVertex++;
-	}
+Lib3MF_pvoid CMeshObject::GetVertexData(Lib3MF_uint32 & nVertexCount, Lib3MF_uint32 & nStride)
+{
+	nVertexCount = mesh()->getNodeCount();
+	nStride = sizeof(NMR::MESHNODE);
+	// Contiguous float coordinates are only available in float storage
+	mesh()->dequantizeNodes();
+	return (nVertexCount > 0) ? (Lib3MF_pvoid)mesh()->getReadOnlyNodes() : nullptr;
+}
 
-	// Rebuild Mesh Faces
-	const sLib3MFTriangle * pTriangle = pIndicesBuffer;
-	for (Lib3MF_uint64 nIndex = 0; nIndex < nIndicesBufferSize; nIndex++) {
-		NMR::MESHNODE * pNodes[3];
+Lib3MF_pvoid CMeshObject::GetTriangleIndexData(Lib3MF_uint32 & nTriangleCount, Lib3MF_uint32 & nStride)
+{
+	nTriangleCount = mesh()->getFaceCount();
+	nStride = sizeof(NMR::MESHFACE);
+	return (nTriangleCount > 0) ? (Lib3MF_pvoid)mesh()->getReadOnlyFaces() : nullptr;
+}
 
-		for (int j = 0; j < 3; j++) {
-			if (pTriangle->m_Indices[j] >= nVerticesBufferSize)
-				throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
-			pNodes[j] = pMesh->getNode(pTriangle->m_Indices[j]);
-		}
+bool CMeshObject::QuantizeVertices(const Lib3MF_uint32 nDecimalPrecision)
+{
+	if ((nDecimalPrecision < 1) || (nDecimalPrecision > NMR_MESH_QUANTIZATIONMAXPRECISION))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	return mesh()->quantizeNodes(nDecimalPrecision);
+}
 
-		if ((pTriangle->m_Indices[0] == pTriangle->m_Indices[1]) ||
-			(pTriangle->m_Indices[0] == pTriangle->m_Indices[2]) ||
-			(pTriangle->m_Indices[1] == pTriangle->m_Indices[2]))
+bool CMeshObject::HasQuantizedVertices()
+{
+	return mesh()->hasQuantizedNodes();
+}
+
+Lib3MF_uint32 CMeshObject::AddVertices(const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer)
+{
+	if ((!pVerticesBuffer) && (nVerticesBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if (nVerticesBufferSize > NMR_MESH_MAXNODECOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	static_assert(sizeof(sLib3MFPosition) == 3 * sizeof(NMR::nfFloat), "sLib3MFPosition must consist of three floats");
+	try {
+		return mesh()->addNodes((const NMR::nfFloat *)pVerticesBuffer, (NMR::nfUint32)nVerticesBufferSize);
+	}
+	catch (NMR::CNMRException &e) {
+		if (e.getErrorCode() == NMR_ERROR_INVALIDCOORDINATES)
 			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+		throw e;
+	}
+}
 
-		pMesh->addFace(pNodes[0], pNodes[1], pNodes[2]);
+Lib3MF_uint32 CMeshObject::AddTriangles(const Lib3MF_uint64 nIndicesBufferSize, const sLib3MFTriangle * pIndicesBuffer)
+{
+	if ((!pIndicesBuffer) && (nIndicesBufferSize > 0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if (nIndicesBufferSize > NMR_MESH_MAXFACECOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-		pTriangle++;
+	static_assert(sizeof(sLib3MFTriangle) == 3 * sizeof(NMR::nfUint32), "sLib3MFTriangle must consist of three indices");
+	try {
+		return mesh()->addFaces((const NMR::nfUint32 *)pIndicesBuffer, (NMR::nfUint32)nIndicesBufferSize);
+	}
+	catch (NMR::CNMRException &e) {
+		if ((e.getErrorCode() == NMR_ERROR_INVALIDNODEINDEX) || (e.getErrorCode() == NMR_ERROR_DUPLICATENODE))
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+		throw e;
 	}
 }
 
@@ -36,6 +36,7 @@ Abstract: This is a stub class definition of CModel
 
 #include "lib3mf_builditem.hpp"
 #include "lib3mf_builditemiterator.hpp"
+#include "lib3mf_meshinstanceiterator.hpp"
 #include "lib3mf_meshobject.hpp"
 #include "lib3mf_objectiterator.hpp"
 #include "lib3mf_meshobjectiterator.hpp"
@@ -106,6 +107,45 @@ void CModel::SetLanguage (const std::string & sLanguage)
 	model().setLanguage(sLanguage);
 }
 
+bool CModel::GetUseMemoryArena ()
+{
+	return model().getUseMemoryArena();
+}
+
+void CModel::SetUseMemoryArena (const bool bUseMemoryArena)
+{
+	model().setUseMemoryArena(bUseMemoryArena);
+}
+
+Lib3MF_uint64 CModel::GetMemoryArenaUsage (Lib3MF_uint64 & nReservedSize)
+{
+	NMR::PMemoryArena pMemoryArena = model().getMemoryArena();
+	if (!pMemoryArena) {
+		nReservedSize = 0;
+		return 0;
+	}
+
+	nReservedSize = pMemoryArena->getReservedSize();
+	return pMemoryArena->getUsedSize();
+}
+
+Lib3MF_uint64 CModel::GetMemoryUsage (Lib3MF_uint64 & nResourceMemoryUsage, Lib3MF_uint64 & nAttachmentMemoryUsage)
+{
+	nResourceMemoryUsage = model().getResourceMemoryUsage();
+	nAttachmentMemoryUsage = model().getAttachmentMemoryUsage();
+	return model().getMemoryUsage();
+}
+
+void CModel::SetTrackPeakMemoryUsage (const bool bTrackPeakMemoryUsage)
+{
+	model().setTrackPeakMemoryUsage(bTrackPeakMemoryUsage);
+}
+
+Lib3MF_uint64 CModel::GetPeakMemoryUsage ()
+{
+	return model().getPeakMemoryUsage();
+}
+
 IWriter * CModel::QueryWriter (const std::string & sWriterClass)
 {
 	return new CWriter(sWriterClass, m_model);
@@ -259,6 +299,27 @@ IBuildItemIterator * CModel::GetBuildItems ()
 	return pResult.release();
 }
 
+IMeshInstanceIterator * CModel::GetMeshInstances ()
+{
+	const std::vector<NMR::MODELMESHINSTANCE> & Instances = model().getMeshInstances();
+
+	std::map<NMR::CModelBuildItem *, NMR::PModelBuildItem> BuildItems;
+	for (Lib3MF_uint32 nIdx = 0; nIdx < model().getBuildItemCount(); nIdx++) {
+		NMR::PModelBuildItem pBuildItem = model().getBuildItem(nIdx);
+		BuildItems.insert(std::make_pair(pBuildItem.get(), pBuildItem));
+	}
+
+	auto pResult = std::unique_ptr<CMeshInstanceIterator>(new CMeshInstanceIterator());
+	for (auto iInstance = Instances.begin(); iInstance != Instances.end(); iInstance++) {
+		NMR::PModelResource pMeshObject = model().findResource(iInstance->m_pMeshObject->getResourceID()->getUniqueID());
+		if (!pMeshObject.get())
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDMODELRESOURCE);
+		pResult->addMeshInstance(pMeshObject, BuildItems[iInstance->m_pBuildItem], iInstance->m_mTransform);
+	}
+
+	return pResult.release();
+}
+
 IResourceIterator * CModel::GetResources ()
 {
 	auto pResult = std::unique_ptr<CResourceIterator>(new CResourceIterator());
@@ -401,19 +462,13 @@ ISliceStackIterator * CModel::GetSliceStacks()
 	return pResult.release();
 }
 
-IModel * CModel::MergeToModel ()
+std::unique_ptr<CModel> CModel::createMergedModel(NMR::UniqueResourceIDMapping & oldToNewUniqueResourceIDs)
 {
-	// Create merged mesh
-	NMR::PMesh pMesh = std::make_shared<NMR::CMesh>();
-	model().mergeToMesh(pMesh.get());
-
 	auto pOutModel = std::unique_ptr<CModel>(new CModel());
 
 	// Copy relevant resources to new model
 	NMR::CModel& newModel = pOutModel->model();
 
-	NMR::UniqueResourceIDMapping oldToNewUniqueResourceIDs;
-
 	newModel.mergeModelAttachments(&model());
 	newModel.mergeTextures2D(&model(), oldToNewUniqueResourceIDs);
 	newModel.mergeBaseMaterials(&model(), oldToNewUniqueResourceIDs);
@@ -423,11 +478,24 @@ IModel * CModel::MergeToModel ()
 	newModel.mergeMultiPropertyGroups(&model(), oldToNewUniqueResourceIDs);
 	newModel.mergeMetaData(&model());
 
-	pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
-
 	newModel.setUnit(model().getUnit());
 	newModel.setLanguage(model().getLanguage());
 
+	return pOutModel;
+}
+
+IModel * CModel::MergeToModel ()
+{
+	// Create merged mesh
+	NMR::PMesh pMesh = std::make_shared<NMR::CMesh>();
+	model().mergeToMesh(pMesh.get());
+
+	NMR::UniqueResourceIDMapping oldToNewUniqueResourceIDs;
+	auto pOutModel = createMergedModel(oldToNewUniqueResourceIDs);
+	NMR::CModel& newModel = pOutModel->model();
+
+	pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
+
 	NMR::PModelMeshObject pMeshObject = std::make_shared<NMR::CModelMeshObject>(newModel.generateResourceID(), &newModel, pMesh);
 	newModel.addResource(pMeshObject);
 
@@ -437,6 +505,83 @@ IModel * CModel::MergeToModel ()
 	return pOutModel.release();
 }
 
+IModel * CModel::MergeToInstancedModel ()
+{
+	const std::vector<NMR::MODELMESHINSTANCE> & Instances = model().getMeshInstances();
+
+	NMR::UniqueResourceIDMapping oldToNewUniqueResourceIDs;
+	auto pOutModel = createMergedModel(oldToNewUniqueResourceIDs);
+	NMR::CModel& newModel = pOutModel->model();
+
+	// Copy each distinct mesh object once, in the order of its first instance
+	std::map<NMR::CModelMeshObject *, NMR::CModelMeshObject *> CopiedMeshObjects;
+	for (auto iInstance = Instances.begin(); iInstance != Instances.end(); iInstance++) {
+		NMR::CModelMeshObject * pCopiedObject = copyMeshObjectToMergedModel(newModel, iInstance->m_pMeshObject, CopiedMeshObjects, oldToNewUniqueResourceIDs);
+
+		NMR::PModelBuildItem pBuildItem = std::make_shared<NMR::CModelBuildItem>(pCopiedObject, iInstance->m_mTransform, newModel.createHandle());
+		newModel.addBuildItem(pBuildItem);
+	}
+
+	return pOutModel.release();
+}
+
+NMR::CModelMeshObject * CModel::copyMeshObjectToMergedModel(NMR::CModel & newModel, NMR::CModelMeshObject * pSourceObject,
+	std::map<NMR::CModelMeshObject *, NMR::CModelMeshObject *> & CopiedMeshObjects, NMR::UniqueResourceIDMapping & oldToNewUniqueResourceIDs)
+{
+	auto iCopied = CopiedMeshObjects.find(pSourceObject);
+	if (iCopied != CopiedMeshObjects.end())
+		return iCopied->second;
+	CopiedMeshObjects.insert(std::make_pair(pSourceObject, nullptr));
+
+	// Referenced meshes are added first, so that they are written before the object
+	NMR::PModelMeshBeamLatticeAttributes pSourceAttributes = pSourceObject->getBeamLatticeAttributes();
+	NMR::CModelMeshObject * pClippingMesh = nullptr;
+	if (pSourceAttributes->m_bHasClippingMeshID && pSourceAttributes->m_nClippingMeshID) {
+		NMR::CModelMeshObject * pSourceClippingMesh = dynamic_cast<NMR::CModelMeshObject *>(model().findObject(pSourceAttributes->m_nClippingMeshID->getUniqueID()));
+		if (pSourceClippingMesh)
+			pClippingMesh = copyMeshObjectToMergedModel(newModel, pSourceClippingMesh, CopiedMeshObjects, oldToNewUniqueResourceIDs);
+	}
+	NMR::CModelMeshObject * pRepresentationMesh = nullptr;
+	if (pSourceAttributes->m_bHasRepresentationMeshID && pSourceAttributes->m_nRepresentationID) {
+		NMR::CModelMeshObject * pSourceRepresentationMesh = dynamic_cast<NMR::CModelMeshObject *>(model().findObject(pSourceAttributes->m_nRepresentationID->getUniqueID()));
+		if (pSourceRepresentationMesh)
+			pRepresentationMesh = copyMeshObjectToMergedModel(newModel, pSourceRepresentationMesh, CopiedMeshObjects, oldToNewUniqueResourceIDs);
+	}
+
+	NMR::PMesh pMesh = std::make_shared<NMR::CMesh>(pSourceObject->getMesh());
+	pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
+
+	NMR::PModelMeshObject pMeshObject = std::make_shared<NMR::CModelMeshObject>(newModel.generateResourceID(), &newModel, pMesh);
+	pMeshObject->setName(pSourceObject->getName());
+	pMeshObject->setPartNumber(pSourceObject->getPartNumber());
+	pMeshObject->setObjectType(pSourceObject->getObjectType());
+	pMeshObject->setUUID(pSourceObject->uuid());
+	pMeshObject->metaDataGroup()->mergeMetaData(pSourceObject->metaDataGroup().get());
+
+	// Attachments have been copied with the same paths
+	NMR::PModelAttachment pThumbnail = pSourceObject->getThumbnailAttachment();
+	if (pThumbnail) {
+		NMR::PModelAttachment pCopiedThumbnail = newModel.findModelAttachment(pThumbnail->getPathURI());
+		if (pCopiedThumbnail)
+			pMeshObject->setThumbnailAttachment(pCopiedThumbnail, false);
+	}
+
+	NMR::PModelMeshBeamLatticeAttributes pAttributes = pMeshObject->getBeamLatticeAttributes();
+	pAttributes->m_eClipMode = pSourceAttributes->m_eClipMode;
+	if (pClippingMesh) {
+		pAttributes->m_bHasClippingMeshID = true;
+		pAttributes->m_nClippingMeshID = pClippingMesh->getResourceID();
+	}
+	if (pRepresentationMesh) {
+		pAttributes->m_bHasRepresentationMeshID = true;
+		pAttributes->m_nRepresentationID = pRepresentationMesh->getResourceID();
+	}
+
+	newModel.addResource(pMeshObject);
+	CopiedMeshObjects[pSourceObject] = pMeshObject.get();
+	return pMeshObject.get();
+}
+
 IMeshObject * CModel::AddMeshObject ()
 {
 	NMR::ModelResourceID NewResourceID = model().generateResourceID();
@@ -650,9 +795,9 @@ Lib3MF::sBox CModel::GetOutbox()
 	NMR::NOUTBOX3 sOutbox;
 	NMR::fnOutboxInitialize(sOutbox);
 
-	for (NMR::nfUint32 iBuildItem = 0; iBuildItem < model().getBuildItemCount(); iBuildItem++) {
-		auto pBuildItem = model().getBuildItem(iBuildItem);
-		pBuildItem->getObject()->extendOutbox(sOutbox, pBuildItem->getTransform());
+	const std::vector<NMR::MODELMESHINSTANCE> & Instances = model().getMeshInstances();
+	for (auto iInstance = Instances.begin(); iInstance != Instances.end(); iInstance++) {
+		iInstance->m_pMeshObject->extendOutbox(sOutbox, iInstance->m_mTransform);
 	}
 
 	sBox s;
@@ -63,6 +63,11 @@ Lib3MF_uint32 CResource::GetResourceID ()
 	return m_pResource->getResourceID()->getUniqueID();
 }
 
+Lib3MF_uint64 CResource::GetMemoryUsage ()
+{
+	return resource()->getMemoryUsage();
+}
+
 IObject * CResource::AsObject()
 {
 	if (dynamic_cast<NMR::CModelObject*>(m_pResource.get()))
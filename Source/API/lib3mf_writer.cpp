@@ -37,6 +37,7 @@ Abstract: This is a stub class definition of CWriter
 #include "Common/Platform/NMR_ExportStream_Callback.h"
 #include "Common/Platform/NMR_ExportStream_Memory.h"
 #include "Common/Platform/NMR_ExportStream_Dummy.h"
+#include "lib3mf_writeoperation.hpp"
 
 // for memcpy
 #include <cstring>
@@ -65,11 +66,32 @@ CWriter::CWriter(std::string sWriterClass, NMR::PModel model)
 
 NMR::CModelWriter& CWriter::writer()
 {
+	checkNoWriteInProgress();
 	return *m_pWriter;
 }
 
+void CWriter::checkNoWriteInProgress()
+{
+	if (m_pWriteOperation) {
+		if (!m_pWriteOperation->isFinished())
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_WRITEINPROGRESS);
+		m_pWriteOperation.reset();
+	}
+}
+
+NMR::CModelWriter_3MF_Native& CWriter::streamWriter()
+{
+	checkNoWriteInProgress();
+	NMR::CModelWriter_3MF_Native* pStreamWriter = dynamic_cast<NMR::CModelWriter_3MF_Native*>(m_pWriter.get());
+	if (pStreamWriter == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_NOTIMPLEMENTED);
+	return *pStreamWriter;
+}
+
 void CWriter::WriteToFile (const std::string & sFilename)
 {
+	checkNoWriteInProgress();
+
 	setlocale(LC_ALL, "C");
 	NMR::PExportStream pStream = NMR::fnCreateExportStreamInstance(sFilename.c_str());
 	try {
@@ -83,6 +105,17 @@ void CWriter::WriteToFile (const std::string & sFilename)
 	}
 }
 
+IWriteOperation * CWriter::WriteToFileAsync(const std::string & sFilename)
+{
+	checkNoWriteInProgress();
+
+	setlocale(LC_ALL, "C");
+	NMR::PExportStream pStream = NMR::fnCreateExportStreamInstance(sFilename.c_str());
+	m_pWriteOperation = std::make_shared<NMR::CModelWriteOperation>(m_pWriter, pStream);
+
+	return new CWriteOperation(m_pWriteOperation);
+}
+
 Lib3MF_uint64 CWriter::GetStreamSize ()
 {
 	// Write to a special dummy stream just to calculate the size
@@ -125,6 +158,9 @@ void CWriter::WriteToBuffer(Lib3MF_uint64 nBufferBufferSize, Lib3MF_uint64* pBuf
 
 void CWriter::WriteToCallback(const Lib3MFWriteCallback pTheWriteCallback, const Lib3MFSeekCallback pTheSeekCallback, const Lib3MF_pvoid pUserData)
 {
+	if (!pTheWriteCallback)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
 	NMR::ExportStream_WriteCallbackType lambdaWriteCallback =
 		[pTheWriteCallback](NMR::nfByte* pData, NMR::nfUint64 cbBytes, void* pUserData)
 	{
@@ -132,16 +168,97 @@ void CWriter::WriteToCallback(const Lib3MFWriteCallback pTheWriteCallback, const
 		return 0;
 	};
 
-	NMR::ExportStream_SeekCallbackType lambdaSeekCallback =
-		[pTheSeekCallback](NMR::nfUint64 nPosition, void* pUserData)
+	// Without a seek callback, the package is streamed forward-only using ZIP data descriptors
+	NMR::ExportStream_SeekCallbackType lambdaSeekCallback = nullptr;
+	if (pTheSeekCallback) {
+		lambdaSeekCallback =
+			[pTheSeekCallback](NMR::nfUint64 nPosition, void* pUserData)
+		{
+			(*pTheSeekCallback)(nPosition, pUserData);
+			return 0;
+		};
+	}
+
+	NMR::PExportStream pStream = std::make_shared<NMR::CExportStream_Callback>(lambdaWriteCallback, lambdaSeekCallback, pUserData);
+	try {
+		writer().exportToStream(pStream);
+	}
+	catch (NMR::CNMRException&e) {
+		if (e.getErrorCode() == NMR_USERABORTED) {
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_CALCULATIONABORTED);
+		}
+		else throw e;
+	}
+}
+
+void CWriter::beginStream(NMR::PExportStream pStream)
+{
+	try {
+		streamWriter().beginStream(pStream);
+	}
+	catch (NMR::CNMRException&e) {
+		if (e.getErrorCode() == NMR_USERABORTED) {
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_CALCULATIONABORTED);
+		}
+		else throw e;
+	}
+}
+
+void CWriter::BeginStreamToFile(const std::string & sFilename)
+{
+	setlocale(LC_ALL, "C");
+	// Do not truncate the target file of another active stream
+	if (streamWriter().isStreaming())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	beginStream(NMR::fnCreateExportStreamInstance(sFilename.c_str()));
+}
+
+void CWriter::BeginStreamToCallback(const Lib3MFWriteCallback pTheWriteCallback, const Lib3MFSeekCallback pTheSeekCallback, const Lib3MF_pvoid pUserData)
+{
+	if (!pTheWriteCallback)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::ExportStream_WriteCallbackType lambdaWriteCallback =
+		[pTheWriteCallback](NMR::nfByte* pData, NMR::nfUint64 cbBytes, void* pUserData)
 	{
-		(*pTheSeekCallback)(nPosition, pUserData);
+		(*pTheWriteCallback)(reinterpret_cast<Lib3MF_uint64>(pData), cbBytes, pUserData);
 		return 0;
 	};
 
-	NMR::PExportStream pStream = std::make_shared<NMR::CExportStream_Callback>(lambdaWriteCallback, lambdaSeekCallback, pUserData);
+	NMR::ExportStream_SeekCallbackType lambdaSeekCallback = nullptr;
+	if (pTheSeekCallback) {
+		lambdaSeekCallback =
+			[pTheSeekCallback](NMR::nfUint64 nPosition, void* pUserData)
+		{
+			(*pTheSeekCallback)(nPosition, pUserData);
+			return 0;
+		};
+	}
+
+	beginStream(std::make_shared<NMR::CExportStream_Callback>(lambdaWriteCallback, lambdaSeekCallback, pUserData));
+}
+
+void CWriter::AppendObject(IObject* pObjectResource)
+{
+	if (pObjectResource == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
 	try {
-		writer().exportToStream(pStream);
+		streamWriter().appendObject(pObjectResource->GetResourceID());
+	}
+	catch (NMR::CNMRException&e) {
+		if (e.getErrorCode() == NMR_USERABORTED) {
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_CALCULATIONABORTED);
+		}
+		else throw e;
+	}
+}
+
+void CWriter::FinishStream()
+{
+	try {
+		streamWriter().finishStream();
 	}
 	catch (NMR::CNMRException&e) {
 		if (e.getErrorCode() == NMR_USERABORTED) {
@@ -160,7 +277,7 @@ void CWriter::SetProgressCallback(const Lib3MFProgressCallback callback, const L
 			(*callback)(&ret, progressStep /100.0f, eLib3MFProgressIdentifier(identifier), pUserData);
 			return ret;
 		};
-	m_pWriter->SetProgressCallback(lambdaCallback, reinterpret_cast<void*>(pUserData));
+	writer().SetProgressCallback(lambdaCallback, reinterpret_cast<void*>(pUserData));
 }
 
 Lib3MF_uint32 CWriter::GetDecimalPrecision()
@@ -170,6 +287,46 @@ Lib3MF_uint32 CWriter::GetDecimalPrecision()
 
 void CWriter::SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision)
 {
-	m_pWriter->SetDecimalPrecision(nDecimalPrecision);
+	writer().SetDecimalPrecision(nDecimalPrecision);
+}
+
+bool CWriter::GetVertexCacheOptimization()
+{
+	return m_pWriter->GetVertexCacheOptimization();
+}
+
+void CWriter::SetVertexCacheOptimization(const bool bVertexCacheOptimization)
+{
+	writer().SetVertexCacheOptimization(bVertexCacheOptimization);
+}
+
+bool CWriter::GetMeshDeduplication()
+{
+	return m_pWriter->GetMeshDeduplication();
+}
+
+void CWriter::SetMeshDeduplication(const bool bMeshDeduplication)
+{
+	writer().SetMeshDeduplication(bMeshDeduplication);
+}
+
+bool CWriter::GetRigidMeshDeduplication()
+{
+	return m_pWriter->GetRigidMeshDeduplication();
+}
+
+void CWriter::SetRigidMeshDeduplication(const bool bRigidMeshDeduplication)
+{
+	writer().SetRigidMeshDeduplication(bRigidMeshDeduplication);
+}
+
+bool CWriter::GetReleaseStreamedMeshes()
+{
+	return m_pWriter->GetReleaseStreamedMeshes();
+}
+
+void CWriter::SetReleaseStreamedMeshes(const bool bReleaseStreamedMeshes)
+{
+	writer().SetReleaseStreamedMeshes(bReleaseStreamedMeshes);
 }
 
@@ -43,10 +43,18 @@ NMR::CProgressMonitor::CProgressMonitor()
 	m_dProgress = 0;
 	m_dProgressMax = 1;
 	m_eProgressIdentifier = ProgressIdentifier::PROGRESS_QUERYCANCELED;
+	m_bCancelRequested = false;
 }
 
 bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
 {
+	if (m_bCancelRequested)
+	{
+		if (throwIfCancelled)
+			throw CNMRException(NMR_USERABORTED);
+		return true;
+	}
+
 	if (m_progressCallback)
 	{
 		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
@@ -66,6 +74,13 @@ bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
 
 bool NMR::CProgressMonitor::ReportProgressAndQueryCancelled(bool throwIfCancelled)
 {
+	if (m_bCancelRequested)
+	{
+		if (throwIfCancelled)
+			throw CNMRException(NMR_USERABORTED);
+		return true;
+	}
+
 	if (m_progressCallback)
 	{
 		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
@@ -83,6 +98,16 @@ bool NMR::CProgressMonitor::ReportProgressAndQueryCancelled(bool throwIfCancelle
 	return false;
 }
 
+void NMR::CProgressMonitor::RequestCancel()
+{
+	m_bCancelRequested = true;
+}
+
+void NMR::CProgressMonitor::ClearCancelRequest()
+{
+	m_bCancelRequested = false;
+}
+
 bool NMR::CProgressMonitor::WasAborted()
 {
 	return (m_lastCallbackResult == false);
@@ -0,0 +1,389 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MatrixBatch.cpp implements transforms and normal calculations for arrays of
+vectors. Vectors are processed in blocks, which are transposed to one register per
+axis. The operations are the same and in the same order as in fnMATRIX3_apply and
+fnVEC3_calcTriangleNormal, without fused multiply-adds, so the results are identical.
+AVX is selected at runtime, SSE and NEON are part of the respective 64 bit architectures.
+
+--*/
+
+#include "Common/Math/NMR_MatrixBatch.h" 
+#include "Common/Math/NMR_Matrix.h" 
+#include "Common/Math/NMR_Vector.h" 
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NMR_MATRIXBATCH_SSE
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define NMR_MATRIXBATCH_AVXTARGET
+#else
+#define NMR_MATRIXBATCH_AVXTARGET __attribute__((target("avx")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NMR_MATRIXBATCH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace NMR {
+
+	static void fnMatrixBatch_ApplyScalar(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount)
+	{
+		for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+			pTarget[nIdx] = fnMATRIX3_apply(mMatrix, pSource[nIdx]);
+	}
+
+	static void fnMatrixBatch_NormalsScalar(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount)
+	{
+		for (size_t nIdx = 0; nIdx < nTriangleCount; nIdx++)
+			pNormals[nIdx] = fnVEC3_calcTriangleNormal(pVertices[3 * nIdx], pVertices[3 * nIdx + 1], pVertices[3 * nIdx + 2]);
+	}
+
+#ifdef NMR_MATRIXBATCH_SSE
+
+	// a, b and c hold four consecutive vectors (x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3). Returns their coordinates per axis.
+	static inline void fnMatrixBatch_DeinterleaveSSE(_In_ __m128 a, _In_ __m128 b, _In_ __m128 c, _Out_ __m128 & x, _Out_ __m128 & y, _Out_ __m128 & z)
+	{
+		x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 3, 0)), _MM_SHUFFLE(2, 1, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 3, 0)), _MM_SHUFFLE(1, 0, 2, 0));
+	}
+
+	// Inverse of fnMatrixBatch_DeinterleaveSSE
+	static inline void fnMatrixBatch_InterleaveSSE(_In_ __m128 x, _In_ __m128 y, _In_ __m128 z, _Out_ __m128 & a, _Out_ __m128 & b, _Out_ __m128 & c)
+	{
+		a = _mm_shuffle_ps(_mm_unpacklo_ps(x, y), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+		b = _mm_shuffle_ps(_mm_unpacklo_ps(y, z), _mm_unpackhi_ps(x, y), _MM_SHUFFLE(1, 0, 3, 2));
+		c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(0, 3, 0, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(0, 3, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	static void fnMatrixBatch_ApplySSE(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount)
+	{
+		__m128 m[3][4];
+		for (nfUint32 i = 0; i < 3; i++)
+			for (nfUint32 j = 0; j < 4; j++)
+				m[i][j] = _mm_set1_ps(mMatrix.m_fields[i][j]);
+
+		size_t nBlockCount = nCount / 4;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			const nfFloat * pIn = pSource[4 * nBlock].m_fields;
+			nfFloat * pOut = pTarget[4 * nBlock].m_fields;
+
+			__m128 v[3], r[3], o[3];
+			fnMatrixBatch_DeinterleaveSSE(_mm_loadu_ps(pIn), _mm_loadu_ps(pIn + 4), _mm_loadu_ps(pIn + 8), v[0], v[1], v[2]);
+			for (nfUint32 i = 0; i < 3; i++)
+				r[i] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m[i][0], v[0]), _mm_mul_ps(m[i][1], v[1])), _mm_mul_ps(m[i][2], v[2])), m[i][3]);
+			fnMatrixBatch_InterleaveSSE(r[0], r[1], r[2], o[0], o[1], o[2]);
+			_mm_storeu_ps(pOut, o[0]);
+			_mm_storeu_ps(pOut + 4, o[1]);
+			_mm_storeu_ps(pOut + 8, o[2]);
+		}
+
+		fnMatrixBatch_ApplyScalar(mMatrix, pSource + 4 * nBlockCount, pTarget + 4 * nBlockCount, nCount - 4 * nBlockCount);
+	}
+
+	static void fnMatrixBatch_NormalsSSE(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount)
+	{
+		__m128 vMinLength = _mm_set1_ps(NMR_VECTOR_MINNORMALIZELENGTH);
+		__m128 vOne = _mm_set1_ps(1.0f);
+
+		size_t nBlockCount = nTriangleCount / 4;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			const nfFloat * pIn = pVertices[12 * nBlock].m_fields;
+			nfFloat * pOut = pNormals[4 * nBlock].m_fields;
+
+			// Coordinates of the twelve corners, which are interleaved again with three corners per triangle
+			__m128 x[3], y[3], z[3], p[3][3];
+			for (nfUint32 k = 0; k < 3; k++)
+				fnMatrixBatch_DeinterleaveSSE(_mm_loadu_ps(pIn + 12 * k), _mm_loadu_ps(pIn + 12 * k + 4), _mm_loadu_ps(pIn + 12 * k + 8), x[k], y[k], z[k]);
+			fnMatrixBatch_DeinterleaveSSE(x[0], x[1], x[2], p[0][0], p[1][0], p[2][0]);
+			fnMatrixBatch_DeinterleaveSSE(y[0], y[1], y[2], p[0][1], p[1][1], p[2][1]);
+			fnMatrixBatch_DeinterleaveSSE(z[0], z[1], z[2], p[0][2], p[1][2], p[2][2]);
+
+			__m128 u[3], v[3], n[3], o[3];
+			for (nfUint32 j = 0; j < 3; j++) {
+				u[j] = _mm_sub_ps(p[1][j], p[0][j]);
+				v[j] = _mm_sub_ps(p[2][j], p[0][j]);
+			}
+			n[0] = _mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1]));
+			n[1] = _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2]));
+			n[2] = _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]));
+
+			__m128 vLength = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])), _mm_mul_ps(n[2], n[2])));
+			__m128 vValid = _mm_cmpgt_ps(vLength, vMinLength);
+			__m128 vFactor = _mm_div_ps(vOne, vLength);
+			for (nfUint32 j = 0; j < 3; j++)
+				n[j] = _mm_and_ps(_mm_mul_ps(n[j], vFactor), vValid);
+
+			fnMatrixBatch_InterleaveSSE(n[0], n[1], n[2], o[0], o[1], o[2]);
+			_mm_storeu_ps(pOut, o[0]);
+			_mm_storeu_ps(pOut + 4, o[1]);
+			_mm_storeu_ps(pOut + 8, o[2]);
+		}
+
+		fnMatrixBatch_NormalsScalar(pVertices + 12 * nBlockCount, pNormals + 4 * nBlockCount, nTriangleCount - 4 * nBlockCount);
+	}
+
+	// The AVX functions work on two blocks of four vectors at once, one in each 128 bit lane
+	static inline NMR_MATRIXBATCH_AVXTARGET __m256 fnMatrixBatch_LoadAVX(_In_ const nfFloat * pLow, _In_ const nfFloat * pHigh)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pLow)), _mm_loadu_ps(pHigh), 1);
+	}
+
+	static inline NMR_MATRIXBATCH_AVXTARGET void fnMatrixBatch_StoreAVX(_Out_ nfFloat * pLow, _Out_ nfFloat * pHigh, _In_ __m256 v)
+	{
+		_mm_storeu_ps(pLow, _mm256_castps256_ps128(v));
+		_mm_storeu_ps(pHigh, _mm256_extractf128_ps(v, 1));
+	}
+
+	static inline NMR_MATRIXBATCH_AVXTARGET void fnMatrixBatch_DeinterleaveAVX(_In_ __m256 a, _In_ __m256 b, _In_ __m256 c, _Out_ __m256 & x, _Out_ __m256 & y, _Out_ __m256 & z)
+	{
+		x = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 3, 0)), _MM_SHUFFLE(2, 1, 2, 0));
+		z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), _mm256_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 3, 0)), _MM_SHUFFLE(1, 0, 2, 0));
+	}
+
+	static inline NMR_MATRIXBATCH_AVXTARGET void fnMatrixBatch_InterleaveAVX(_In_ __m256 x, _In_ __m256 y, _In_ __m256 z, _Out_ __m256 & a, _Out_ __m256 & b, _Out_ __m256 & c)
+	{
+		a = _mm256_shuffle_ps(_mm256_unpacklo_ps(x, y), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+		b = _mm256_shuffle_ps(_mm256_unpacklo_ps(y, z), _mm256_unpackhi_ps(x, y), _MM_SHUFFLE(1, 0, 3, 2));
+		c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(0, 3, 0, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(0, 3, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	static NMR_MATRIXBATCH_AVXTARGET void fnMatrixBatch_ApplyAVX(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount)
+	{
+		__m256 m[3][4];
+		for (nfUint32 i = 0; i < 3; i++)
+			for (nfUint32 j = 0; j < 4; j++)
+				m[i][j] = _mm256_set1_ps(mMatrix.m_fields[i][j]);
+
+		size_t nBlockCount = nCount / 8;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			const nfFloat * pIn = pSource[8 * nBlock].m_fields;
+			nfFloat * pOut = pTarget[8 * nBlock].m_fields;
+
+			__m256 v[3], r[3], o[3];
+			fnMatrixBatch_DeinterleaveAVX(fnMatrixBatch_LoadAVX(pIn, pIn + 12), fnMatrixBatch_LoadAVX(pIn + 4, pIn + 16), fnMatrixBatch_LoadAVX(pIn + 8, pIn + 20), v[0], v[1], v[2]);
+			for (nfUint32 i = 0; i < 3; i++)
+				r[i] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[i][0], v[0]), _mm256_mul_ps(m[i][1], v[1])), _mm256_mul_ps(m[i][2], v[2])), m[i][3]);
+			fnMatrixBatch_InterleaveAVX(r[0], r[1], r[2], o[0], o[1], o[2]);
+			fnMatrixBatch_StoreAVX(pOut, pOut + 12, o[0]);
+			fnMatrixBatch_StoreAVX(pOut + 4, pOut + 16, o[1]);
+			fnMatrixBatch_StoreAVX(pOut + 8, pOut + 20, o[2]);
+		}
+
+		fnMatrixBatch_ApplySSE(mMatrix, pSource + 8 * nBlockCount, pTarget + 8 * nBlockCount, nCount - 8 * nBlockCount);
+	}
+
+	static NMR_MATRIXBATCH_AVXTARGET void fnMatrixBatch_NormalsAVX(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount)
+	{
+		__m256 vMinLength = _mm256_set1_ps(NMR_VECTOR_MINNORMALIZELENGTH);
+		__m256 vOne = _mm256_set1_ps(1.0f);
+
+		size_t nBlockCount = nTriangleCount / 8;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			const nfFloat * pIn = pVertices[24 * nBlock].m_fields;
+			nfFloat * pOut = pNormals[8 * nBlock].m_fields;
+
+			__m256 x[3], y[3], z[3], p[3][3];
+			for (nfUint32 k = 0; k < 3; k++)
+				fnMatrixBatch_DeinterleaveAVX(fnMatrixBatch_LoadAVX(pIn + 12 * k, pIn + 36 + 12 * k), fnMatrixBatch_LoadAVX(pIn + 12 * k + 4, pIn + 40 + 12 * k),
+					fnMatrixBatch_LoadAVX(pIn + 12 * k + 8, pIn + 44 + 12 * k), x[k], y[k], z[k]);
+			fnMatrixBatch_DeinterleaveAVX(x[0], x[1], x[2], p[0][0], p[1][0], p[2][0]);
+			fnMatrixBatch_DeinterleaveAVX(y[0], y[1], y[2], p[0][1], p[1][1], p[2][1]);
+			fnMatrixBatch_DeinterleaveAVX(z[0], z[1], z[2], p[0][2], p[1][2], p[2][2]);
+
+			__m256 u[3], v[3], n[3], o[3];
+			for (nfUint32 j = 0; j < 3; j++) {
+				u[j] = _mm256_sub_ps(p[1][j], p[0][j]);
+				v[j] = _mm256_sub_ps(p[2][j], p[0][j]);
+			}
+			n[0] = _mm256_sub_ps(_mm256_mul_ps(u[1], v[2]), _mm256_mul_ps(u[2], v[1]));
+			n[1] = _mm256_sub_ps(_mm256_mul_ps(u[2], v[0]), _mm256_mul_ps(u[0], v[2]));
+			n[2] = _mm256_sub_ps(_mm256_mul_ps(u[0], v[1]), _mm256_mul_ps(u[1], v[0]));
+
+			__m256 vLength = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n[0], n[0]), _mm256_mul_ps(n[1], n[1])), _mm256_mul_ps(n[2], n[2])));
+			__m256 vValid = _mm256_cmp_ps(vLength, vMinLength, _CMP_GT_OQ);
+			__m256 vFactor = _mm256_div_ps(vOne, vLength);
+			for (nfUint32 j = 0; j < 3; j++)
+				n[j] = _mm256_and_ps(_mm256_mul_ps(n[j], vFactor), vValid);
+
+			fnMatrixBatch_InterleaveAVX(n[0], n[1], n[2], o[0], o[1], o[2]);
+			fnMatrixBatch_StoreAVX(pOut, pOut + 12, o[0]);
+			fnMatrixBatch_StoreAVX(pOut + 4, pOut + 16, o[1]);
+			fnMatrixBatch_StoreAVX(pOut + 8, pOut + 20, o[2]);
+		}
+
+		fnMatrixBatch_NormalsSSE(pVertices + 24 * nBlockCount, pNormals + 8 * nBlockCount, nTriangleCount - 8 * nBlockCount);
+	}
+
+	// AVX needs support by the processor and by the operating system, which has to save the upper register halves
+	static nfBool fnMatrixBatch_DetectAVX()
+	{
+#ifdef _MSC_VER
+		int nCPUInfo[4];
+		__cpuid(nCPUInfo, 1);
+		nfBool bOSXSave = (nCPUInfo[2] & (1 << 27)) != 0;
+		nfBool bAVX = (nCPUInfo[2] & (1 << 28)) != 0;
+		return bOSXSave && bAVX && ((_xgetbv(0) & 6) == 6);
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx") != 0;
+#endif
+	}
+
+	static nfBool fnMatrixBatch_HasAVX()
+	{
+		static const nfBool bHasAVX = fnMatrixBatch_DetectAVX();
+		return bHasAVX;
+	}
+
+#endif // NMR_MATRIXBATCH_SSE
+
+#ifdef NMR_MATRIXBATCH_NEON
+
+	static void fnMatrixBatch_ApplyNEON(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount)
+	{
+		const nfFloat (*m)[4] = mMatrix.m_fields;
+		float32x4_t vTranslation[3];
+		for (nfUint32 i = 0; i < 3; i++)
+			vTranslation[i] = vdupq_n_f32(m[i][3]);
+
+		size_t nBlockCount = nCount / 4;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			float32x4x3_t v = vld3q_f32(pSource[4 * nBlock].m_fields);
+			float32x4x3_t r;
+			for (nfUint32 i = 0; i < 3; i++)
+				r.val[i] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], m[i][0]), vmulq_n_f32(v.val[1], m[i][1])), vmulq_n_f32(v.val[2], m[i][2])), vTranslation[i]);
+			vst3q_f32(pTarget[4 * nBlock].m_fields, r);
+		}
+
+		fnMatrixBatch_ApplyScalar(mMatrix, pSource + 4 * nBlockCount, pTarget + 4 * nBlockCount, nCount - 4 * nBlockCount);
+	}
+
+	static void fnMatrixBatch_NormalsNEON(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount)
+	{
+		float32x4_t vMinLength = vdupq_n_f32(NMR_VECTOR_MINNORMALIZELENGTH);
+		float32x4_t vOne = vdupq_n_f32(1.0f);
+
+		size_t nBlockCount = nTriangleCount / 4;
+		for (size_t nBlock = 0; nBlock < nBlockCount; nBlock++) {
+			const nfFloat * pIn = pVertices[12 * nBlock].m_fields;
+
+			// Coordinates of the twelve corners per axis, which are interleaved again with three corners per triangle
+			nfFloat fCoordinates[3][12];
+			for (nfUint32 k = 0; k < 3; k++) {
+				float32x4x3_t v = vld3q_f32(pIn + 12 * k);
+				for (nfUint32 j = 0; j < 3; j++)
+					vst1q_f32(&fCoordinates[j][4 * k], v.val[j]);
+			}
+			float32x4x3_t p[3];
+			for (nfUint32 j = 0; j < 3; j++)
+				p[j] = vld3q_f32(fCoordinates[j]);
+
+			float32x4_t u[3], v[3];
+			for (nfUint32 j = 0; j < 3; j++) {
+				u[j] = vsubq_f32(p[j].val[1], p[j].val[0]);
+				v[j] = vsubq_f32(p[j].val[2], p[j].val[0]);
+			}
+			float32x4x3_t n;
+			n.val[0] = vsubq_f32(vmulq_f32(u[1], v[2]), vmulq_f32(u[2], v[1]));
+			n.val[1] = vsubq_f32(vmulq_f32(u[2], v[0]), vmulq_f32(u[0], v[2]));
+			n.val[2] = vsubq_f32(vmulq_f32(u[0], v[1]), vmulq_f32(u[1], v[0]));
+
+			float32x4_t vLength = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(n.val[0], n.val[0]), vmulq_f32(n.val[1], n.val[1])), vmulq_f32(n.val[2], n.val[2])));
+			uint32x4_t vValid = vcgtq_f32(vLength, vMinLength);
+			float32x4_t vFactor = vdivq_f32(vOne, vLength);
+			for (nfUint32 j = 0; j < 3; j++)
+				n.val[j] = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(n.val[j], vFactor)), vValid));
+
+			vst3q_f32(pNormals[4 * nBlock].m_fields, n);
+		}
+
+		fnMatrixBatch_NormalsScalar(pVertices + 12 * nBlockCount, pNormals + 4 * nBlockCount, nTriangleCount - 4 * nBlockCount);
+	}
+
+#endif // NMR_MATRIXBATCH_NEON
+
+	void fnMATRIX3_applyBatch(_In_ const NMATRIX3 & mMatrix, _In_ const NVEC3 * pSource, _Out_ NVEC3 * pTarget, _In_ size_t nCount)
+	{
+		if (nCount == 0)
+			return;
+
+		const nfFloat (*m)[4] = mMatrix.m_fields;
+		nfBool bIsTranslation = true;
+		for (nfUint32 i = 0; i < 3; i++)
+			for (nfUint32 j = 0; j < 3; j++)
+				bIsTranslation &= (m[i][j] == ((i == j) ? 1.0f : 0.0f));
+
+		if (bIsTranslation) {
+			if ((m[0][3] == 0.0f) && (m[1][3] == 0.0f) && (m[2][3] == 0.0f)) {
+				if (pSource != pTarget)
+					memcpy(pTarget, pSource, nCount * sizeof(NVEC3));
+			}
+			else {
+				nfFloat fX = m[0][3], fY = m[1][3], fZ = m[2][3];
+				for (size_t nIdx = 0; nIdx < nCount; nIdx++) {
+					pTarget[nIdx].m_fields[0] = pSource[nIdx].m_fields[0] + fX;
+					pTarget[nIdx].m_fields[1] = pSource[nIdx].m_fields[1] + fY;
+					pTarget[nIdx].m_fields[2] = pSource[nIdx].m_fields[2] + fZ;
+				}
+			}
+			return;
+		}
+
+#if defined(NMR_MATRIXBATCH_SSE)
+		if (fnMatrixBatch_HasAVX())
+			fnMatrixBatch_ApplyAVX(mMatrix, pSource, pTarget, nCount);
+		else
+			fnMatrixBatch_ApplySSE(mMatrix, pSource, pTarget, nCount);
+#elif defined(NMR_MATRIXBATCH_NEON)
+		fnMatrixBatch_ApplyNEON(mMatrix, pSource, pTarget, nCount);
+#else
+		fnMatrixBatch_ApplyScalar(mMatrix, pSource, pTarget, nCount);
+#endif
+	}
+
+	void fnVEC3_calcTriangleNormalBatch(_In_ const NVEC3 * pVertices, _Out_ NVEC3 * pNormals, _In_ size_t nTriangleCount)
+	{
+#if defined(NMR_MATRIXBATCH_SSE)
+		if (fnMatrixBatch_HasAVX())
+			fnMatrixBatch_NormalsAVX(pVertices, pNormals, nTriangleCount);
+		else
+			fnMatrixBatch_NormalsSSE(pVertices, pNormals, nTriangleCount);
+#elif defined(NMR_MATRIXBATCH_NEON)
+		fnMatrixBatch_NormalsNEON(pVertices, pNormals, nTriangleCount);
+#else
+		fnMatrixBatch_NormalsScalar(pVertices, pNormals, nTriangleCount);
+#endif
+	}
+
+}
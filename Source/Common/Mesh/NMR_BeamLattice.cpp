@@ -34,7 +34,7 @@ NMR_MeshBeamLattice.h implements the class CMeshBeamLattice.
 
 namespace NMR {
 
-	CBeamLattice::CBeamLattice(_In_ MESHNODES &nodes) : m_Nodes(nodes)
+	CBeamLattice::CBeamLattice()
 	{ 
 		m_dMinLength = 0.0001;
 	}
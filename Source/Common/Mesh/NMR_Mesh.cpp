@@ -41,23 +41,91 @@ structure.
 
 #include "Common/Mesh/NMR_Mesh.h"
 #include "Common/Math/NMR_Matrix.h" 
+#include "Common/Math/NMR_MatrixBatch.h" 
 #include "Common/NMR_Exception.h" 
+#include "Common/NMR_Parallel.h" 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include <cmath>
+#include <algorithm>
+#include <cstring>
 
 namespace NMR {
 
-	CMesh::CMesh(): m_BeamLattice(this->m_Nodes)
+	CMesh::CMesh(): m_pNodes(std::make_shared<MESHNODES>()), m_pFaces(std::make_shared<MESHFACES>()), m_bQuantizedNodes(false),
+		m_Quantization(), m_bOutboxValid(false), m_bOutboxHasNaN(false), m_nModificationCount(0)
 	{
 		// empty on purpose
 	}
 
-	CMesh::CMesh(_In_opt_ CMesh * pMesh) : m_BeamLattice(this->m_Nodes)
+	CMesh::CMesh(_In_opt_ CMesh * pMesh) : m_pNodes(std::make_shared<MESHNODES>()), m_pFaces(std::make_shared<MESHFACES>()), m_bQuantizedNodes(false),
+		m_Quantization(), m_bOutboxValid(false), m_bOutboxHasNaN(false), m_nModificationCount(0)
 	{
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		mergeMesh(pMesh);
+		// Merging reports the errors of an invalid mesh
+		if (!pMesh->checkSanity()) {
+			mergeMesh(pMesh);
+			return;
+		}
+
+		// Share the geometry, which is validated already. Quantized nodes stay quantized.
+		m_pNodes = pMesh->m_pNodes;
+		m_pFaces = pMesh->m_pFaces;
+		m_bQuantizedNodes = pMesh->m_bQuantizedNodes;
+		m_pQuantizedNodes = pMesh->m_pQuantizedNodes;
+		m_Quantization = pMesh->m_Quantization;
+		m_bOutboxValid = pMesh->m_bOutboxValid;
+		m_bOutboxHasNaN = pMesh->m_bOutboxHasNaN;
+		m_Outbox = pMesh->m_Outbox;
+		m_nModificationCount++;
+
+		// Mesh information and beams are copied the same way as by mergeMesh
+		nfUint32 nFaceCount = getFaceCount();
+		CMeshInformationHandler * pOtherMeshInformationHandler = pMesh->getMeshInformationHandler();
+		if (pOtherMeshInformationHandler) {
+			createMeshInformationHandler();
+			m_pMeshInformationHandler->addInfoTableFrom(pOtherMeshInformationHandler, 0);
+			if (nFaceCount > 0) {
+				m_pMeshInformationHandler->cloneDefaultInfosFrom(pOtherMeshInformationHandler);
+				for (nfUint32 nIdx = 1; nIdx <= nFaceCount; nIdx++)
+					m_pMeshInformationHandler->addFace(nIdx);
+				m_pMeshInformationHandler->cloneFaceInfoRangeFrom(0, pOtherMeshInformationHandler, 0, nFaceCount);
+			}
+		}
+
+		const MESHBEAMS & Beams = pMesh->getReadOnlyBeams();
+		for (auto iBeamIterator = Beams.begin(); iBeamIterator != Beams.end(); iBeamIterator++) {
+			const MESHBEAM * pBeam = &(*iBeamIterator);
+			addBeam(pBeam->m_nodeindices[0], pBeam->m_nodeindices[1], pBeam->m_radius[0], pBeam->m_radius[1], pBeam->m_capMode[0], pBeam->m_capMode[1]);
+		}
+
+		// A copy keeps the settings and beam sets of the lattice
+		m_BeamLattice.m_dMinLength = pMesh->m_BeamLattice.m_dMinLength;
+		for (auto iBeamSetIterator = pMesh->m_BeamLattice.m_pBeamSets.begin(); iBeamSetIterator != pMesh->m_BeamLattice.m_pBeamSets.end(); iBeamSetIterator++)
+			m_BeamLattice.m_pBeamSets.push_back(std::make_shared<BEAMSET>(**iBeamSetIterator));
+	}
+
+	// Gives pStorage its own copy of shared storage, with room for at least nCapacity elements
+	template <typename T> static T & fnMesh_DetachStorage(_In_ std::shared_ptr<T> & pStorage, _In_ size_t nCapacity)
+	{
+		if (pStorage.use_count() > 1) {
+			std::shared_ptr<T> pCopy = std::make_shared<T>();
+			pCopy->reserve(std::max(nCapacity, pStorage->size()));
+			pCopy->assign(pStorage->begin(), pStorage->end());
+			pStorage = pCopy;
+		}
+		return *pStorage;
+	}
+
+	MESHNODES & CMesh::getWritableNodes()
+	{
+		return fnMesh_DetachStorage(m_pNodes, 0);
+	}
+
+	MESHFACES & CMesh::getWritableFaces()
+	{
+		return fnMesh_DetachStorage(m_pFaces, 0);
 	}
 
 	void CMesh::mergeMesh(_In_opt_ CMesh * pMesh)
@@ -70,67 +138,256 @@ namespace NMR {
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		nfInt32 nIdx, nNodeCount, nFaceCount, nBeamCount, j;
-		MESHNODE * pNode;
-		MESHFACE * pFace;
-		MESHBEAM * pBeam;
-		MESHNODE * pFaceNodes[3];
-		MESHNODE * pBeamNodes[2];
+		MESHMERGEINSTANCE Instance;
+		Instance.m_pMesh = pMesh;
+		Instance.m_mMatrix = mMatrix;
+		mergeMeshes(std::vector<MESHMERGEINSTANCE>(1, Instance));
+	}
 
-		// Copy Mesh Information
-		CMeshInformationHandler * pOtherMeshInformationHandler = pMesh->getMeshInformationHandler();
-		if (pOtherMeshInformationHandler) {
-			createMeshInformationHandler();
-			m_pMeshInformationHandler->addInfoTableFrom(pOtherMeshInformationHandler, getFaceCount ());
+	// Index of the first node in pNodes with a coordinate out of range, or nCount
+	static size_t fnMesh_FindInvalidNode(_In_ const MESHNODE * pNodes, _In_ size_t nCount)
+	{
+		nfBool bInvalid = false;
+		for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+			bInvalid |= (fabs(pNodes[nIdx].m_position.m_fields[0]) > NMR_MESH_MAXCOORDINATE) |
+				(fabs(pNodes[nIdx].m_position.m_fields[1]) > NMR_MESH_MAXCOORDINATE) |
+				(fabs(pNodes[nIdx].m_position.m_fields[2]) > NMR_MESH_MAXCOORDINATE);
+		if (!bInvalid)
+			return nCount;
+
+		for (size_t nIdx = 0; nIdx < nCount; nIdx++) {
+			for (nfUint32 j = 0; j < 3; j++)
+				if (fabs(pNodes[nIdx].m_position.m_fields[j]) > NMR_MESH_MAXCOORDINATE)
+					return nIdx;
 		}
+		return nCount;
+	}
 
-		nNodeCount = pMesh->getNodeCount();
-		nFaceCount = pMesh->getFaceCount();
-		nBeamCount = pMesh->getBeamCount();
+	// Calls fnWork(nInstance, nBegin, nEnd) for the parts of the instance ranges within [nBegin, nEnd).
+	// Offsets holds the start of each instance range and the total count as last entry.
+	template <typename F> static void fnMesh_ForEachInstanceRange(_In_ const std::vector<size_t> & Offsets, _In_ size_t nBegin, _In_ size_t nEnd, _In_ F fnWork)
+	{
+		size_t nInstance = std::upper_bound(Offsets.begin(), Offsets.end(), nBegin) - Offsets.begin() - 1;
+		size_t nIndex = nBegin;
+		while (nIndex < nEnd) {
+			size_t nInstanceEnd = std::min(Offsets[nInstance + 1], nEnd);
+			if (nInstanceEnd > nIndex)
+				fnWork(nInstance, nIndex, nInstanceEnd);
+			nIndex = nInstanceEnd;
+			nInstance++;
+		}
+	}
 
-		if (nNodeCount > 0) {
-			std::vector<MESHNODE *> aNewNodes;
-			aNewNodes.resize(nNodeCount);
+	void CMesh::mergeMeshes(_In_ const std::vector<MESHMERGEINSTANCE> & Instances, _In_ nfUint32 nThreadCount)
+	{
+		size_t nInstanceCount = Instances.size();
+		size_t nInstance;
+		for (nInstance = 0; nInstance < nInstanceCount; nInstance++)
+			if (!Instances[nInstance].m_pMesh)
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (nInstanceCount == 0)
+			return;
+
+		// Phase 1: Assign the output ranges of all instances. Faces and beams of meshes without nodes are skipped.
+		size_t nBaseNodeCount = getNodeCount();
+		size_t nBaseFaceCount = getFaceCount();
+		std::vector<size_t> NodeOffsets(nInstanceCount + 1, 0);
+		std::vector<size_t> FaceOffsets(nInstanceCount + 1, 0);
+		std::vector<nfUint32> BeamCounts(nInstanceCount, 0);
+		size_t nBeamCount = 0;
+		for (nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+			CMesh * pMesh = Instances[nInstance].m_pMesh;
+			nfUint32 nNodeCount = pMesh->getNodeCount();
+			NodeOffsets[nInstance + 1] = NodeOffsets[nInstance] + nNodeCount;
+			FaceOffsets[nInstance + 1] = FaceOffsets[nInstance] + ((nNodeCount > 0) ? pMesh->getFaceCount() : 0);
+			BeamCounts[nInstance] = (nNodeCount > 0) ? pMesh->getBeamCount() : 0;
+			nBeamCount += BeamCounts[nInstance];
+		}
 
-			for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
-				pNode = pMesh->getNode(nIdx);
-				NVEC3 vPosition = fnMATRIX3_apply(mMatrix, pNode->m_position);
-				aNewNodes[nIdx] = addNode(vPosition);
-			}
+		size_t nNewNodeCount = NodeOffsets[nInstanceCount];
+		size_t nNewFaceCount = FaceOffsets[nInstanceCount];
+		if (nBaseNodeCount + nNewNodeCount > NMR_MESH_MAXNODECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYNODES);
+		if (nBaseFaceCount + nNewFaceCount > NMR_MESH_MAXFACECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
+		if ((size_t)getBeamCount() + nBeamCount > NMR_MESH_MAXBEAMCOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYBEAMS);
 
-			if (nFaceCount > 0) {
-				if (m_pMeshInformationHandler && pOtherMeshInformationHandler) {
-					m_pMeshInformationHandler->cloneDefaultInfosFrom(pOtherMeshInformationHandler);
+		// Errors are reported for the first invalid instance, in the order nodes, faces, beams of that instance
+		size_t nErrorInstance = nInstanceCount;
+		nfError nErrorCode = 0;
+		for (nInstance = 0; (nInstance < nErrorInstance) && (nInstance < nInstanceCount); nInstance++) {
+			if (BeamCounts[nInstance] == 0)
+				continue;
+			nfInt32 nNodeCount = (nfInt32)(NodeOffsets[nInstance + 1] - NodeOffsets[nInstance]);
+			const MESHBEAMS & Beams = Instances[nInstance].m_pMesh->getReadOnlyBeams();
+			for (auto iBeamIterator = Beams.begin(); iBeamIterator != Beams.end(); iBeamIterator++) {
+				const nfInt32 * pNodeIndices = iBeamIterator->m_nodeindices;
+				if ((pNodeIndices[0] < 0) || (pNodeIndices[0] >= nNodeCount) || (pNodeIndices[1] < 0) || (pNodeIndices[1] >= nNodeCount))
+					nErrorCode = NMR_ERROR_INVALIDNODEINDEX;
+				else if (pNodeIndices[0] == pNodeIndices[1])
+					nErrorCode = NMR_ERROR_DUPLICATENODE;
+				if (nErrorCode != 0) {
+					nErrorInstance = nInstance;
+					break;
 				}
+			}
+		}
 
-				for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
-					pFace = pMesh->getFace(nIdx);
-					for (j = 0; j < 3; j++) {
-						if ((pFace->m_nodeindices[j] < 0) || (pFace->m_nodeindices[j] >= nNodeCount))
-							throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+		// Phase 2: Transform nodes and offset faces into preallocated storage, in parallel ranges across all instances
+		reserveNodes((nfUint32)(nBaseNodeCount + nNewNodeCount));
+		reserveFaces((nfUint32)(nBaseFaceCount + nNewFaceCount));
+		MESHNODES & Nodes = getWritableNodes();
+		MESHFACES & Faces = getWritableFaces();
+		Nodes.resize(nBaseNodeCount + nNewNodeCount);
+		Faces.resize(nBaseFaceCount + nNewFaceCount);
+
+		// Source pointers are taken after resizing, so that a mesh can be merged into itself
+		std::vector<const MESHNODE *> SourceNodes(nInstanceCount);
+		std::vector<const MESHFACE *> SourceFaces(nInstanceCount);
+		for (nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+			CMesh * pMesh = Instances[nInstance].m_pMesh;
+			SourceNodes[nInstance] = pMesh->hasQuantizedNodes() ? nullptr : pMesh->getReadOnlyNodes();
+			SourceFaces[nInstance] = (FaceOffsets[nInstance + 1] > FaceOffsets[nInstance]) ? pMesh->getReadOnlyFaces() : nullptr;
+		}
 
-						pFaceNodes[j] = aNewNodes[pFace->m_nodeindices[j]];
-					}
+		MESHNODE * pTargetNodes = Nodes.data() + nBaseNodeCount;
+		MESHFACE * pTargetFaces = Faces.data() + nBaseFaceCount;
+		nThreadCount = fnParallel_ThreadCount(nThreadCount, std::max(nNewNodeCount, nNewFaceCount), NMR_MESH_MINMERGEELEMENTSPERTHREAD);
+
+		std::vector<size_t> FirstInvalidNodes(nThreadCount, nNewNodeCount);
+		fnParallel_Run(nThreadCount, nNewNodeCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			fnMesh_ForEachInstanceRange(NodeOffsets, nBegin, nEnd, [&](size_t nRangeInstance, size_t nRangeBegin, size_t nRangeEnd) {
+				const MESHMERGEINSTANCE & Instance = Instances[nRangeInstance];
+				size_t nSourceIndex = nRangeBegin - NodeOffsets[nRangeInstance];
+				const NVEC3 * pSource = &pTargetNodes[nRangeBegin].m_position;
+				if (SourceNodes[nRangeInstance]) {
+					pSource = &SourceNodes[nRangeInstance][nSourceIndex].m_position;
+				}
+				else {
+					for (size_t nIdx = nRangeBegin; nIdx < nRangeEnd; nIdx++, nSourceIndex++)
+						pTargetNodes[nIdx].m_position = Instance.m_pMesh->getNodePosition((nfUint32)nSourceIndex);
+				}
+				fnMATRIX3_applyBatch(Instance.m_mMatrix, pSource, &pTargetNodes[nRangeBegin].m_position, nRangeEnd - nRangeBegin);
+			});
+
+			size_t nInvalid = fnMesh_FindInvalidNode(&pTargetNodes[nBegin], nEnd - nBegin);
+			if (nInvalid < nEnd - nBegin)
+				FirstInvalidNodes[nThread] = nBegin + nInvalid;
+		});
+
+		std::vector<size_t> FirstInvalidFaces(nThreadCount, nNewFaceCount);
+		std::vector<nfError> FaceErrorCodes(nThreadCount, 0);
+		fnParallel_Run(nThreadCount, nNewFaceCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			fnMesh_ForEachInstanceRange(FaceOffsets, nBegin, nEnd, [&](size_t nRangeInstance, size_t nRangeBegin, size_t nRangeEnd) {
+				const MESHFACE * pSource = &SourceFaces[nRangeInstance][nRangeBegin - FaceOffsets[nRangeInstance]];
+				MESHFACE * pTarget = &pTargetFaces[nRangeBegin];
+				nfInt32 nNodeCount = (nfInt32)(NodeOffsets[nRangeInstance + 1] - NodeOffsets[nRangeInstance]);
+				nfInt32 nNodeOffset = (nfInt32)(nBaseNodeCount + NodeOffsets[nRangeInstance]);
+				size_t nCount = nRangeEnd - nRangeBegin;
+
+				nfBool bInvalid = false;
+				for (size_t nIdx = 0; nIdx < nCount; nIdx++) {
+					const nfInt32 * pNodeIndices = pSource[nIdx].m_nodeindices;
+					bInvalid |= ((nfUint32)pNodeIndices[0] >= (nfUint32)nNodeCount) | ((nfUint32)pNodeIndices[1] >= (nfUint32)nNodeCount) | ((nfUint32)pNodeIndices[2] >= (nfUint32)nNodeCount) |
+						(pNodeIndices[0] == pNodeIndices[1]) | (pNodeIndices[0] == pNodeIndices[2]) | (pNodeIndices[1] == pNodeIndices[2]);
+					pTarget[nIdx].m_nodeindices[0] = pNodeIndices[0] + nNodeOffset;
+					pTarget[nIdx].m_nodeindices[1] = pNodeIndices[1] + nNodeOffset;
+					pTarget[nIdx].m_nodeindices[2] = pNodeIndices[2] + nNodeOffset;
+				}
 
-					MESHFACE * pNewFace = addFace(pFaceNodes[0], pFaceNodes[1], pFaceNodes[2]);
-					if (m_pMeshInformationHandler && pOtherMeshInformationHandler) {
-						m_pMeshInformationHandler->cloneFaceInfosFrom(pNewFace->m_index, pOtherMeshInformationHandler, pFace->m_index);
+				if (bInvalid && (FaceErrorCodes[nThread] == 0)) {
+					for (size_t nIdx = 0; nIdx < nCount; nIdx++) {
+						const nfInt32 * pNodeIndices = pSource[nIdx].m_nodeindices;
+						if (((nfUint32)pNodeIndices[0] >= (nfUint32)nNodeCount) || ((nfUint32)pNodeIndices[1] >= (nfUint32)nNodeCount) || ((nfUint32)pNodeIndices[2] >= (nfUint32)nNodeCount))
+							FaceErrorCodes[nThread] = NMR_ERROR_INVALIDNODEINDEX;
+						else if ((pNodeIndices[0] == pNodeIndices[1]) || (pNodeIndices[0] == pNodeIndices[2]) || (pNodeIndices[1] == pNodeIndices[2]))
+							FaceErrorCodes[nThread] = NMR_ERROR_DUPLICATENODE;
+						if (FaceErrorCodes[nThread] != 0) {
+							FirstInvalidFaces[nThread] = nRangeBegin + nIdx;
+							break;
+						}
 					}
 				}
+			});
+		});
+
+		// Thread ranges are ascending, so the first error of the lowest thread is the first error overall
+		for (nfUint32 nThread = 0; nThread < nThreadCount; nThread++) {
+			if (FirstInvalidNodes[nThread] < nNewNodeCount) {
+				nInstance = std::upper_bound(NodeOffsets.begin(), NodeOffsets.end(), FirstInvalidNodes[nThread]) - NodeOffsets.begin() - 1;
+				if (nInstance <= nErrorInstance) {
+					nErrorInstance = nInstance;
+					nErrorCode = NMR_ERROR_INVALIDCOORDINATES;
+				}
+				break;
 			}
-			if (nBeamCount > 0) {
-				for (nIdx = 0; nIdx < nBeamCount; nIdx++) {
-					pBeam = pMesh->getBeam(nIdx);
-					for (j = 0; j < 2; j++) {
-						if ((pBeam->m_nodeindices[j] < 0) || (pBeam->m_nodeindices[j] >= nNodeCount))
-							throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
-
-						pBeamNodes[j] = aNewNodes[pBeam->m_nodeindices[j]];
-					}
-					addBeam(pBeamNodes[0], pBeamNodes[1], pBeam->m_radius[0], pBeam->m_radius[1], pBeam->m_capMode[0], pBeam->m_capMode[1]);
+		}
+		for (nfUint32 nThread = 0; nThread < nThreadCount; nThread++) {
+			if (FaceErrorCodes[nThread] != 0) {
+				nInstance = std::upper_bound(FaceOffsets.begin(), FaceOffsets.end(), FirstInvalidFaces[nThread]) - FaceOffsets.begin() - 1;
+				if ((nInstance < nErrorInstance) || ((nInstance == nErrorInstance) && (nErrorCode != NMR_ERROR_INVALIDCOORDINATES))) {
+					nErrorInstance = nInstance;
+					nErrorCode = FaceErrorCodes[nThread];
+				}
+				break;
+			}
+		}
+
+		if (nErrorCode != 0) {
+			Nodes.resize(nBaseNodeCount);
+			Faces.resize(nBaseFaceCount);
+			throw CNMRException(nErrorCode);
+		}
+
+		// Register the new faces with the mesh information in instance order, which decides the
+		// information types present and the default information of the merged mesh
+		std::vector<CMeshInformationHandler *> SourceInformationHandlers(nInstanceCount, nullptr);
+		for (nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+			CMeshInformationHandler * pOtherMeshInformationHandler = Instances[nInstance].m_pMesh->getMeshInformationHandler();
+			nfUint32 nFirstFace = (nfUint32)(nBaseFaceCount + FaceOffsets[nInstance]);
+			nfUint32 nFaceCount = (nfUint32)(FaceOffsets[nInstance + 1] - FaceOffsets[nInstance]);
+			if (pOtherMeshInformationHandler) {
+				createMeshInformationHandler();
+				m_pMeshInformationHandler->addInfoTableFrom(pOtherMeshInformationHandler, nFirstFace);
+			}
+
+			if (m_pMeshInformationHandler && (nFaceCount > 0)) {
+				if (pOtherMeshInformationHandler) {
+					m_pMeshInformationHandler->cloneDefaultInfosFrom(pOtherMeshInformationHandler);
+					SourceInformationHandlers[nInstance] = pOtherMeshInformationHandler;
 				}
+				for (nfUint32 nIdx = 1; nIdx <= nFaceCount; nIdx++)
+					m_pMeshInformationHandler->addFace(nFirstFace + nIdx);
+			}
+		}
+
+		// Copy the face information of each instance as one range. This stays on the calling thread,
+		// since writing compressed face information changes storage shared by all faces.
+		if (m_pMeshInformationHandler) {
+			for (nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+				CMeshInformationHandler * pOtherMeshInformationHandler = SourceInformationHandlers[nInstance];
+				if (pOtherMeshInformationHandler)
+					m_pMeshInformationHandler->cloneFaceInfoRangeFrom((nfUint32)(nBaseFaceCount + FaceOffsets[nInstance]), pOtherMeshInformationHandler, 0,
+						(nfUint32)(FaceOffsets[nInstance + 1] - FaceOffsets[nInstance]));
 			}
+		}
 
+		m_nModificationCount++;
+		if (m_bOutboxValid)
+			mergeNodesIntoOutbox((nfUint32)nBaseNodeCount, (nfUint32)nNewNodeCount);
+
+		// Beams go to paged storage, which does not move existing blocks, so this also works when merging a mesh into itself
+		for (nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+			if (BeamCounts[nInstance] == 0)
+				continue;
+			nfInt32 nNodeOffset = (nfInt32)(nBaseNodeCount + NodeOffsets[nInstance]);
+			MESHBEAMS::const_iterator iBeamIterator = Instances[nInstance].m_pMesh->getReadOnlyBeams().begin();
+			for (nfUint32 nIdx = 0; nIdx < BeamCounts[nInstance]; nIdx++, iBeamIterator++) {
+				const MESHBEAM * pBeam = &(*iBeamIterator);
+				addBeam(pBeam->m_nodeindices[0] + nNodeOffset, pBeam->m_nodeindices[1] + nNodeOffset, pBeam->m_radius[0], pBeam->m_radius[1], pBeam->m_capMode[0], pBeam->m_capMode[1]);
+			}
 		}
 	}
 
@@ -150,9 +407,8 @@ namespace NMR {
 		pMesh->mergeMesh(this, mMatrix);
 	}
 
-	_Ret_notnull_ MESHNODE * CMesh::addNode(_In_ const NVEC3 vPosition)
+	nfUint32 CMesh::addNode(_In_ const NVEC3 vPosition)
 	{
-		MESHNODE * pNode;
 		nfUint32 j;
 
 		// Check Position Validity
@@ -166,17 +422,19 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_TOOMANYNODES);
 
 		// Allocate Data
-		nfUint32 nNewIndex;
-		pNode = m_Nodes.allocData(nNewIndex);
-		pNode->m_index = nNewIndex;
-		pNode->m_position = vPosition;
-
-		return pNode;
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+		MESHNODE Node;
+		Node.m_position = vPosition;
+		getWritableNodes().push_back(Node);
+		m_nModificationCount++;
+		if (m_bOutboxValid)
+			mergeNodesIntoOutbox(nNodeCount, 1);
+
+		return nNodeCount;
 	}
-	_Ret_notnull_ MESHNODE * CMesh::addNode(_In_ const nfFloat posX, _In_ const nfFloat posY, _In_ const nfFloat posZ)
+	nfUint32 CMesh::addNode(_In_ const nfFloat posX, _In_ const nfFloat posY, _In_ const nfFloat posZ)
 	{
-		MESHNODE * pNode;
-
 		// Check Position Validity
 		if (fabs(posX) > NMR_MESH_MAXCOORDINATE)
 			throw CNMRException(NMR_ERROR_INVALIDCOORDINATES);
@@ -191,77 +449,56 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_TOOMANYNODES);
 
 		// Allocate Data
-		nfUint32 nNewIndex;
-		pNode = m_Nodes.allocData(nNewIndex);
-		pNode->m_index = nNewIndex;
-		pNode->m_position.m_values.x = posX;
-		pNode->m_position.m_values.y = posY;
-		pNode->m_position.m_values.z = posZ;
-
-		return pNode;
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+		MESHNODE Node;
+		Node.m_position.m_values.x = posX;
+		Node.m_position.m_values.y = posY;
+		Node.m_position.m_values.z = posZ;
+		getWritableNodes().push_back(Node);
+		m_nModificationCount++;
+		if (m_bOutboxValid)
+			mergeNodesIntoOutbox(nNodeCount, 1);
+
+		return nNodeCount;
 	}
 
-	_Ret_notnull_ MESHFACE * CMesh::addFace(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ MESHNODE * pNode3)
+	nfUint32 CMesh::addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3)
 	{
-		if ((!pNode1) || (!pNode2) || (!pNode3))
-			throw CNMRException(NMR_ERROR_INVALIDPARAM);
-
-		if ((pNode1 == pNode2) || (pNode1 == pNode3) || (pNode2 == pNode3))
-			throw CNMRException(NMR_ERROR_DUPLICATENODE);
-
-		MESHFACE * pFace;
-		nfUint32 nFaceCount = getFaceCount ();
-
-		if (nFaceCount >= NMR_MESH_MAXFACECOUNT)
-			throw CNMRException(NMR_ERROR_TOOMANYFACES);
-
-		nfUint32 nNewIndex;
-
-		pFace = m_Faces.allocData (nNewIndex);
-		pFace->m_nodeindices[0] = pNode1->m_index;
-		pFace->m_nodeindices[1] = pNode2->m_index;
-		pFace->m_nodeindices[2] = pNode3->m_index;
-		pFace->m_index = nNewIndex;
-
-		if (m_pMeshInformationHandler)
-			m_pMeshInformationHandler->addFace(getFaceCount());
+		nfUint32 nNodeCount = getNodeCount();
+		if (((nfUint32)nNodeIndex1 >= nNodeCount) || ((nfUint32)nNodeIndex2 >= nNodeCount) || ((nfUint32)nNodeIndex3 >= nNodeCount))
+			throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
 
-		return pFace;
-	}
-	
-	_Ret_notnull_ MESHFACE * CMesh::addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3)
-	{
 		if ((nNodeIndex1 == nNodeIndex2) || (nNodeIndex1 == nNodeIndex3) || (nNodeIndex2 == nNodeIndex3))
 			throw CNMRException(NMR_ERROR_DUPLICATENODE);
 
-		MESHFACE * pFace;
 		nfUint32 nFaceCount = getFaceCount();
 
 		if (nFaceCount >= NMR_MESH_MAXFACECOUNT)
 			throw CNMRException(NMR_ERROR_TOOMANYFACES);
 
-		nfUint32 nNewIndex;
-
-		pFace = m_Faces.allocData(nNewIndex);
-		pFace->m_nodeindices[0] = nNodeIndex1;
-		pFace->m_nodeindices[1] = nNodeIndex2;
-		pFace->m_nodeindices[2] = nNodeIndex3;
-		pFace->m_index = nNewIndex;
+		MESHFACE Face;
+		Face.m_nodeindices[0] = nNodeIndex1;
+		Face.m_nodeindices[1] = nNodeIndex2;
+		Face.m_nodeindices[2] = nNodeIndex3;
+		getWritableFaces().push_back(Face);
+		m_nModificationCount++;
 
 		if (m_pMeshInformationHandler)
 			m_pMeshInformationHandler->addFace(getFaceCount());
 
-		return pFace;
+		return nFaceCount;
 	}
 
-	_Ret_notnull_ MESHBEAM * CMesh::addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2,
+	_Ret_notnull_ MESHBEAM * CMesh::addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2,
 		_In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
 		_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2)
 	{
-		if ((!pNode1) || (!pNode2))
-			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		nfUint32 nNodeCount = getNodeCount();
+		if (((nfUint32)nNodeIndex1 >= nNodeCount) || ((nfUint32)nNodeIndex2 >= nNodeCount))
+			throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
 
-		if (pNode1 == pNode2)
+		if (nNodeIndex1 == nNodeIndex2)
 			throw CNMRException(NMR_ERROR_DUPLICATENODE);
 
 		MESHBEAM * pBeam;
@@ -273,8 +510,9 @@ namespace NMR {
 		nfUint32 nNewIndex;
 
 		pBeam = m_BeamLattice.m_Beams.allocData(nNewIndex);
-		pBeam->m_nodeindices[0] = pNode1->m_index;
-		pBeam->m_nodeindices[1] = pNode2->m_index;
+		m_nModificationCount++;
+		pBeam->m_nodeindices[0] = nNodeIndex1;
+		pBeam->m_nodeindices[1] = nNodeIndex2;
 		pBeam->m_index = nNewIndex;
 		pBeam->m_radius[0] = dRadius1;
 		pBeam->m_radius[1] = dRadius2;
@@ -292,13 +530,107 @@ namespace NMR {
 	}
 
 
+	nfUint32 CMesh::addNodes(_In_ const nfFloat * pCoordinates, _In_ nfUint32 nNodeCount)
+	{
+		nfUint32 nFirstIndex = getNodeCount();
+		if (nNodeCount == 0)
+			return nFirstIndex;
+		if (!pCoordinates)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Check Node Quota
+		if ((nfUint64)nFirstIndex + nNodeCount > NMR_MESH_MAXNODECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYNODES);
+
+		// Check Position Validity without branching per coordinate
+		size_t nCoordinateCount = 3 * (size_t)nNodeCount;
+		nfBool bInvalid = false;
+		for (size_t nIdx = 0; nIdx < nCoordinateCount; nIdx++)
+			bInvalid |= (fabs(pCoordinates[nIdx]) > NMR_MESH_MAXCOORDINATE);
+		if (bInvalid)
+			throw CNMRException(NMR_ERROR_INVALIDCOORDINATES);
+
+		// Copy Data
+		reserveNodes(nFirstIndex + nNodeCount);
+		MESHNODES & Nodes = getWritableNodes();
+		Nodes.resize(nFirstIndex + nNodeCount);
+		memcpy(&Nodes[nFirstIndex], pCoordinates, nCoordinateCount * sizeof(nfFloat));
+		m_nModificationCount++;
+		if (m_bOutboxValid)
+			mergeNodesIntoOutbox(nFirstIndex, nNodeCount);
+
+		return nFirstIndex;
+	}
+
+	nfUint32 CMesh::addFaces(_In_ const nfUint32 * pNodeIndices, _In_ nfUint32 nFaceCount)
+	{
+		nfUint32 nFirstIndex = getFaceCount();
+		if (nFaceCount == 0)
+			return nFirstIndex;
+		if (!pNodeIndices)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Check Face Quota
+		if ((nfUint64)nFirstIndex + nFaceCount > NMR_MESH_MAXFACECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
+
+		// Check Index Validity
+		nfUint32 nNodeCount = getNodeCount();
+		nfBool bInvalidIndex = false;
+		nfBool bDuplicateIndex = false;
+		const nfUint32 * pFace = pNodeIndices;
+		for (nfUint32 nIdx = 0; nIdx < nFaceCount; nIdx++) {
+			bInvalidIndex |= (pFace[0] >= nNodeCount) | (pFace[1] >= nNodeCount) | (pFace[2] >= nNodeCount);
+			bDuplicateIndex |= (pFace[0] == pFace[1]) | (pFace[0] == pFace[2]) | (pFace[1] == pFace[2]);
+			pFace += 3;
+		}
+		if (bInvalidIndex)
+			throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+		if (bDuplicateIndex)
+			throw CNMRException(NMR_ERROR_DUPLICATENODE);
+
+		// Copy Data. Valid indices are below 2^31, so they have the same representation as signed integers.
+		reserveFaces(nFirstIndex + nFaceCount);
+		MESHFACES & Faces = getWritableFaces();
+		Faces.resize(nFirstIndex + nFaceCount);
+		memcpy(&Faces[nFirstIndex], pNodeIndices, 3 * (size_t)nFaceCount * sizeof(nfUint32));
+		m_nModificationCount++;
+
+		if (m_pMeshInformationHandler) {
+			for (nfUint32 nIdx = 1; nIdx <= nFaceCount; nIdx++)
+				m_pMeshInformationHandler->addFace(nFirstIndex + nIdx);
+		}
+
+		return nFirstIndex;
+	}
+
+	void CMesh::reserveNodes(_In_ nfUint32 nNodeCount)
+	{
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+
+		// Grow geometrically, so that repeated merges into one mesh stay linear
+		MESHNODES & Nodes = fnMesh_DetachStorage(m_pNodes, nNodeCount);
+		if (nNodeCount > Nodes.capacity())
+			Nodes.reserve(std::max((size_t)nNodeCount, 2 * Nodes.capacity()));
+	}
+
+	void CMesh::reserveFaces(_In_ nfUint32 nFaceCount)
+	{
+		MESHFACES & Faces = fnMesh_DetachStorage(m_pFaces, nFaceCount);
+		if (nFaceCount > Faces.capacity())
+			Faces.reserve(std::max((size_t)nFaceCount, 2 * Faces.capacity()));
+	}
+
 	nfUint32 CMesh::getNodeCount()	{
-		return m_Nodes.getCount ();
+		if (m_bQuantizedNodes)
+			return m_Quantization.m_nNodeCount;
+		return (nfUint32)m_pNodes->size ();
 	}
 
 	nfUint32 CMesh::getFaceCount()
 	{
-		return m_Faces.getCount ();
+		return (nfUint32)m_pFaces->size ();
 	}
 
 	nfUint32 CMesh::getBeamCount()
@@ -313,19 +645,241 @@ namespace NMR {
 
 	_Ret_notnull_ MESHNODE * CMesh::getNode(_In_ nfUint32 nIdx)
 	{
-		return m_Nodes.getData(nIdx);
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+		if (nIdx >= m_pNodes->size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		m_bOutboxValid = false;
+		m_nModificationCount++;
+		return &getWritableNodes()[nIdx];
 	}
 
 	_Ret_notnull_ MESHFACE * CMesh::getFace(_In_ nfUint32 nIdx)
 	{
-		return m_Faces.getData(nIdx);
+		if (nIdx >= m_pFaces->size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		m_nModificationCount++;
+		return &getWritableFaces()[nIdx];
+	}
+
+	_Ret_maybenull_ MESHNODE * CMesh::getNodes()
+	{
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+		m_bOutboxValid = false;
+		m_nModificationCount++;
+		return getWritableNodes().data();
+	}
+
+	_Ret_maybenull_ const MESHNODE * CMesh::getReadOnlyNodes()
+	{
+		// Quantized nodes are decoded on access and stay quantized
+		if (m_bQuantizedNodes)
+			return nullptr;
+		return m_pNodes->data();
+	}
+
+	NVEC3 CMesh::getNodePosition(_In_ nfUint32 nIdx)
+	{
+		if (!m_bQuantizedNodes) {
+			if (nIdx >= m_pNodes->size())
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+			return (*m_pNodes)[nIdx].m_position;
+		}
+
+		nfInt64 nValues[3];
+		getQuantizedNode(nIdx, nValues);
+
+		// The nearest float might be truncated to the step below by the model writer. In that case,
+		// the next float away from zero is used, so that dequantized nodes are written unchanged.
+		NVEC3 vPosition;
+		for (nfUint32 j = 0; j < 3; j++) {
+			nfFloat fValue = (nfFloat)((nfDouble)nValues[j] / (nfDouble)m_Quantization.m_nFactor);
+			if ((nfInt64)(fValue * m_Quantization.m_nFactor) != nValues[j])
+				fValue = nextafterf(fValue, (nValues[j] < 0) ? -NMR_MESH_MAXCOORDINATE : NMR_MESH_MAXCOORDINATE);
+			vPosition.m_fields[j] = fValue;
+		}
+		return vPosition;
+	}
+
+	nfBool CMesh::quantizeNodes(_In_ nfUint32 nDecimalPrecision)
+	{
+		if ((nDecimalPrecision < 1) || (nDecimalPrecision > NMR_MESH_QUANTIZATIONMAXPRECISION))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (m_bQuantizedNodes)
+			dequantizeNodes();
+
+		nfUint32 nNodeCount = getNodeCount();
+		nfUint32 nIdx, j;
+		if (nNodeCount == 0)
+			return false;
+
+		// Same conversion as the model writer, which truncates towards zero in float arithmetic
+		MESHNODEQUANTIZATION Quantization;
+		Quantization.m_nPrecision = nDecimalPrecision;
+		Quantization.m_nFactor = (nfInt32)(pow(10, nDecimalPrecision));
+		Quantization.m_nNodeCount = nNodeCount;
+		const MESHNODES & Nodes = *m_pNodes;
+		std::vector<nfInt64> Values(3 * (size_t)nNodeCount);
+		nfInt64 nMax[3] = { 0, 0, 0 };
+		for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
+			for (j = 0; j < 3; j++) {
+				nfInt64 nValue = (nfInt64)(Nodes[nIdx].m_position.m_fields[j] * Quantization.m_nFactor);
+				Values[3 * (size_t)nIdx + j] = nValue;
+				if ((nIdx == 0) || (nValue < Quantization.m_nOrigin[j]))
+					Quantization.m_nOrigin[j] = nValue;
+				if ((nIdx == 0) || (nValue > nMax[j]))
+					nMax[j] = nValue;
+			}
+		}
+
+		// The step of an axis is the greatest common divisor of all offsets from the origin,
+		// so that coarser grids take fewer bits and every value is still represented exactly
+		Quantization.m_nNodeBits = 0;
+		for (j = 0; j < 3; j++) {
+			nfUint64 nStep = 0;
+			for (nIdx = 0; (nIdx < nNodeCount) && (nStep != 1); nIdx++) {
+				nfUint64 nOffset = (nfUint64)(Values[3 * (size_t)nIdx + j] - Quantization.m_nOrigin[j]);
+				while (nOffset != 0) {
+					nfUint64 nRemainder = nStep % nOffset;
+					nStep = nOffset;
+					nOffset = nRemainder;
+				}
+			}
+			if (nStep == 0)
+				nStep = 1;
+
+			nfUint64 nMaxValue = (nfUint64)(nMax[j] - Quantization.m_nOrigin[j]) / nStep;
+			nfUint32 nBits = 0;
+			while ((nBits < 64) && ((nMaxValue >> nBits) != 0))
+				nBits++;
+			if (nBits > NMR_MESH_QUANTIZATIONMAXBITS)
+				return false;
+
+			Quantization.m_nStep[j] = (nfInt64)nStep;
+			Quantization.m_nBits[j] = nBits;
+			Quantization.m_nNodeBits += nBits;
+		}
+
+		// One extra word, so that a value can always be read from two consecutive words
+		size_t nWordCount = ((size_t)nNodeCount * Quantization.m_nNodeBits + 63) / 64 + 1;
+		std::shared_ptr<std::vector<nfUint64>> pQuantizedNodes = std::make_shared<std::vector<nfUint64>>(nWordCount, 0);
+		std::vector<nfUint64> & QuantizedNodes = *pQuantizedNodes;
+		nfUint64 nBitOffset = 0;
+		for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
+			for (j = 0; j < 3; j++) {
+				nfUint64 nValue = (nfUint64)(Values[3 * (size_t)nIdx + j] - Quantization.m_nOrigin[j]) / (nfUint64)Quantization.m_nStep[j];
+				size_t nWord = (size_t)(nBitOffset >> 6);
+				nfUint32 nShift = (nfUint32)(nBitOffset & 63);
+				QuantizedNodes[nWord] |= nValue << nShift;
+				if (nShift + Quantization.m_nBits[j] > 64)
+					QuantizedNodes[nWord + 1] |= nValue >> (64 - nShift);
+				nBitOffset += Quantization.m_nBits[j];
+			}
+		}
+
+		m_pQuantizedNodes = pQuantizedNodes;
+		m_Quantization = Quantization;
+		m_bQuantizedNodes = true;
+		m_bOutboxValid = false;
+		m_nModificationCount++;
+		m_pNodes = std::make_shared<MESHNODES>();
+
+		return true;
+	}
+
+	nfBool CMesh::hasQuantizedNodes()
+	{
+		return m_bQuantizedNodes;
+	}
+
+	nfUint32 CMesh::getQuantizationPrecision()
+	{
+		return m_bQuantizedNodes ? m_Quantization.m_nPrecision : 0;
+	}
+
+	void CMesh::getQuantizedNode(_In_ nfUint32 nIdx, _Out_ nfInt64 * pValues)
+	{
+		if (!pValues)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (!m_bQuantizedNodes)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (nIdx >= m_Quantization.m_nNodeCount)
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		const std::vector<nfUint64> & QuantizedNodes = *m_pQuantizedNodes;
+		nfUint64 nBitOffset = (nfUint64)nIdx * m_Quantization.m_nNodeBits;
+		for (nfUint32 j = 0; j < 3; j++) {
+			nfUint32 nBits = m_Quantization.m_nBits[j];
+			size_t nWord = (size_t)(nBitOffset >> 6);
+			nfUint32 nShift = (nfUint32)(nBitOffset & 63);
+			nfUint64 nValue = QuantizedNodes[nWord] >> nShift;
+			if (nShift + nBits > 64)
+				nValue |= QuantizedNodes[nWord + 1] << (64 - nShift);
+			nValue &= (((nfUint64)1) << nBits) - 1;
+
+			pValues[j] = m_Quantization.m_nOrigin[j] + (nfInt64)nValue * m_Quantization.m_nStep[j];
+			nBitOffset += nBits;
+		}
+	}
+
+	void CMesh::dequantizeNodes()
+	{
+		if (!m_bQuantizedNodes)
+			return;
+
+		nfUint32 nNodeCount = m_Quantization.m_nNodeCount;
+		std::shared_ptr<MESHNODES> pNodes = std::make_shared<MESHNODES>(nNodeCount);
+		MESHNODES & Nodes = *pNodes;
+		for (nfUint32 nIdx = 0; nIdx < nNodeCount; nIdx++)
+			Nodes[nIdx].m_position = getNodePosition(nIdx);
+
+		m_pNodes = pNodes;
+		m_pQuantizedNodes.reset();
+		m_bQuantizedNodes = false;
+	}
+
+	_Ret_maybenull_ MESHFACE * CMesh::getFaces()
+	{
+		m_nModificationCount++;
+		return getWritableFaces().data();
+	}
+
+	_Ret_maybenull_ const MESHFACE * CMesh::getReadOnlyFaces()
+	{
+		return m_pFaces->data();
+	}
+
+	_Ret_notnull_ const MESHFACE * CMesh::getReadOnlyFace(_In_ nfUint32 nIdx)
+	{
+		if (nIdx >= m_pFaces->size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return &(*m_pFaces)[nIdx];
+	}
+
+	nfUint64 CMesh::getModificationCount()
+	{
+		return m_nModificationCount;
 	}
 
 	_Ret_notnull_ MESHBEAM * CMesh::getBeam(_In_ nfUint32 nIdx)
 	{
+		m_nModificationCount++;
 		return m_BeamLattice.m_Beams.getData(nIdx);
 	}
 
+	MESHBEAMS & CMesh::getBeams()
+	{
+		m_nModificationCount++;
+		return m_BeamLattice.m_Beams;
+	}
+
+	const MESHBEAMS & CMesh::getReadOnlyBeams()
+	{
+		return m_BeamLattice.m_Beams;
+	}
+
 	_Ret_notnull_ PBEAMSET CMesh::getBeamSet(_In_ nfUint32 nIdx)
 	{
 		if (nIdx >= m_BeamLattice.m_pBeamSets.size())
@@ -375,17 +929,20 @@ namespace NMR {
 		if (nBeamCount > NMR_MESH_MAXBEAMCOUNT)
 			return false;
 
-		for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
-			MESHNODE * node = getNode(nIdx);
-			if (node->m_index != (nfInt32) nIdx)
-				return false;
-			for (j = 0; j < 3; j++)
-				if (fabs(node->m_position.m_fields[j]) > NMR_MESH_MAXCOORDINATE)
-					return false;
+		// Quantized positions are within the coordinate range by construction
+		if (!m_bQuantizedNodes) {
+			const MESHNODE * pNodes = getReadOnlyNodes();
+			for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
+				const MESHNODE * node = &pNodes[nIdx];
+				for (j = 0; j < 3; j++)
+					if (fabs(node->m_position.m_fields[j]) > NMR_MESH_MAXCOORDINATE)
+						return false;
+			}
 		}
 
+		const MESHFACE * pFaces = getReadOnlyFaces();
 		for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
-			MESHFACE * face = getFace(nIdx);
+			const MESHFACE * face = &pFaces[nIdx];
 			for (j = 0; j < 3; j++)
 				if ((face->m_nodeindices[j] < 0) || (((nfUint32)face->m_nodeindices[j]) >= nNodeCount))
 					return false;
@@ -396,8 +953,8 @@ namespace NMR {
 				return false;
 		}
 
-		for (nIdx = 0; nIdx < nBeamCount; nIdx++) {
-			MESHBEAM * beam = getBeam(nIdx);
+		for (auto iBeamIterator = m_BeamLattice.m_Beams.begin(); iBeamIterator != m_BeamLattice.m_Beams.end(); iBeamIterator++) {
+			MESHBEAM * beam = &(*iBeamIterator);
 			for (j = 0; j < 2; j++)
 				if ((beam->m_nodeindices[j] < 0) || (((nfUint32)beam->m_nodeindices[j]) >= nNodeCount))
 					return false;
@@ -411,13 +968,17 @@ namespace NMR {
 	void CMesh::clear()
 	{
 		m_pMeshInformationHandler.reset();
-		m_Faces.clearAllData();
-		m_Nodes.clearAllData();
+		m_pFaces = std::make_shared<MESHFACES>();
+		m_pNodes = std::make_shared<MESHNODES>();
+		m_pQuantizedNodes.reset();
+		m_bQuantizedNodes = false;
+		m_bOutboxValid = false;
 		clearBeamLattice();
 	}
 	
 	void CMesh::clearBeamLattice() {
 		m_BeamLattice.clear();
+		m_nModificationCount++;
 	}
 
 	void CMesh::clearMeshInformationHandler()
@@ -439,12 +1000,14 @@ namespace NMR {
 					pDefaultData->m_nResourceID = nNewResourceID;
 				}
 				for (NMR::nfUint32 nFaceIndex = 0; nFaceIndex < this->getFaceCount(); nFaceIndex++) {
-					NMR::MESHINFORMATION_PROPERTIES * pFaceData = (NMR::MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(nFaceIndex);
+					const NMR::MESHINFORMATION_PROPERTIES * pFaceData = (const NMR::MESHINFORMATION_PROPERTIES*)pProperties->readFaceData(nFaceIndex);
 					if (pFaceData && pFaceData->m_nResourceID != 0) {
 						NMR::PackageResourceID nNewResourceID = oldToNewMapping[pFaceData->m_nResourceID];
 						if (nNewResourceID == 0)
 							throw CNMRException(NMR_ERROR_UNKNOWNMODELRESOURCE);
-						pFaceData->m_nResourceID = nNewResourceID;
+						NMR::MESHINFORMATION_PROPERTIES FaceData = *pFaceData;
+						FaceData.m_nResourceID = nNewResourceID;
+						pProperties->setFaceData(nFaceIndex, (const NMR::MESHINFORMATIONFACEDATA*)&FaceData);
 					}
 				}
 			}
@@ -464,16 +1027,165 @@ namespace NMR {
 		return m_pMeshInformationHandler.get();
 	}
 
+	void CMesh::setMemoryArena(_In_opt_ PMemoryArena pMemoryArena)
+	{
+		m_pMemoryArena = pMemoryArena;
+
+		// Existing beam blocks stay on the heap
+		if (m_BeamLattice.m_Beams.getCount() == 0) {
+			m_BeamLattice.m_Beams.clearAllData();
+			m_BeamLattice.m_Beams.setMemoryArena(pMemoryArena);
+		}
+	}
+
+	PMemoryArena CMesh::getMemoryArena()
+	{
+		return m_pMemoryArena;
+	}
+
+	nfUint64 CMesh::getMemoryUsage()
+	{
+		std::set<const void *> CountedBuffers;
+		return getMemoryUsage(CountedBuffers);
+	}
+
+	nfUint64 CMesh::getMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers)
+	{
+		nfUint64 nMemoryUsage = 0;
+		if (CountedBuffers.insert(m_pNodes.get()).second)
+			nMemoryUsage += (nfUint64)m_pNodes->capacity() * sizeof(MESHNODE);
+		if (m_pQuantizedNodes && CountedBuffers.insert(m_pQuantizedNodes.get()).second)
+			nMemoryUsage += (nfUint64)m_pQuantizedNodes->capacity() * sizeof(nfUint64);
+		if (CountedBuffers.insert(m_pFaces.get()).second)
+			nMemoryUsage += (nfUint64)m_pFaces->capacity() * sizeof(MESHFACE);
+		nMemoryUsage += m_BeamLattice.m_Beams.getMemoryUsage();
+
+		for (auto iIterator = m_BeamLattice.m_pBeamSets.begin(); iIterator != m_BeamLattice.m_pBeamSets.end(); iIterator++) {
+			BEAMSET * pBeamSet = iIterator->get();
+			nMemoryUsage += sizeof(BEAMSET) + (nfUint64)pBeamSet->m_Refs.capacity() * sizeof(nfUint32);
+			nMemoryUsage += pBeamSet->m_sName.capacity() + pBeamSet->m_sIdentifier.capacity();
+		}
+
+		if (m_pMeshInformationHandler)
+			nMemoryUsage += m_pMeshInformationHandler->getMemoryUsage();
+
+		return nMemoryUsage;
+	}
+
+	nfBool CMesh::isSharingGeometry()
+	{
+		return (m_pNodes.use_count() > 1) || (m_pFaces.use_count() > 1) || (m_pQuantizedNodes.use_count() > 1);
+	}
+
+	void CMesh::mergeNodesIntoOutbox(_In_ nfUint32 nFirstIndex, _In_ nfUint32 nNodeCount)
+	{
+		nfFloat fMin[3], fMax[3];
+		nfBool bHasNaN = false;
+		nfUint32 j;
+		for (j = 0; j < 3; j++) {
+			fMin[j] = m_Outbox.m_min.m_fields[j];
+			fMax[j] = m_Outbox.m_max.m_fields[j];
+		}
+
+		if (m_bQuantizedNodes) {
+			for (nfUint32 nIdx = nFirstIndex; nIdx < nFirstIndex + nNodeCount; nIdx++) {
+				NVEC3 vPosition = getNodePosition(nIdx);
+				for (j = 0; j < 3; j++) {
+					fMin[j] = std::min(fMin[j], vPosition.m_fields[j]);
+					fMax[j] = std::max(fMax[j], vPosition.m_fields[j]);
+				}
+			}
+		}
+		else {
+			// Plain loop over the coordinate array without calls, which the compiler can vectorize
+			const nfFloat * pCoordinates = &(*m_pNodes)[nFirstIndex].m_position.m_fields[0];
+			for (nfUint32 nIdx = 0; nIdx < nNodeCount; nIdx++) {
+				for (j = 0; j < 3; j++) {
+					nfFloat fValue = pCoordinates[3 * (size_t)nIdx + j];
+					fMin[j] = std::min(fMin[j], fValue);
+					fMax[j] = std::max(fMax[j], fValue);
+					bHasNaN |= (fValue != fValue);
+				}
+			}
+		}
+
+		for (j = 0; j < 3; j++) {
+			m_Outbox.m_min.m_fields[j] = fMin[j];
+			m_Outbox.m_max.m_fields[j] = fMax[j];
+		}
+		m_bOutboxHasNaN |= bHasNaN;
+	}
+
+	void CMesh::calculateOutbox()
+	{
+		fnOutboxInitialize(m_Outbox);
+		m_bOutboxHasNaN = false;
+		mergeNodesIntoOutbox(0, getNodeCount());
+		m_bOutboxValid = true;
+	}
+
+	NOUTBOX3 CMesh::getOutbox()
+	{
+		if (!m_bOutboxValid)
+			calculateOutbox();
+		return m_Outbox;
+	}
+
 	void CMesh::extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix)
 	{
+		nfUint32 nNodeCount = getNodeCount();
+		if (nNodeCount == 0)
+			return;
+
+		NOUTBOX3 oOutbox = getOutbox();
+		if (!m_bOutboxHasNaN) {
+			if (fnMATRIX3_isIdentity(mAccumulatedMatrix)) {
+				fnOutboxMergeOutbox(vOutBox, oOutbox);
+				return;
+			}
+
+			// If every output coordinate depends on at most one input coordinate, the extreme nodes
+			// are mapped onto corners of the bounding box and transforming its corners is exact.
+			nfBool bMapsAxesOntoAxes = true;
+			for (nfUint32 i = 0; i < 3; i++) {
+				nfUint32 nNonZeroCount = 0;
+				for (nfUint32 j = 0; j < 3; j++)
+					if (mAccumulatedMatrix.m_fields[i][j] != 0.0f)
+						nNonZeroCount++;
+				bMapsAxesOntoAxes &= (nNonZeroCount <= 1);
+			}
+
+			if (bMapsAxesOntoAxes) {
+				for (nfUint32 nCorner = 0; nCorner < 8; nCorner++) {
+					NVEC3 vCorner;
+					for (nfUint32 j = 0; j < 3; j++)
+						vCorner.m_fields[j] = (nCorner & (1 << j)) ? oOutbox.m_max.m_fields[j] : oOutbox.m_min.m_fields[j];
+					fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, vCorner));
+				}
+				return;
+			}
+		}
+
+		if (m_bQuantizedNodes) {
+			for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+				fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, getNodePosition(iNode)));
+			}
+			return;
+		}
+
+		const MESHNODE * pNodes = getReadOnlyNodes();
 		if (fnMATRIX3_isIdentity(mAccumulatedMatrix)) {
-			for (nfUint32 iNode = 0; iNode < getNodeCount(); iNode++) {
-				fnOutboxMergeVector(vOutBox, getNode(iNode)->m_position);
+			for (nfUint32 iNode = 0; iNode < nNodeCount; iNode++) {
+				fnOutboxMergeVector(vOutBox, pNodes[iNode].m_position);
 			}
 		}
 		else {
-			for (nfUint32 iNode = 0; iNode < getNodeCount(); iNode++) {
-				fnOutboxMergeVector(vOutBox, fnMATRIX3_apply(mAccumulatedMatrix, getNode(iNode)->m_position));
+			NVEC3 vPositions[NMR_MESH_OUTBOXTRANSFORMBLOCKSIZE];
+			for (nfUint32 iNode = 0; iNode < nNodeCount; iNode += NMR_MESH_OUTBOXTRANSFORMBLOCKSIZE) {
+				nfUint32 nBlockCount = std::min(nNodeCount - iNode, (nfUint32)NMR_MESH_OUTBOXTRANSFORMBLOCKSIZE);
+				fnMATRIX3_applyBatch(mAccumulatedMatrix, &pNodes[iNode].m_position, vPositions, nBlockCount);
+				for (nfUint32 nIdx = 0; nIdx < nBlockCount; nIdx++)
+					fnOutboxMergeVector(vOutBox, vPositions[nIdx]);
 			}
 		}
 	}
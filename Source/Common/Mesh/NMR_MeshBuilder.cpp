@@ -92,34 +92,37 @@ namespace NMR {
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		std::vector<MESHNODE *> pNodes;
+		std::vector<nfUint32> nNodes;
 
 		nfUint32 nNodeCount = m_Nodes.getCount();
 		nfUint32 nFaceCount = m_Faces.getCount();
-		pNodes.resize(nNodeCount);
-
-		for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
-			NVEC3 * pPosition = m_Nodes.getData(nIdx);
-			pNodes[nIdx] = pMesh->addNode(*pPosition);
-		}
-
-		for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
-			NVEC3I * pFaceVec = m_Faces.getData(nIdx);		
-			MESHNODE * pNewNodes[3];
-
-			for (j = 0; j < 3; j++) {
-				pNewNodes[j] = pNodes[pFaceVec->m_fields[j]];
-			}
-
-			if ((pNewNodes[0] == pNewNodes[1]) || (pNewNodes[0] == pNewNodes[2]) || (pNewNodes[1] == pNewNodes[2])) {
-				if (!bIgnoreInvalidFaces)
-					throw CNMRException(NMR_ERROR_DUPLICATENODE);
-
-			}
-			else {
-				pMesh->addFace(pNewNodes[0], pNewNodes[1], pNewNodes[2]);
+		nNodes.resize(nNodeCount);
+		pMesh->reserveNodes(pMesh->getNodeCount() + nNodeCount);
+		pMesh->reserveFaces(pMesh->getFaceCount() + nFaceCount);
+
+		m_Nodes.forEachBlock([&](NVEC3 * pPositions, nfUint32 nCount, nfUint32 nStartIndex) {
+			for (nfUint32 nBlockIdx = 0; nBlockIdx < nCount; nBlockIdx++)
+				nNodes[nStartIndex + nBlockIdx] = pMesh->addNode(pPositions[nBlockIdx]);
+		});
+
+		m_Faces.forEachBlock([&](NVEC3I * pFaceVecs, nfUint32 nCount, nfUint32 nStartIndex) {
+			for (nIdx = 0; nIdx < nCount; nIdx++) {
+				nfUint32 nNewNodes[3];
+
+				for (j = 0; j < 3; j++) {
+					nNewNodes[j] = nNodes[pFaceVecs[nIdx].m_fields[j]];
+				}
+
+				if ((nNewNodes[0] == nNewNodes[1]) || (nNewNodes[0] == nNewNodes[2]) || (nNewNodes[1] == nNewNodes[2])) {
+					if (!bIgnoreInvalidFaces)
+						throw CNMRException(NMR_ERROR_DUPLICATENODE);
+
+				}
+				else {
+					pMesh->addFace(nNewNodes[0], nNewNodes[1], nNewNodes[2]);
+				}
 			}
-		}
+		});
 	}
 
 }
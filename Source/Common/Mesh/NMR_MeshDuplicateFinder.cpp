@@ -0,0 +1,390 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshDuplicateFinder.cpp implements the class CMeshDuplicateFinder.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshDuplicateFinder.h" 
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h" 
+#include "Common/NMR_Exception.h" 
+#include <cmath>
+#include <cstring>
+
+// Smallest distance of the second frame node from the axis through the first one, relative to the mesh extent
+#define NMR_MESHDUPLICATEFINDER_MINFRAMEEXTENT 1.0E-3
+
+namespace NMR {
+
+	static nfUint64 fnMeshDuplicateFinder_Mix(_In_ nfUint64 nHash, _In_ nfUint64 nValue)
+	{
+		nHash ^= nValue;
+		nHash *= 0x100000001B3ULL;
+		return nHash ^ (nHash >> 29);
+	}
+
+	static nfUint32 fnMeshDuplicateFinder_FloatBits(_In_ nfFloat fValue)
+	{
+		nfUint32 nBits;
+		memcpy(&nBits, &fValue, sizeof(nBits));
+		return nBits;
+	}
+
+	static CMeshInformation_Properties * fnMeshDuplicateFinder_GetProperties(_In_ CMesh * pMesh)
+	{
+		CMeshInformationHandler * pInformationHandler = pMesh->getMeshInformationHandler();
+		if (pInformationHandler == nullptr)
+			return nullptr;
+
+		return dynamic_cast<CMeshInformation_Properties *> (pInformationHandler->getInformationByType(0, emiProperties));
+	}
+
+	// Properties as they are written: data without a resource is ignored
+	static void fnMeshDuplicateFinder_GetPropertyValues(_In_opt_ const MESHINFORMATIONFACEDATA * pData, _Out_ nfUint32 * pValues)
+	{
+		const MESHINFORMATION_PROPERTIES * pProperties = (const MESHINFORMATION_PROPERTIES *)pData;
+		if ((pProperties != nullptr) && (pProperties->m_nResourceID != 0)) {
+			pValues[0] = pProperties->m_nResourceID;
+			for (nfUint32 j = 0; j < 3; j++)
+				pValues[j + 1] = pProperties->m_nPropertyIDs[j];
+		}
+		else {
+			for (nfUint32 j = 0; j < 4; j++)
+				pValues[j] = 0;
+		}
+	}
+
+	CMeshDuplicateFinder::CMeshDuplicateFinder(_In_ nfBool bRigidTransforms)
+		: m_bRigidTransforms(bRigidTransforms)
+	{
+	}
+
+	nfBool CMeshDuplicateFinder::addMesh(_In_ CMesh * pMesh, _In_ nfUint64 nCategory, _Out_ nfUint32 & nIndex, _Out_ NMATRIX3 & mMatrix)
+	{
+		if (pMesh == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		MESHDUPLICATEENTRY Entry;
+		Entry.m_pMesh = pMesh;
+		Entry.m_nCategory = nCategory;
+		Entry.m_bHasFrame = false;
+		Entry.m_nFrameNode1 = 0;
+		Entry.m_nFrameNode2 = 0;
+		Entry.m_dRadius = 0.0;
+		for (nfUint32 j = 0; j < 3; j++)
+			Entry.m_dCentroid[j] = 0.0;
+
+		nfUint64 nKey = calculateKey(Entry);
+
+		auto Range = m_Buckets.equal_range(nKey);
+		for (auto iIterator = Range.first; iIterator != Range.second; iIterator++) {
+			MESHDUPLICATEENTRY & Candidate = m_Entries[iIterator->second];
+			if ((Candidate.m_nCategory != nCategory) || !hasEqualTopology(Candidate.m_pMesh, pMesh))
+				continue;
+
+			if (hasEqualNodes(Candidate.m_pMesh, pMesh)) {
+				nIndex = iIterator->second;
+				mMatrix = fnMATRIX3_identity();
+				return true;
+			}
+
+			if (m_bRigidTransforms && findRigidTransform(Candidate, Entry, mMatrix)) {
+				nIndex = iIterator->second;
+				return true;
+			}
+		}
+
+		if (m_bRigidTransforms)
+			calculateFrameNodes(Entry);
+
+		nIndex = (nfUint32)m_Entries.size();
+		m_Entries.push_back(Entry);
+		m_Buckets.insert(std::make_pair(nKey, nIndex));
+		mMatrix = fnMATRIX3_identity();
+
+		return false;
+	}
+
+	nfUint32 CMeshDuplicateFinder::getMeshCount()
+	{
+		return (nfUint32)m_Entries.size();
+	}
+
+	_Ret_notnull_ CMesh * CMeshDuplicateFinder::getMesh(_In_ nfUint32 nIndex)
+	{
+		if (nIndex >= m_Entries.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		return m_Entries[nIndex].m_pMesh;
+	}
+
+	nfUint64 CMeshDuplicateFinder::calculateKey(_In_ MESHDUPLICATEENTRY & Entry)
+	{
+		CMesh * pMesh = Entry.m_pMesh;
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+
+		nfUint64 nKey = 0xCBF29CE484222325ULL;
+		nKey = fnMeshDuplicateFinder_Mix(nKey, Entry.m_nCategory);
+		nKey = fnMeshDuplicateFinder_Mix(nKey, nNodeCount);
+		nKey = fnMeshDuplicateFinder_Mix(nKey, nFaceCount);
+
+		const MESHFACE * pFaces = pMesh->getReadOnlyFaces();
+		for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			for (nfUint32 j = 0; j < 3; j++)
+				nKey = fnMeshDuplicateFinder_Mix(nKey, (nfUint32)pFaces[nFaceIndex].m_nodeindices[j]);
+		}
+
+		CMeshInformation_Properties * pProperties = fnMeshDuplicateFinder_GetProperties(pMesh);
+		if (pProperties != nullptr) {
+			nfUint32 nValues[4];
+			fnMeshDuplicateFinder_GetPropertyValues(pProperties->getDefaultData(), nValues);
+			for (nfUint32 j = 0; j < 4; j++)
+				nKey = fnMeshDuplicateFinder_Mix(nKey, nValues[j]);
+			for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+				fnMeshDuplicateFinder_GetPropertyValues(pProperties->readFaceData(nFaceIndex), nValues);
+				for (nfUint32 j = 0; j < 4; j++)
+					nKey = fnMeshDuplicateFinder_Mix(nKey, nValues[j]);
+			}
+		}
+
+		if (!m_bRigidTransforms) {
+			for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+				NVEC3 vPosition = pMesh->getNodePosition(nNodeIndex);
+				for (nfUint32 j = 0; j < 3; j++)
+					nKey = fnMeshDuplicateFinder_Mix(nKey, fnMeshDuplicateFinder_FloatBits(vPosition.m_fields[j]));
+			}
+			return nKey;
+		}
+
+		// Rigid transforms keep the distances of the nodes to their centroid
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			NVEC3 vPosition = pMesh->getNodePosition(nNodeIndex);
+			for (nfUint32 j = 0; j < 3; j++)
+				Entry.m_dCentroid[j] += vPosition.m_fields[j];
+		}
+		if (nNodeCount > 0) {
+			for (nfUint32 j = 0; j < 3; j++)
+				Entry.m_dCentroid[j] /= nNodeCount;
+		}
+
+		nfDouble dSquaredSum = 0.0;
+		nfDouble dMaxSquaredDistance = 0.0;
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			NVEC3 vPosition = pMesh->getNodePosition(nNodeIndex);
+			nfDouble dSquaredDistance = 0.0;
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfDouble dDelta = vPosition.m_fields[j] - Entry.m_dCentroid[j];
+				dSquaredDistance += dDelta * dDelta;
+			}
+			dSquaredSum += dSquaredDistance;
+			if (dSquaredDistance > dMaxSquaredDistance) {
+				dMaxSquaredDistance = dSquaredDistance;
+				Entry.m_nFrameNode1 = nNodeIndex;
+			}
+		}
+		Entry.m_dRadius = sqrt(dMaxSquaredDistance);
+
+		// Bucket the root mean square distance on a logarithmic scale. Meshes whose sizes
+		// straddle a step boundary are not matched, which is safe.
+		nfInt64 nSizeStep = 0;
+		if (dSquaredSum > 0.0)
+			nSizeStep = (nfInt64)floor(0.5 * log(dSquaredSum / nNodeCount) / log(1.0 + NMR_MESHDUPLICATEFINDER_SIZESTEP));
+		nKey = fnMeshDuplicateFinder_Mix(nKey, (nfUint64)nSizeStep);
+
+		return nKey;
+	}
+
+	void CMeshDuplicateFinder::calculateFrameNodes(_In_ MESHDUPLICATEENTRY & Entry)
+	{
+		CMesh * pMesh = Entry.m_pMesh;
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		if ((nNodeCount == 0) || (Entry.m_dRadius <= 0.0))
+			return;
+
+		// The first frame node is the node farthest from the centroid, the second one
+		// is the node farthest from the axis through the centroid and the first node
+		NVEC3 vFirst = pMesh->getNodePosition(Entry.m_nFrameNode1);
+		nfDouble dAxis[3];
+		for (nfUint32 j = 0; j < 3; j++)
+			dAxis[j] = (vFirst.m_fields[j] - Entry.m_dCentroid[j]) / Entry.m_dRadius;
+
+		nfDouble dMaxDistance = 0.0;
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			NVEC3 vPosition = pMesh->getNodePosition(nNodeIndex);
+			nfDouble dDelta[3];
+			for (nfUint32 j = 0; j < 3; j++)
+				dDelta[j] = vPosition.m_fields[j] - Entry.m_dCentroid[j];
+			nfDouble dCross[3] = {
+				dAxis[1] * dDelta[2] - dAxis[2] * dDelta[1],
+				dAxis[2] * dDelta[0] - dAxis[0] * dDelta[2],
+				dAxis[0] * dDelta[1] - dAxis[1] * dDelta[0] };
+			nfDouble dDistance = sqrt(dCross[0] * dCross[0] + dCross[1] * dCross[1] + dCross[2] * dCross[2]);
+			if (dDistance > dMaxDistance) {
+				dMaxDistance = dDistance;
+				Entry.m_nFrameNode2 = nNodeIndex;
+			}
+		}
+
+		Entry.m_bHasFrame = (dMaxDistance >= NMR_MESHDUPLICATEFINDER_MINFRAMEEXTENT * Entry.m_dRadius);
+	}
+
+	nfBool CMeshDuplicateFinder::hasEqualTopology(_In_ CMesh * pMesh1, _In_ CMesh * pMesh2)
+	{
+		nfUint32 nFaceCount = pMesh1->getFaceCount();
+		if ((pMesh1->getNodeCount() != pMesh2->getNodeCount()) || (nFaceCount != pMesh2->getFaceCount()))
+			return false;
+
+		if ((nFaceCount > 0) && (memcmp(pMesh1->getReadOnlyFaces(), pMesh2->getReadOnlyFaces(), nFaceCount * sizeof(MESHFACE)) != 0))
+			return false;
+
+		CMeshInformation_Properties * pProperties1 = fnMeshDuplicateFinder_GetProperties(pMesh1);
+		CMeshInformation_Properties * pProperties2 = fnMeshDuplicateFinder_GetProperties(pMesh2);
+		nfUint32 nValues1[4];
+		nfUint32 nValues2[4];
+
+		fnMeshDuplicateFinder_GetPropertyValues(pProperties1 ? pProperties1->getDefaultData() : nullptr, nValues1);
+		fnMeshDuplicateFinder_GetPropertyValues(pProperties2 ? pProperties2->getDefaultData() : nullptr, nValues2);
+		if (memcmp(nValues1, nValues2, sizeof(nValues1)) != 0)
+			return false;
+
+		if ((pProperties1 == nullptr) && (pProperties2 == nullptr))
+			return true;
+
+		for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			fnMeshDuplicateFinder_GetPropertyValues(pProperties1 ? pProperties1->readFaceData(nFaceIndex) : nullptr, nValues1);
+			fnMeshDuplicateFinder_GetPropertyValues(pProperties2 ? pProperties2->readFaceData(nFaceIndex) : nullptr, nValues2);
+			if (memcmp(nValues1, nValues2, sizeof(nValues1)) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	nfBool CMeshDuplicateFinder::hasEqualNodes(_In_ CMesh * pMesh1, _In_ CMesh * pMesh2)
+	{
+		nfUint32 nNodeCount = pMesh1->getNodeCount();
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			NVEC3 vPosition1 = pMesh1->getNodePosition(nNodeIndex);
+			NVEC3 vPosition2 = pMesh2->getNodePosition(nNodeIndex);
+			if (memcmp(&vPosition1, &vPosition2, sizeof(NVEC3)) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	nfBool CMeshDuplicateFinder::findRigidTransform(_In_ MESHDUPLICATEENTRY & Entry1, _In_ MESHDUPLICATEENTRY & Entry2, _Out_ NMATRIX3 & mMatrix)
+	{
+		// Pure translations are tried first, as they are exact in the rotational part
+		mMatrix = fnMATRIX3_identity();
+		for (nfUint32 j = 0; j < 3; j++)
+			mMatrix.m_fields[j][3] = (nfFloat)(Entry2.m_dCentroid[j] - Entry1.m_dCentroid[j]);
+		if (verifyTransform(Entry1, Entry2, mMatrix))
+			return true;
+
+		if (!Entry1.m_bHasFrame)
+			return false;
+
+		// Orthonormal frames spanned by the frame nodes of the first mesh, relative to the centroids
+		nfDouble dFrames[2][3][3];
+		MESHDUPLICATEENTRY * pEntries[2] = { &Entry1, &Entry2 };
+		for (nfUint32 nEntry = 0; nEntry < 2; nEntry++) {
+			NVEC3 vFirst = pEntries[nEntry]->m_pMesh->getNodePosition(Entry1.m_nFrameNode1);
+			NVEC3 vSecond = pEntries[nEntry]->m_pMesh->getNodePosition(Entry1.m_nFrameNode2);
+			nfDouble * dAxis1 = dFrames[nEntry][0];
+			nfDouble * dAxis2 = dFrames[nEntry][1];
+			nfDouble * dAxis3 = dFrames[nEntry][2];
+
+			for (nfUint32 j = 0; j < 3; j++) {
+				dAxis1[j] = vFirst.m_fields[j] - pEntries[nEntry]->m_dCentroid[j];
+				dAxis2[j] = vSecond.m_fields[j] - pEntries[nEntry]->m_dCentroid[j];
+			}
+
+			nfDouble dLength1 = sqrt(dAxis1[0] * dAxis1[0] + dAxis1[1] * dAxis1[1] + dAxis1[2] * dAxis1[2]);
+			if (dLength1 <= 0.0)
+				return false;
+			for (nfUint32 j = 0; j < 3; j++)
+				dAxis1[j] /= dLength1;
+
+			nfDouble dProjection = dAxis1[0] * dAxis2[0] + dAxis1[1] * dAxis2[1] + dAxis1[2] * dAxis2[2];
+			for (nfUint32 j = 0; j < 3; j++)
+				dAxis2[j] -= dProjection * dAxis1[j];
+			nfDouble dLength2 = sqrt(dAxis2[0] * dAxis2[0] + dAxis2[1] * dAxis2[1] + dAxis2[2] * dAxis2[2]);
+			if (dLength2 <= 0.0)
+				return false;
+			for (nfUint32 j = 0; j < 3; j++)
+				dAxis2[j] /= dLength2;
+
+			dAxis3[0] = dAxis1[1] * dAxis2[2] - dAxis1[2] * dAxis2[1];
+			dAxis3[1] = dAxis1[2] * dAxis2[0] - dAxis1[0] * dAxis2[2];
+			dAxis3[2] = dAxis1[0] * dAxis2[1] - dAxis1[1] * dAxis2[0];
+		}
+
+		// The rotation maps the frame of the first mesh onto the frame of the second mesh,
+		// the translation maps the centroids onto each other
+		for (nfUint32 i = 0; i < 3; i++) {
+			nfDouble dTranslation = Entry2.m_dCentroid[i];
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfDouble dValue = 0.0;
+				for (nfUint32 k = 0; k < 3; k++)
+					dValue += dFrames[1][k][i] * dFrames[0][k][j];
+				mMatrix.m_fields[i][j] = (nfFloat)dValue;
+				dTranslation -= dValue * Entry1.m_dCentroid[j];
+			}
+			mMatrix.m_fields[i][3] = (nfFloat)dTranslation;
+		}
+
+		return verifyTransform(Entry1, Entry2, mMatrix);
+	}
+
+	nfBool CMeshDuplicateFinder::verifyTransform(_In_ MESHDUPLICATEENTRY & Entry1, _In_ MESHDUPLICATEENTRY & Entry2, _Inout_ NMATRIX3 & mMatrix)
+	{
+		NMATRIX3 mWrittenMatrix = fnMATRIX3_fromString(fnMATRIX3_toString(mMatrix));
+
+		nfDouble dTolerance = NMR_MESHDUPLICATEFINDER_RELATIVETOLERANCE * Entry1.m_dRadius;
+		nfDouble dSquaredTolerance = dTolerance * dTolerance;
+
+		nfUint32 nNodeCount = Entry1.m_pMesh->getNodeCount();
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			NVEC3 vTransformed = fnMATRIX3_apply(mWrittenMatrix, Entry1.m_pMesh->getNodePosition(nNodeIndex));
+			NVEC3 vPosition = Entry2.m_pMesh->getNodePosition(nNodeIndex);
+			nfDouble dSquaredDistance = 0.0;
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfDouble dDelta = (nfDouble)vTransformed.m_fields[j] - vPosition.m_fields[j];
+				dSquaredDistance += dDelta * dDelta;
+			}
+			if (!(dSquaredDistance <= dSquaredTolerance))
+				return false;
+		}
+
+		mMatrix = mWrittenMatrix;
+		return true;
+	}
+
+}
@@ -0,0 +1,231 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshEdgeTable.cpp implements the class CMeshEdgeTable.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshEdgeTable.h" 
+#include "Common/NMR_Exception.h" 
+#include "Common/NMR_Parallel.h" 
+#include <algorithm>
+
+namespace NMR {
+
+	typedef struct {
+		nfUint64 m_nKey;
+		nfUint32 m_nCorner;
+		nfUint32 m_nAscending;
+	} MESHEDGETABLEENTRY;
+
+	static bool fnMeshEdgeTable_Less(_In_ const MESHEDGETABLEENTRY & Entry1, _In_ const MESHEDGETABLEENTRY & Entry2)
+	{
+		if (Entry1.m_nKey != Entry2.m_nKey)
+			return Entry1.m_nKey < Entry2.m_nKey;
+		return Entry1.m_nCorner < Entry2.m_nCorner;
+	}
+
+	CMeshEdgeTable::CMeshEdgeTable(_In_ CMesh * pMesh, _In_ nfUint32 nThreadCount)
+	{
+		if (pMesh == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Corners are addressed by 32 bit indices
+		if ((nfUint64)pMesh->getFaceCount() * 3 > 0xFFFFFFFFULL)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
+
+		nThreadCount = fnParallel_ThreadCount(nThreadCount, pMesh->getFaceCount(), NMR_MESHEDGETABLE_MINFACESPERTHREAD);
+
+		buildEdges(pMesh, nThreadCount);
+	}
+
+	void CMeshEdgeTable::buildEdges(_In_ CMesh * pMesh, _In_ nfUint32 nThreadCount)
+	{
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+		size_t nCornerCount = 3 * (size_t)nFaceCount;
+		const MESHFACE * pFaces = pMesh->getReadOnlyFaces();
+
+		// Collect the packed node pairs of all face corners
+		std::vector<MESHEDGETABLEENTRY> Entries(nCornerCount);
+		fnParallel_Run(nThreadCount, nFaceCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			for (size_t nFaceIndex = nBegin; nFaceIndex < nEnd; nFaceIndex++) {
+				for (nfUint32 j = 0; j < 3; j++) {
+					nfUint32 nNodeIndex1 = (nfUint32)pFaces[nFaceIndex].m_nodeindices[j];
+					nfUint32 nNodeIndex2 = (nfUint32)pFaces[nFaceIndex].m_nodeindices[(j + 1) % 3];
+					MESHEDGETABLEENTRY & Entry = Entries[3 * nFaceIndex + j];
+					Entry.m_nCorner = (nfUint32)(3 * nFaceIndex + j);
+					Entry.m_nAscending = (nNodeIndex1 < nNodeIndex2);
+					if (nNodeIndex1 < nNodeIndex2)
+						Entry.m_nKey = ((nfUint64)nNodeIndex1 << 32) | nNodeIndex2;
+					else
+						Entry.m_nKey = ((nfUint64)nNodeIndex2 << 32) | nNodeIndex1;
+				}
+			}
+		});
+
+		// Sort ranges in parallel and merge them pairwise. Corners are ordered within each edge,
+		// so the result does not depend on the number of threads.
+		std::vector<size_t> RangeStarts;
+		for (nfUint32 nThread = 0; nThread <= nThreadCount; nThread++)
+			RangeStarts.push_back(nCornerCount * nThread / nThreadCount);
+		fnParallel_Run(nThreadCount, nCornerCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			std::sort(Entries.begin() + RangeStarts[nThread], Entries.begin() + RangeStarts[nThread + 1], fnMeshEdgeTable_Less);
+		});
+		while (RangeStarts.size() > 2) {
+			nfUint32 nMergeCount = (nfUint32)(RangeStarts.size() - 1) / 2;
+			fnParallel_Run(nMergeCount, nMergeCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+				std::inplace_merge(Entries.begin() + RangeStarts[2 * nThread], Entries.begin() + RangeStarts[2 * nThread + 1],
+					Entries.begin() + RangeStarts[2 * nThread + 2], fnMeshEdgeTable_Less);
+			});
+			std::vector<size_t> MergedStarts;
+			for (size_t nIndex = 0; nIndex < RangeStarts.size(); nIndex += 2)
+				MergedStarts.push_back(RangeStarts[nIndex]);
+			if (MergedStarts.back() != nCornerCount)
+				MergedStarts.push_back(nCornerCount);
+			RangeStarts.swap(MergedStarts);
+		}
+
+		// Split the sorted corners at edge boundaries and count the edges of each range
+		std::vector<size_t> Boundaries(nThreadCount + 1);
+		for (nfUint32 nThread = 0; nThread <= nThreadCount; nThread++) {
+			size_t nIndex = nCornerCount * nThread / nThreadCount;
+			while ((nIndex > 0) && (nIndex < nCornerCount) && (Entries[nIndex].m_nKey == Entries[nIndex - 1].m_nKey))
+				nIndex++;
+			Boundaries[nThread] = nIndex;
+		}
+		std::vector<size_t> EdgeOffsets(nThreadCount + 1, 0);
+		fnParallel_Run(nThreadCount, nThreadCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			size_t nEdgeCount = 0;
+			for (size_t nIndex = Boundaries[nThread]; nIndex < Boundaries[nThread + 1]; nIndex++)
+				if ((nIndex == 0) || (Entries[nIndex].m_nKey != Entries[nIndex - 1].m_nKey))
+					nEdgeCount++;
+			EdgeOffsets[nThread + 1] = nEdgeCount;
+		});
+		for (nfUint32 nThread = 0; nThread < nThreadCount; nThread++)
+			EdgeOffsets[nThread + 1] += EdgeOffsets[nThread];
+
+		size_t nEdgeCount = EdgeOffsets[nThreadCount];
+		if (nEdgeCount > NMR_MESH_MAXEDGECOUNT)
+			throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
+
+		// Fill the tables and count the orientations of each edge
+		m_FaceEdges.resize(nCornerCount);
+		m_EdgeCorners.resize(nCornerCount);
+		m_EdgeStarts.resize(nEdgeCount + 1);
+		m_EdgeKeys.resize(nEdgeCount);
+		m_AscendingCounts.assign(nEdgeCount, 0);
+		m_DescendingCounts.assign(nEdgeCount, 0);
+		fnParallel_Run(nThreadCount, nThreadCount, [&](nfUint32 nThread, size_t nBegin, size_t nEnd) {
+			size_t nEdgeIndex = EdgeOffsets[nThread];
+			for (size_t nIndex = Boundaries[nThread]; nIndex < Boundaries[nThread + 1]; nIndex++) {
+				const MESHEDGETABLEENTRY & Entry = Entries[nIndex];
+				if ((nIndex == 0) || (Entry.m_nKey != Entries[nIndex - 1].m_nKey)) {
+					if (nIndex > Boundaries[nThread])
+						nEdgeIndex++;
+					m_EdgeStarts[nEdgeIndex] = (nfUint32)nIndex;
+					m_EdgeKeys[nEdgeIndex] = Entry.m_nKey;
+				}
+
+				m_EdgeCorners[nIndex] = Entry.m_nCorner;
+				m_FaceEdges[Entry.m_nCorner] = (nfUint32)nEdgeIndex;
+				if (Entry.m_nAscending)
+					m_AscendingCounts[nEdgeIndex]++;
+				else
+					m_DescendingCounts[nEdgeIndex]++;
+			}
+		});
+		m_EdgeStarts[nEdgeCount] = (nfUint32)nCornerCount;
+	}
+
+	nfUint32 CMeshEdgeTable::getEdgeCount()
+	{
+		return (nfUint32)m_EdgeKeys.size();
+	}
+
+	void CMeshEdgeTable::getEdgeNodes(_In_ nfUint32 nEdgeIndex, _Out_ nfUint32 & nNodeIndex1, _Out_ nfUint32 & nNodeIndex2)
+	{
+		if (nEdgeIndex >= m_EdgeKeys.size())
+			throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
+		nNodeIndex1 = (nfUint32)(m_EdgeKeys[nEdgeIndex] >> 32);
+		nNodeIndex2 = (nfUint32)(m_EdgeKeys[nEdgeIndex] & 0xFFFFFFFF);
+	}
+
+	nfUint32 CMeshEdgeTable::getFaceEdge(_In_ nfUint32 nFaceIndex, _In_ nfUint32 nCorner)
+	{
+		if ((nCorner >= 3) || (3 * (size_t)nFaceIndex + nCorner >= m_FaceEdges.size()))
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return m_FaceEdges[3 * (size_t)nFaceIndex + nCorner];
+	}
+
+	nfUint32 CMeshEdgeTable::getEdgeFaceCount(_In_ nfUint32 nEdgeIndex)
+	{
+		if (nEdgeIndex >= m_EdgeKeys.size())
+			throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
+		return m_EdgeStarts[nEdgeIndex + 1] - m_EdgeStarts[nEdgeIndex];
+	}
+
+	nfUint32 CMeshEdgeTable::getEdgeFace(_In_ nfUint32 nEdgeIndex, _In_ nfUint32 nIndex)
+	{
+		if (nIndex >= getEdgeFaceCount(nEdgeIndex))
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return m_EdgeCorners[m_EdgeStarts[nEdgeIndex] + nIndex] / 3;
+	}
+
+	nfUint32 CMeshEdgeTable::getAscendingCount(_In_ nfUint32 nEdgeIndex)
+	{
+		if (nEdgeIndex >= m_EdgeKeys.size())
+			throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
+		return m_AscendingCounts[nEdgeIndex];
+	}
+
+	nfUint32 CMeshEdgeTable::getDescendingCount(_In_ nfUint32 nEdgeIndex)
+	{
+		if (nEdgeIndex >= m_EdgeKeys.size())
+			throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
+		return m_DescendingCounts[nEdgeIndex];
+	}
+
+	nfBool CMeshEdgeTable::isManifoldAndOriented()
+	{
+		size_t nEdgeCount = m_EdgeKeys.size();
+		for (size_t nEdgeIndex = 0; nEdgeIndex < nEdgeCount; nEdgeIndex++) {
+			if ((m_AscendingCounts[nEdgeIndex] != 1) || (m_DescendingCounts[nEdgeIndex] != 1))
+				return false;
+		}
+		return true;
+	}
+
+	nfUint64 CMeshEdgeTable::getMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = (nfUint64)(m_FaceEdges.capacity() + m_EdgeCorners.capacity() + m_EdgeStarts.capacity()) * sizeof(nfUint32);
+		nMemoryUsage += (nfUint64)m_EdgeKeys.capacity() * sizeof(nfUint64);
+		nMemoryUsage += (nfUint64)(m_AscendingCounts.capacity() + m_DescendingCounts.capacity()) * sizeof(nfUint32);
+		return nMemoryUsage;
+	}
+
+}
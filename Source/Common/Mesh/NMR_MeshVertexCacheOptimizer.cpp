@@ -0,0 +1,279 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshVertexCacheOptimizer.cpp implements the class CMeshVertexCacheOptimizer.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshVertexCacheOptimizer.h" 
+#include "Common/NMR_Exception.h" 
+#include <cmath>
+
+#define NMR_VERTEXCACHE_DECAYPOWER 1.5f
+#define NMR_VERTEXCACHE_LASTFACESCORE 0.75f
+#define NMR_VERTEXCACHE_VALENCEBOOSTSCALE 2.0f
+#define NMR_VERTEXCACHE_VALENCEBOOSTPOWER 0.5f
+
+namespace NMR {
+
+	CMeshVertexCacheOptimizer::CMeshVertexCacheOptimizer(_In_ CMesh * pMesh)
+	{
+		if (pMesh == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nIndex;
+		for (nIndex = 0; nIndex < NMR_VERTEXCACHE_SIZE; nIndex++) {
+			if (nIndex < 3) {
+				// The vertices of the last face get a fixed score, to not favour any of them
+				m_CachePositionScores[nIndex] = NMR_VERTEXCACHE_LASTFACESCORE;
+			}
+			else {
+				nfFloat fScale = 1.0f / (NMR_VERTEXCACHE_SIZE - 3);
+				m_CachePositionScores[nIndex] = powf(1.0f - (nIndex - 3) * fScale, NMR_VERTEXCACHE_DECAYPOWER);
+			}
+		}
+		m_ValenceScores[0] = 0.0f;
+		for (nIndex = 1; nIndex < NMR_VERTEXCACHE_MAXVALENCESCORE; nIndex++)
+			m_ValenceScores[nIndex] = NMR_VERTEXCACHE_VALENCEBOOSTSCALE * powf((nfFloat)nIndex, -NMR_VERTEXCACHE_VALENCEBOOSTPOWER);
+
+		orderFaces(pMesh);
+		orderNodes(pMesh);
+	}
+
+	nfFloat CMeshVertexCacheOptimizer::calculateVertexScore(_In_ nfInt32 nCachePosition, _In_ nfUint32 nRemainingValence)
+	{
+		// Vertices without remaining faces are of no interest
+		if (nRemainingValence == 0)
+			return -1.0f;
+
+		nfFloat fScore = 0.0f;
+		if ((nCachePosition >= 0) && (nCachePosition < NMR_VERTEXCACHE_SIZE))
+			fScore = m_CachePositionScores[nCachePosition];
+
+		// Boost vertices with few remaining faces, to finish them off
+		if (nRemainingValence < NMR_VERTEXCACHE_MAXVALENCESCORE)
+			fScore += m_ValenceScores[nRemainingValence];
+		else
+			fScore += NMR_VERTEXCACHE_VALENCEBOOSTSCALE * powf((nfFloat)nRemainingValence, -NMR_VERTEXCACHE_VALENCEBOOSTPOWER);
+
+		return fScore;
+	}
+
+	void CMeshVertexCacheOptimizer::orderFaces(_In_ CMesh * pMesh)
+	{
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+		nfUint32 nFaceIndex, nNodeIndex, j;
+
+		m_FaceOrder.clear();
+		m_FaceOrder.reserve(nFaceCount);
+		if (nFaceCount == 0)
+			return;
+
+		// Build the node to face adjacency in compressed form
+		std::vector<nfUint32> FaceNodes(3 * (size_t)nFaceCount);
+		std::vector<nfUint32> AdjacencyStart(nNodeCount + 1, 0);
+		std::vector<nfUint32> RemainingValence(nNodeCount, 0);
+		const MESHFACE * pFaces = pMesh->getReadOnlyFaces();
+		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			const MESHFACE * pFace = &pFaces[nFaceIndex];
+			for (j = 0; j < 3; j++) {
+				nNodeIndex = pFace->m_nodeindices[j];
+				if (nNodeIndex >= nNodeCount)
+					throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+				FaceNodes[3 * (size_t)nFaceIndex + j] = nNodeIndex;
+				RemainingValence[nNodeIndex]++;
+			}
+		}
+		for (nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			AdjacencyStart[nNodeIndex + 1] = AdjacencyStart[nNodeIndex] + RemainingValence[nNodeIndex];
+
+		std::vector<nfUint32> AdjacentFaces(AdjacencyStart[nNodeCount]);
+		std::vector<nfUint32> AdjacencyFill(AdjacencyStart.begin(), AdjacencyStart.end() - 1);
+		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			for (j = 0; j < 3; j++) {
+				nNodeIndex = FaceNodes[3 * (size_t)nFaceIndex + j];
+				AdjacentFaces[AdjacencyFill[nNodeIndex]++] = nFaceIndex;
+			}
+		}
+
+		std::vector<nfInt32> CachePositions(nNodeCount, -1);
+		std::vector<nfFloat> NodeScores(nNodeCount);
+		for (nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			NodeScores[nNodeIndex] = calculateVertexScore(-1, RemainingValence[nNodeIndex]);
+
+		std::vector<nfFloat> FaceScores(nFaceCount);
+		std::vector<nfBool> FaceAdded(nFaceCount, false);
+		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			const nfUint32 * pNodes = &FaceNodes[3 * (size_t)nFaceIndex];
+			FaceScores[nFaceIndex] = NodeScores[pNodes[0]] + NodeScores[pNodes[1]] + NodeScores[pNodes[2]];
+		}
+
+		// The cache holds three additional entries for the vertices that fall out when adding a face
+		std::vector<nfUint32> Cache;
+		std::vector<nfUint32> NewCache;
+		Cache.reserve(NMR_VERTEXCACHE_SIZE + 3);
+		NewCache.reserve(NMR_VERTEXCACHE_SIZE + 3);
+
+		nfUint32 nNextUnaddedFace = 0;
+		nfUint32 nBestFace = 0;
+		nfFloat fBestScore = FaceScores[0];
+		for (nFaceIndex = 1; nFaceIndex < nFaceCount; nFaceIndex++) {
+			if (FaceScores[nFaceIndex] > fBestScore) {
+				fBestScore = FaceScores[nFaceIndex];
+				nBestFace = nFaceIndex;
+			}
+		}
+
+		while (m_FaceOrder.size() < nFaceCount) {
+			if (nBestFace == NMR_VERTEXCACHE_UNASSIGNED) {
+				// No face with a vertex in the cache: continue with the next face in the original order
+				while (FaceAdded[nNextUnaddedFace])
+					nNextUnaddedFace++;
+				nBestFace = nNextUnaddedFace;
+			}
+
+			m_FaceOrder.push_back(nBestFace);
+			FaceAdded[nBestFace] = true;
+
+			const nfUint32 * pNodes = &FaceNodes[3 * (size_t)nBestFace];
+			NewCache.clear();
+			for (j = 0; j < 3; j++) {
+				nNodeIndex = pNodes[j];
+
+				// Remove the face from the remaining adjacency of its nodes
+				nfUint32 nStart = AdjacencyStart[nNodeIndex];
+				nfUint32 nEnd = nStart + RemainingValence[nNodeIndex];
+				for (nfUint32 k = nStart; k < nEnd; k++) {
+					if (AdjacentFaces[k] == nBestFace) {
+						AdjacentFaces[k] = AdjacentFaces[nEnd - 1];
+						RemainingValence[nNodeIndex]--;
+						break;
+					}
+				}
+
+				if ((NewCache.size() == 0) || ((NewCache[0] != nNodeIndex) && ((NewCache.size() < 2) || (NewCache[1] != nNodeIndex))))
+					NewCache.push_back(nNodeIndex);
+			}
+
+			// Least recently used update of the cache
+			for (auto iIterator = Cache.begin(); iIterator != Cache.end(); iIterator++) {
+				nNodeIndex = *iIterator;
+				if ((nNodeIndex != pNodes[0]) && (nNodeIndex != pNodes[1]) && (nNodeIndex != pNodes[2]))
+					NewCache.push_back(nNodeIndex);
+			}
+
+			for (j = 0; j < NewCache.size(); j++) {
+				nNodeIndex = NewCache[j];
+				CachePositions[nNodeIndex] = (j < NMR_VERTEXCACHE_SIZE) ? (nfInt32)j : -1;
+				NodeScores[nNodeIndex] = calculateVertexScore(CachePositions[nNodeIndex], RemainingValence[nNodeIndex]);
+			}
+
+			// Rescore the faces of the touched nodes and find the best one
+			nBestFace = NMR_VERTEXCACHE_UNASSIGNED;
+			fBestScore = -1.0f;
+			for (j = 0; j < NewCache.size(); j++) {
+				nNodeIndex = NewCache[j];
+				nfUint32 nStart = AdjacencyStart[nNodeIndex];
+				nfUint32 nEnd = nStart + RemainingValence[nNodeIndex];
+				for (nfUint32 k = nStart; k < nEnd; k++) {
+					nFaceIndex = AdjacentFaces[k];
+					const nfUint32 * pFaceNodes = &FaceNodes[3 * (size_t)nFaceIndex];
+					nfFloat fScore = NodeScores[pFaceNodes[0]] + NodeScores[pFaceNodes[1]] + NodeScores[pFaceNodes[2]];
+					FaceScores[nFaceIndex] = fScore;
+					if (fScore > fBestScore) {
+						fBestScore = fScore;
+						nBestFace = nFaceIndex;
+					}
+				}
+			}
+
+			if (NewCache.size() > NMR_VERTEXCACHE_SIZE)
+				NewCache.resize(NMR_VERTEXCACHE_SIZE);
+			std::swap(Cache, NewCache);
+		}
+	}
+
+	void CMeshVertexCacheOptimizer::orderNodes(_In_ CMesh * pMesh)
+	{
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		nfUint32 nNodeIndex, j;
+
+		m_NodeMap.assign(nNodeCount, NMR_VERTEXCACHE_UNASSIGNED);
+		m_NodeOrder.clear();
+		m_NodeOrder.reserve(nNodeCount);
+
+		// Nodes are numbered by their first use in the new face order
+		const MESHFACE * pFaces = pMesh->getReadOnlyFaces();
+		for (auto iIterator = m_FaceOrder.begin(); iIterator != m_FaceOrder.end(); iIterator++) {
+			const MESHFACE * pFace = &pFaces[*iIterator];
+			for (j = 0; j < 3; j++) {
+				nNodeIndex = pFace->m_nodeindices[j];
+				if (m_NodeMap[nNodeIndex] == NMR_VERTEXCACHE_UNASSIGNED) {
+					m_NodeMap[nNodeIndex] = (nfUint32)m_NodeOrder.size();
+					m_NodeOrder.push_back(nNodeIndex);
+				}
+			}
+		}
+
+		// Nodes without faces (e.g. of beams) keep their relative order at the end
+		for (nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			if (m_NodeMap[nNodeIndex] == NMR_VERTEXCACHE_UNASSIGNED) {
+				m_NodeMap[nNodeIndex] = (nfUint32)m_NodeOrder.size();
+				m_NodeOrder.push_back(nNodeIndex);
+			}
+		}
+	}
+
+	nfUint32 CMeshVertexCacheOptimizer::getFaceIndex(_In_ nfUint32 nIndex)
+	{
+		if (nIndex >= m_FaceOrder.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return m_FaceOrder[nIndex];
+	}
+
+	nfUint32 CMeshVertexCacheOptimizer::getNodeIndex(_In_ nfUint32 nIndex)
+	{
+		if (nIndex >= m_NodeOrder.size())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return m_NodeOrder[nIndex];
+	}
+
+	nfUint32 CMeshVertexCacheOptimizer::mapNodeIndex(_In_ nfUint32 nNodeIndex)
+	{
+		if (nNodeIndex >= m_NodeMap.size())
+			throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+		return m_NodeMap[nNodeIndex];
+	}
+
+	nfUint64 CMeshVertexCacheOptimizer::getMemoryUsage()
+	{
+		return (nfUint64)(m_FaceOrder.capacity() + m_NodeOrder.capacity() + m_NodeMap.capacity()) * sizeof(nfUint32);
+	}
+
+}
@@ -34,10 +34,11 @@ This is a derived class for Exporting the binary STL and color STL Mesh Format.
 #include "Common/MeshExport/NMR_MeshExporter_STL.h" 
 #include "Common/MeshImport/NMR_MeshImporter_STL.h" 
 #include "Common/Math/NMR_Matrix.h" 
+#include "Common/Math/NMR_MatrixBatch.h" 
 #include "Common/Math/NMR_Vector.h" 
 #include "Common/NMR_Exception.h" 
 #include <cmath>
-#include <list>
+#include <vector>
 
 namespace NMR {
 
@@ -62,28 +63,29 @@ namespace NMR {
 
 		nfUint32 nIdx, j;
 		nfUint32 nFaceCount = pMesh->getFaceCount();
-		MESHFACE * face;
-		MESHNODE * node;
-
-		MESHFORMAT_STL_FACET facet;
-		std::list<MESHFORMAT_STL_FACET> facetdata;
+		const MESHFACE * face;
 
+		// Collect the corners of all faces, so that they are transformed and their normals are calculated in batches
+		std::vector<NVEC3> vertices(3 * (size_t)nFaceCount);
 		for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
+			face = pMesh->getReadOnlyFace(nIdx);
+			for (j = 0; j < 3; j++)
+				vertices[3 * (size_t)nIdx + j] = pMesh->getNodePosition(face->m_nodeindices[j]);
+		}
 
-			face = pMesh->getFace(nIdx);
-			for (j = 0; j < 3; j++) {
-				node = pMesh->getNode (face->m_nodeindices[j]);
-				if (pmMatrix)
-					facet.m_vertices[j] = fnMATRIX3_apply(*pmMatrix, node->m_position);
-				else
-					facet.m_vertices[j] = node->m_position;
-			}	
-
-			// Calculate Triangle Normals
-			facet.m_normal = fnVEC3_calcTriangleNormal(facet.m_vertices[0], facet.m_vertices[1], facet.m_vertices[2]);
-			facet.m_attribute = 0;
+		if (pmMatrix)
+			fnMATRIX3_applyBatch(*pmMatrix, vertices.data(), vertices.data(), vertices.size());
+
+		std::vector<NVEC3> normals(nFaceCount);
+		fnVEC3_calcTriangleNormalBatch(vertices.data(), normals.data(), nFaceCount);
 
-			facetdata.push_back(facet);
+		std::vector<MESHFORMAT_STL_FACET> facetdata(nFaceCount);
+		for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
+			MESHFORMAT_STL_FACET & facet = facetdata[nIdx];
+			facet.m_normal = normals[nIdx];
+			for (j = 0; j < 3; j++)
+				facet.m_vertices[j] = vertices[3 * (size_t)nIdx + j];
+			facet.m_attribute = 0;
 		}
 
 		nfByte stlheader[80];
@@ -102,19 +104,16 @@ namespace NMR {
 			nFacetCount = swapBytes(nFacetCount);
 		pStream->writeBuffer(&nFacetCount, sizeof (nFacetCount));
 
-		std::list<MESHFORMAT_STL_FACET>::iterator iter;
 		if (isBigEndian()) {
 			MESHFORMAT_STL_FACET tmpFacet;
-			for (iter = facetdata.begin(); iter != facetdata.end(); iter++) {
+			for (auto iter = facetdata.begin(); iter != facetdata.end(); iter++) {
 				tmpFacet = *iter;
 				tmpFacet.swapByteOrder();
 				pStream->writeBuffer(&tmpFacet, sizeof(MESHFORMAT_STL_FACET));
 			}
 		}
-		else {
-			for (iter = facetdata.begin(); iter != facetdata.end(); iter++) {
-				pStream->writeBuffer(&(*iter), sizeof(MESHFORMAT_STL_FACET));
-			}
+		else if (nFaceCount > 0) {
+			pStream->writeBuffer(facetdata.data(), facetdata.size() * sizeof(MESHFORMAT_STL_FACET));
 		}
 	}
 
@@ -36,10 +36,12 @@ This is a derived class for Importing the binary STL and color STL Mesh Format.
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h" 
 #include "Common/Math/NMR_VectorTree.h" 
 #include "Common/Math/NMR_Matrix.h" 
+#include "Common/Math/NMR_MatrixBatch.h" 
 #include "Common/NMR_Exception.h" 
 #include <cmath>
 #include <array>
 #include <list>
+#include <algorithm>
 
 namespace NMR {
 
@@ -146,49 +148,61 @@ namespace NMR {
 		}
 
 		nfUint32 nNodeIdx;
-		MESHNODE * pNodes[3];
-		MESHFORMAT_STL_FACET Facet;
+		nfUint32 nNodes[3];
+		std::vector<MESHFORMAT_STL_FACET> Facets;
+		std::vector<NVEC3> Vertices;
 		CVectorTree VectorTree;
 		nfBool bIsValid;
 
 		VectorTree.setUnits(m_fUnits);
 
-		for (nfUint32 nIdx = 0; nIdx < nFaceCount; nIdx++) {
-			pStream->readBuffer((nfByte*)&Facet, sizeof(Facet), true);
-			if (isBigEndian()) {
-				Facet.swapByteOrder();
+		// Facets are read in chunks, whose vertices are transformed at once
+		for (nfUint32 nChunkStart = 0; nChunkStart < nFaceCount; nChunkStart += NMR_STL_IMPORTCHUNKSIZE) {
+			nfUint32 nChunkSize = std::min(nFaceCount - nChunkStart, (nfUint32)NMR_STL_IMPORTCHUNKSIZE);
+			Facets.resize(nChunkSize);
+			Vertices.resize(3 * nChunkSize);
+			pStream->readBuffer((nfByte*)Facets.data(), nChunkSize * sizeof(MESHFORMAT_STL_FACET), true);
+			for (nfUint32 nIdx = 0; nIdx < nChunkSize; nIdx++) {
+				if (isBigEndian()) {
+					Facets[nIdx].swapByteOrder();
+				}
+				for (nfUint32 j = 0; j < 3; j++)
+					Vertices[3 * nIdx + j] = Facets[nIdx].m_vertices[j];
 			}
-
-			// Check, if Coordinates are in Valid Space
-			bIsValid = true;
-			for (nfUint32 j = 0; j < 3; j++)
-				for (nfUint32 k = 0; k < 3; k++)
-					bIsValid &= (fabs(Facet.m_vertices[j].m_fields[k]) < NMR_MESH_MAXCOORDINATE);
-
-			// Identify Nodes via Tree
-			if (bIsValid) {
-
-				for (nfUint32 j = 0; j < 3; j++) {
-					NVEC3 vPosition = Facet.m_vertices[j];
-					if (pmMatrix)
-						vPosition = fnMATRIX3_apply(*pmMatrix, vPosition);
-
-					if (VectorTree.findVector3(vPosition, nNodeIdx)) {
-						pNodes[j] = pMesh->getNode(nNodeIdx);
+			if (pmMatrix)
+				fnMATRIX3_applyBatch(*pmMatrix, Vertices.data(), Vertices.data(), Vertices.size());
+
+			for (nfUint32 nIdx = 0; nIdx < nChunkSize; nIdx++) {
+				const MESHFORMAT_STL_FACET & Facet = Facets[nIdx];
+
+				// Check, if Coordinates are in Valid Space
+				bIsValid = true;
+				for (nfUint32 j = 0; j < 3; j++)
+					for (nfUint32 k = 0; k < 3; k++)
+						bIsValid &= (fabs(Facet.m_vertices[j].m_fields[k]) < NMR_MESH_MAXCOORDINATE);
+
+				// Identify Nodes via Tree
+				if (bIsValid) {
+
+					for (nfUint32 j = 0; j < 3; j++) {
+						NVEC3 vPosition = Vertices[3 * nIdx + j];
+
+						if (VectorTree.findVector3(vPosition, nNodeIdx)) {
+							nNodes[j] = nNodeIdx;
+						}
+						else {
+							nNodes[j] = pMesh->addNode(vPosition);
+							VectorTree.addVector3(pMesh->getNodePosition(nNodes[j]), nNodes[j]);
+						}
 					}
-					else {
-						pNodes[j] = pMesh->addNode(vPosition);
-						VectorTree.addVector3(pNodes[j]->m_position, (nfUint32)pNodes[j]->m_index);
-					}
-				}
 
-				// check, if Nodes are separate
-				bIsValid = (pNodes[0] != pNodes[1]) && (pNodes[0] != pNodes[2]) && (pNodes[1] != pNodes[2]);
-			}
+					// check, if Nodes are separate
+					bIsValid = (nNodes[0] != nNodes[1]) && (nNodes[0] != nNodes[2]) && (nNodes[1] != nNodes[2]);
+				}
 
-			// Throw "Invalid Exception"
-			if ((!bIsValid) && !m_bIgnoreInvalidFaces)
-				throw CNMRException(NMR_ERROR_INVALIDCOORDINATES);
+				// Throw "Invalid Exception"
+				if ((!bIsValid) && !m_bIgnoreInvalidFaces)
+					throw CNMRException(NMR_ERROR_INVALIDCOORDINATES);
 
 			/*
 			if (bIsValid) {
@@ -211,6 +225,7 @@ namespace NMR {
 			} 
 			}
 			*/
+			}
 		}
 
 	}
@@ -44,6 +44,18 @@ namespace NMR {
 		m_nInternalID = 0;
 	}
 
+	_Ret_notnull_ const MESHINFORMATIONFACEDATA * CMeshInformation::getInvalidRecord()
+	{
+		if (!m_pContainer)
+			throw CNMRException(NMR_ERROR_NOMESHINFORMATIONCONTAINER);
+
+		if (m_InvalidRecord.size() != m_pContainer->getRecordSize()) {
+			m_InvalidRecord.assign(m_pContainer->getRecordSize(), 0);
+			this->invalidateFace(m_InvalidRecord.data());
+		}
+		return m_InvalidRecord.data();
+	}
+
 	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformation::getFaceData(nfUint32 nFaceIndex)
 	{
 		if (!m_pContainer)
@@ -51,26 +63,60 @@ namespace NMR {
 		return m_pContainer->getFaceData(nFaceIndex);
 	}
 
+	_Ret_notnull_ const MESHINFORMATIONFACEDATA * CMeshInformation::readFaceData(nfUint32 nFaceIndex)
+	{
+		if (!m_pContainer)
+			throw CNMRException(NMR_ERROR_NOMESHINFORMATIONCONTAINER);
+		return m_pContainer->readFaceData(nFaceIndex);
+	}
+
+	void CMeshInformation::setFaceData(nfUint32 nFaceIndex, _In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		if (!m_pContainer)
+			throw CNMRException(NMR_ERROR_NOMESHINFORMATIONCONTAINER);
+		m_pContainer->setFaceData(nFaceIndex, pData);
+	}
+
+	void CMeshInformation::readFaceDataRange(nfUint32 nStartIndex, nfUint32 nCount, _Out_ MESHINFORMATIONFACEDATA * pBuffer)
+	{
+		if (!m_pContainer)
+			throw CNMRException(NMR_ERROR_NOMESHINFORMATIONCONTAINER);
+		m_pContainer->readFaceDataRange(nStartIndex, nCount, pBuffer);
+	}
+
+	void CMeshInformation::setFaceDataRange(nfUint32 nStartIndex, nfUint32 nCount, _In_ const MESHINFORMATIONFACEDATA * pBuffer)
+	{
+		if (!m_pContainer)
+			throw CNMRException(NMR_ERROR_NOMESHINFORMATIONCONTAINER);
+		m_pContainer->setFaceDataRange(nStartIndex, nCount, pBuffer);
+	}
+
+	void CMeshInformation::cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount)
+	{
+		for (nfUint32 nIdx = 0; nIdx < nCount; nIdx++)
+			cloneFaceInfosFrom(nFaceIndex + nIdx, pOtherInformation, nOtherFaceIndex + nIdx);
+	}
+
 	void CMeshInformation::resetFaceInformation(_In_ nfUint32 nFaceIndex)
 	{
-		MESHINFORMATIONFACEDATA * pData = getFaceData(nFaceIndex);
-		if (pData)
-			this->invalidateFace(pData);
+		setFaceData(nFaceIndex, getInvalidRecord());
 	}
 
-	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformation::addFaceData(_In_ nfUint32 nNewFaceCount)
+	void CMeshInformation::addFaceData(_In_ nfUint32 nNewFaceCount)
 	{
-		return m_pContainer->addFaceData(nNewFaceCount);
+		m_pContainer->addFaceData(nNewFaceCount, getInvalidRecord());
 	}
 
 	void CMeshInformation::resetAllFaceInformation()
 	{
-		nfUint32 nCount = m_pContainer->getCurrentFaceCount();
-		nfUint32 nIndex;
+		m_pContainer->setAllFaceData(getInvalidRecord());
+	}
 
-		for (nIndex = 0; nIndex < nCount; nIndex++) {
-			resetFaceInformation(nIndex);
-		}
+	nfUint64 CMeshInformation::getMemoryUsage()
+	{
+		if (!m_pContainer)
+			return 0;
+		return m_pContainer->getMemoryUsage();
 	}
 
 	void CMeshInformation::setInternalID(nfUint64 nInternalID)
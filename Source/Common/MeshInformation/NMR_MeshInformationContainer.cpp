@@ -28,12 +28,16 @@ Abstract:
 
 NMR_MeshInformationContainer.cpp implements the Mesh Information Container
 Class. This class provides a memory container for holding the texture
-information state of a complete mesh structure.
+information state of a complete mesh structure. Records are stored run-length
+compressed as long as neighbouring faces mostly share the same record, and in a
+dense table of one record per face otherwise.
 
 --*/
 
 #include "Common/MeshInformation/NMR_MeshInformationContainer.h" 
 #include "Common/NMR_Exception.h" 
+#include <algorithm>
+#include <cstring>
 #include <cmath>
 
 namespace NMR {
@@ -42,14 +46,19 @@ namespace NMR {
 	{
 		m_nFaceCount = 0;
 		m_nRecordSize = 0;
+		m_bIsDense = false;
 		m_CurrentDataBlock = NULL;
+		m_nLastRun = 0;
 	}
 
-	CMeshInformationContainer::CMeshInformationContainer(nfUint32 nCurrentFaceCount, nfUint32 nRecordSize)
+	CMeshInformationContainer::CMeshInformationContainer(nfUint32 nCurrentFaceCount, nfUint32 nRecordSize, _In_opt_ PMemoryArena pMemoryArena)
 	{
 		m_nFaceCount = 0;
 		m_nRecordSize = nRecordSize;
+		m_bIsDense = false;
 		m_CurrentDataBlock = NULL;
+		m_pMemoryArena = pMemoryArena;
+		m_nLastRun = 0;
 
 		nfUint32 nIdx;
 		for (nIdx = 1; nIdx <= nCurrentFaceCount; nIdx++)
@@ -61,38 +70,164 @@ namespace NMR {
 		clear();
 	}
 
-	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformationContainer::addFaceData(nfUint32 nNewFaceCount)
+	nfUint32 CMeshInformationContainer::findRun(_In_ nfUint32 nIdx)
 	{
-		nfUint32 j, nPageSize;
-		MESHINFORMATIONFACEDATA * pByte;
+		__NMRASSERT(nIdx < m_nFaceCount);
 
-		if (m_nRecordSize == 0)
-			throw CNMRException(NMR_ERROR_INVALIDRECORDSIZE);
+		// Faces are mostly accessed in ascending order
+		nfUint32 nRunCount = (nfUint32)m_RunStarts.size();
+		nfUint32 nLastRun = m_nLastRun.load(std::memory_order_relaxed);
+		if (nLastRun < nRunCount) {
+			if ((m_RunStarts[nLastRun] <= nIdx) && (nIdx < getRunEnd(nLastRun)))
+				return nLastRun;
+			if ((nLastRun + 1 < nRunCount) && (m_RunStarts[nLastRun + 1] <= nIdx) && (nIdx < getRunEnd(nLastRun + 1))) {
+				m_nLastRun.store(nLastRun + 1, std::memory_order_relaxed);
+				return nLastRun + 1;
+			}
+		}
+
+		auto iIterator = std::upper_bound(m_RunStarts.begin(), m_RunStarts.end(), nIdx);
+		nLastRun = (nfUint32)(iIterator - m_RunStarts.begin()) - 1;
+		m_nLastRun.store(nLastRun, std::memory_order_relaxed);
+		return nLastRun;
+	}
+
+	nfUint32 CMeshInformationContainer::getRunEnd(_In_ nfUint32 nRun)
+	{
+		if (nRun + 1 < (nfUint32)m_RunStarts.size())
+			return m_RunStarts[nRun + 1];
+		return m_nFaceCount;
+	}
+
+	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformationContainer::getRunRecord(_In_ nfUint32 nRun)
+	{
+		return &m_RunRecords[(size_t)nRun * m_nRecordSize];
+	}
+
+	nfBool CMeshInformationContainer::runHasRecord(_In_ nfUint32 nRun, _In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		return memcmp(getRunRecord(nRun), pData, m_nRecordSize) == 0;
+	}
+
+	void CMeshInformationContainer::insertRun(_In_ nfUint32 nRun, _In_ nfUint32 nStart, _In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		m_RunStarts.insert(m_RunStarts.begin() + nRun, nStart);
+		m_RunRecords.insert(m_RunRecords.begin() + (size_t)nRun * m_nRecordSize, pData, pData + m_nRecordSize);
+	}
+
+	void CMeshInformationContainer::appendRun(_In_ nfUint32 nStart, _In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		nfUint32 nRunCount = (nfUint32)m_RunStarts.size();
+		if ((nRunCount == 0) || !runHasRecord(nRunCount - 1, pData))
+			insertRun(nRunCount, nStart, pData);
+	}
+
+	void CMeshInformationContainer::eraseRun(_In_ nfUint32 nRun)
+	{
+		m_RunStarts.erase(m_RunStarts.begin() + nRun);
+		auto iRecord = m_RunRecords.begin() + (size_t)nRun * m_nRecordSize;
+		m_RunRecords.erase(iRecord, iRecord + m_nRecordSize);
+		m_nLastRun = 0;
+	}
+
+	void CMeshInformationContainer::mergeRunWithNeighbours(_In_ nfUint32 nRun)
+	{
+		if ((nRun + 1 < (nfUint32)m_RunStarts.size()) && runHasRecord(nRun + 1, getRunRecord(nRun)))
+			eraseRun(nRun + 1);
+		if ((nRun > 0) && runHasRecord(nRun - 1, getRunRecord(nRun)))
+			eraseRun(nRun);
+	}
+
+	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformationContainer::allocateDataBlock()
+	{
+		nfUint32 nPageSize = m_nRecordSize * MESHINFORMATIONCOUNTER_BUFFERSIZE;
+		MESHINFORMATIONFACEDATA * pBlock;
+		if (m_pMemoryArena)
+			pBlock = static_cast<MESHINFORMATIONFACEDATA *>(m_pMemoryArena->allocate(nPageSize * sizeof(MESHINFORMATIONFACEDATA)));
+		else
+			pBlock = new MESHINFORMATIONFACEDATA[nPageSize];
+
+		memset(pBlock, 0, nPageSize * sizeof(MESHINFORMATIONFACEDATA));
+		m_DataBlocks.push_back(pBlock);
+		return pBlock;
+	}
 
-		nfUint32 nIdx = m_nFaceCount % MESHINFORMATIONCOUNTER_BUFFERSIZE;
-		if (nIdx == 0) {
-			nPageSize = m_nRecordSize * MESHINFORMATIONCOUNTER_BUFFERSIZE;
-			m_CurrentDataBlock = new MESHINFORMATIONFACEDATA[nPageSize];
+	void CMeshInformationContainer::releaseDataBlocks()
+	{
+		// Blocks of an arena go back to the arena for reuse
+		nfUint32 nPageSize = m_nRecordSize * MESHINFORMATIONCOUNTER_BUFFERSIZE;
+		std::vector<MESHINFORMATIONFACEDATA *>::iterator iter = m_DataBlocks.begin ();
+		while (iter != m_DataBlocks.end()){
+			MESHINFORMATIONFACEDATA * pBlock = *iter;
+			if (m_pMemoryArena)
+				m_pMemoryArena->deallocate(pBlock, nPageSize * sizeof(MESHINFORMATIONFACEDATA));
+			else
+				delete[] pBlock;
+			iter++;
+		}
+		m_DataBlocks.clear();
+		m_CurrentDataBlock = NULL;
+	}
 
-			m_DataBlocks.push_back(m_CurrentDataBlock);
+	void CMeshInformationContainer::makeDense()
+	{
+		if (m_bIsDense)
+			return;
 
-			pByte = m_CurrentDataBlock;
-			for (j = 0; j < nPageSize; j++) {
-				*pByte = 0;
-				pByte++;
+		nfUint32 nRunCount = (nfUint32)m_RunStarts.size();
+		nfUint32 nRun;
+		for (nRun = 0; nRun < nRunCount; nRun++) {
+			const MESHINFORMATIONFACEDATA * pRecord = getRunRecord(nRun);
+			nfUint32 nRunEnd = getRunEnd(nRun);
+			nfUint32 nIdx;
+			for (nIdx = m_RunStarts[nRun]; nIdx < nRunEnd; nIdx++) {
+				nfUint32 nModIdx = nIdx % MESHINFORMATIONCOUNTER_BUFFERSIZE;
+				if (nModIdx == 0)
+					m_CurrentDataBlock = allocateDataBlock();
+				memcpy(&m_CurrentDataBlock[m_nRecordSize * nModIdx], pRecord, m_nRecordSize);
 			}
 		}
 
-		if (!m_CurrentDataBlock)
-			throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONDATA);
+		m_RunStarts.clear();
+		m_RunStarts.shrink_to_fit();
+		m_RunRecords.clear();
+		m_RunRecords.shrink_to_fit();
+		m_nLastRun = 0;
+		m_bIsDense = true;
+	}
+
+	void CMeshInformationContainer::addFaceData(nfUint32 nNewFaceCount, _In_opt_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		if (m_nRecordSize == 0)
+			throw CNMRException(NMR_ERROR_INVALIDRECORDSIZE);
+		if (m_nFaceCount + 1 != nNewFaceCount)
+			throw CNMRException(NMR_ERROR_MESHINFORMATIONCOUNTMISMATCH);
+
+		if (m_bIsDense) {
+			nfUint32 nIdx = m_nFaceCount % MESHINFORMATIONCOUNTER_BUFFERSIZE;
+			if (nIdx == 0)
+				m_CurrentDataBlock = allocateDataBlock();
 
-		MESHINFORMATIONFACEDATA * result = &m_CurrentDataBlock[m_nRecordSize * nIdx];
+			if (!m_CurrentDataBlock)
+				throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONDATA);
+
+			if (pData)
+				memcpy(&m_CurrentDataBlock[m_nRecordSize * nIdx], pData, m_nRecordSize);
+			m_nFaceCount++;
+			return;
+		}
 
+		std::vector<MESHINFORMATIONFACEDATA> ZeroRecord;
+		if (!pData) {
+			ZeroRecord.resize(m_nRecordSize, 0);
+			pData = ZeroRecord.data();
+		}
+
+		appendRun(m_nFaceCount, pData);
 		m_nFaceCount++;
-		if (m_nFaceCount != nNewFaceCount)
-			throw CNMRException(NMR_ERROR_MESHINFORMATIONCOUNTMISMATCH);
 
-		return result;
+		// Appending faces with changing records fragments the runs as much as setting them
+		checkRunDensity();
 	}
 
 	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformationContainer::getFaceData(nfUint32 nIdx)
@@ -100,6 +235,8 @@ namespace NMR {
 		if (nIdx >= m_nFaceCount)
 			throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONINDEX);
 
+		makeDense();
+
 		nfUint32 nBlockIdx = nIdx / MESHINFORMATIONCOUNTER_BUFFERSIZE;
 		nfUint32 nModIdx = nIdx % MESHINFORMATIONCOUNTER_BUFFERSIZE;
 
@@ -107,23 +244,242 @@ namespace NMR {
 		return &pBlock[m_nRecordSize * nModIdx];
 	}
 
+	_Ret_notnull_ const MESHINFORMATIONFACEDATA * CMeshInformationContainer::readFaceData(nfUint32 nIdx)
+	{
+		if (nIdx >= m_nFaceCount)
+			throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONINDEX);
+
+		if (m_bIsDense) {
+			nfUint32 nBlockIdx = nIdx / MESHINFORMATIONCOUNTER_BUFFERSIZE;
+			nfUint32 nModIdx = nIdx % MESHINFORMATIONCOUNTER_BUFFERSIZE;
+			return &m_DataBlocks[nBlockIdx][m_nRecordSize * nModIdx];
+		}
+
+		return getRunRecord(findRun(nIdx));
+	}
+
+	void CMeshInformationContainer::setFaceData(nfUint32 nIdx, _In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		if (nIdx >= m_nFaceCount)
+			throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONINDEX);
+		if (!pData)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (m_bIsDense) {
+			memcpy(getFaceData(nIdx), pData, m_nRecordSize);
+			return;
+		}
+
+		nfUint32 nRun = findRun(nIdx);
+		if (runHasRecord(nRun, pData))
+			return;
+
+		if (exceedsShiftedRuns(nRun)) {
+			makeDense();
+			memcpy(getFaceData(nIdx), pData, m_nRecordSize);
+			return;
+		}
+
+		// pData may be the record of another run, which moves when runs are inserted or erased
+		std::vector<MESHINFORMATIONFACEDATA> DataCopy;
+		if (!m_RunRecords.empty() && (pData >= m_RunRecords.data()) && (pData < m_RunRecords.data() + m_RunRecords.size())) {
+			DataCopy.assign(pData, pData + m_nRecordSize);
+			pData = DataCopy.data();
+		}
+
+		nfUint32 nRunStart = m_RunStarts[nRun];
+		nfUint32 nRunEnd = getRunEnd(nRun);
+
+		if (nRunEnd - nRunStart == 1) {
+			memcpy(getRunRecord(nRun), pData, m_nRecordSize);
+			mergeRunWithNeighbours(nRun);
+			return;
+		}
+
+		if (nIdx == nRunStart) {
+			if ((nRun > 0) && runHasRecord(nRun - 1, pData))
+				m_RunStarts[nRun]++;
+			else {
+				insertRun(nRun, nIdx, pData);
+				m_RunStarts[nRun + 1]++;
+			}
+		}
+		else if (nIdx + 1 == nRunEnd) {
+			if ((nRun + 1 < (nfUint32)m_RunStarts.size()) && runHasRecord(nRun + 1, pData))
+				m_RunStarts[nRun + 1]--;
+			else
+				insertRun(nRun + 1, nIdx, pData);
+		}
+		else {
+			// Split the run around the face. The record is copied, as the insertion may reallocate it.
+			std::vector<MESHINFORMATIONFACEDATA> RunRecord(getRunRecord(nRun), getRunRecord(nRun) + m_nRecordSize);
+			insertRun(nRun + 1, nIdx, pData);
+			insertRun(nRun + 2, nIdx + 1, RunRecord.data());
+		}
+
+		checkRunDensity();
+	}
+
+	void CMeshInformationContainer::checkRunDensity()
+	{
+		nfUint32 nRunCount = (nfUint32)m_RunStarts.size();
+		if ((nRunCount > MESHINFORMATION_MINRUNCOUNT) && ((nfUint64)nRunCount * MESHINFORMATION_RUNDENSITY > m_nFaceCount))
+			makeDense();
+	}
+
+	nfBool CMeshInformationContainer::exceedsShiftedRuns(_In_ nfUint32 nRun)
+	{
+		return (nfUint32)m_RunStarts.size() - nRun > MESHINFORMATION_MAXSHIFTEDRUNS;
+	}
+
+	void CMeshInformationContainer::checkFaceRange(_In_ nfUint32 nStartIdx, _In_ nfUint32 nCount)
+	{
+		if ((nfUint64)nStartIdx + nCount > m_nFaceCount)
+			throw CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONINDEX);
+	}
+
+	void CMeshInformationContainer::readFaceDataRange(nfUint32 nStartIdx, nfUint32 nCount, _Out_ MESHINFORMATIONFACEDATA * pBuffer)
+	{
+		checkFaceRange(nStartIdx, nCount);
+		if (nCount == 0)
+			return;
+		if (!pBuffer)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nIdx = nStartIdx;
+		nfUint32 nEndIdx = nStartIdx + nCount;
+
+		if (m_bIsDense) {
+			while (nIdx < nEndIdx) {
+				nfUint32 nModIdx = nIdx % MESHINFORMATIONCOUNTER_BUFFERSIZE;
+				nfUint32 nBlockCount = std::min(MESHINFORMATIONCOUNTER_BUFFERSIZE - nModIdx, nEndIdx - nIdx);
+				memcpy(pBuffer, &m_DataBlocks[nIdx / MESHINFORMATIONCOUNTER_BUFFERSIZE][m_nRecordSize * nModIdx], (size_t)nBlockCount * m_nRecordSize);
+				pBuffer += (size_t)nBlockCount * m_nRecordSize;
+				nIdx += nBlockCount;
+			}
+			return;
+		}
+
+		nfUint32 nRun = findRun(nIdx);
+		while (nIdx < nEndIdx) {
+			const MESHINFORMATIONFACEDATA * pRecord = getRunRecord(nRun);
+			nfUint32 nRunEnd = std::min(getRunEnd(nRun), nEndIdx);
+			for (; nIdx < nRunEnd; nIdx++) {
+				memcpy(pBuffer, pRecord, m_nRecordSize);
+				pBuffer += m_nRecordSize;
+			}
+			nRun++;
+		}
+	}
+
+	void CMeshInformationContainer::setFaceDataRange(nfUint32 nStartIdx, nfUint32 nCount, _In_ const MESHINFORMATIONFACEDATA * pBuffer)
+	{
+		checkFaceRange(nStartIdx, nCount);
+		if (nCount == 0)
+			return;
+		if (!pBuffer)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nIdx = nStartIdx;
+		nfUint32 nEndIdx = nStartIdx + nCount;
+
+		if (m_bIsDense) {
+			while (nIdx < nEndIdx) {
+				nfUint32 nModIdx = nIdx % MESHINFORMATIONCOUNTER_BUFFERSIZE;
+				nfUint32 nBlockCount = std::min(MESHINFORMATIONCOUNTER_BUFFERSIZE - nModIdx, nEndIdx - nIdx);
+				memcpy(&m_DataBlocks[nIdx / MESHINFORMATIONCOUNTER_BUFFERSIZE][m_nRecordSize * nModIdx], pBuffer, (size_t)nBlockCount * m_nRecordSize);
+				pBuffer += (size_t)nBlockCount * m_nRecordSize;
+				nIdx += nBlockCount;
+			}
+			return;
+		}
+
+		nfUint32 nFirstRun = findRun(nStartIdx);
+		if (exceedsShiftedRuns(nFirstRun)) {
+			makeDense();
+			setFaceDataRange(nStartIdx, nCount, pBuffer);
+			return;
+		}
+
+		// Re-encode the runs from the first written one: the part before the range, the buffer and the part after the range
+		std::vector<nfUint32> OldRunStarts(m_RunStarts.begin() + nFirstRun, m_RunStarts.end());
+		std::vector<MESHINFORMATIONFACEDATA> OldRunRecords(m_RunRecords.begin() + (size_t)nFirstRun * m_nRecordSize, m_RunRecords.end());
+		m_RunStarts.resize(nFirstRun);
+		m_RunRecords.resize((size_t)nFirstRun * m_nRecordSize);
+		m_nLastRun = 0;
+
+		nfUint32 nOldRunCount = (nfUint32)OldRunStarts.size();
+		nfUint32 nRun;
+		for (nRun = 0; (nRun < nOldRunCount) && (OldRunStarts[nRun] < nStartIdx); nRun++)
+			appendRun(OldRunStarts[nRun], &OldRunRecords[(size_t)nRun * m_nRecordSize]);
+
+		for (; nIdx < nEndIdx; nIdx++) {
+			appendRun(nIdx, pBuffer);
+			pBuffer += m_nRecordSize;
+		}
+
+		for (nRun = 0; nRun < nOldRunCount; nRun++) {
+			nfUint32 nOldRunEnd = (nRun + 1 < nOldRunCount) ? OldRunStarts[nRun + 1] : m_nFaceCount;
+			if (nOldRunEnd > nEndIdx)
+				appendRun(std::max(OldRunStarts[nRun], nEndIdx), &OldRunRecords[(size_t)nRun * m_nRecordSize]);
+		}
+
+		checkRunDensity();
+	}
+
+	void CMeshInformationContainer::setAllFaceData(_In_ const MESHINFORMATIONFACEDATA * pData)
+	{
+		if (!pData)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		releaseDataBlocks();
+		m_bIsDense = false;
+
+		m_RunStarts.clear();
+		m_RunRecords.clear();
+		m_nLastRun = 0;
+		if (m_nFaceCount > 0)
+			insertRun(0, 0, pData);
+	}
+
 	nfUint32 CMeshInformationContainer::getCurrentFaceCount()
 	{
 		return m_nFaceCount;
 	}
 
+	nfUint32 CMeshInformationContainer::getRecordSize()
+	{
+		return m_nRecordSize;
+	}
+
+	nfBool CMeshInformationContainer::isDense()
+	{
+		return m_bIsDense;
+	}
+
+	PMemoryArena CMeshInformationContainer::getMemoryArena()
+	{
+		return m_pMemoryArena;
+	}
+
+	nfUint64 CMeshInformationContainer::getMemoryUsage()
+	{
+		if (m_bIsDense)
+			return (nfUint64)m_DataBlocks.size() * m_nRecordSize * MESHINFORMATIONCOUNTER_BUFFERSIZE;
+		return (nfUint64)m_RunStarts.capacity() * sizeof(nfUint32) + m_RunRecords.capacity();
+	}
+
 	void CMeshInformationContainer::clear()
 	{
-		std::vector<MESHINFORMATIONFACEDATA *>::iterator iter = m_DataBlocks.begin ();
-		while (iter != m_DataBlocks.end()){
-			MESHINFORMATIONFACEDATA * pBlock = *iter;
-			delete[] pBlock;
-			iter++;
-		}
+		releaseDataBlocks();
+
+		m_RunStarts.clear();
+		m_RunRecords.clear();
+		m_nLastRun = 0;
+		m_bIsDense = false;
 
 		m_nFaceCount = 0;
 		m_nRecordSize = 0;
-		m_CurrentDataBlock = NULL;
 	}
 
 }
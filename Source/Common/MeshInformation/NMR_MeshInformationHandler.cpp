@@ -70,10 +70,7 @@ namespace NMR {
 		std::vector<PMeshInformation>::iterator iter = m_pInformations.begin();
 
 		while (iter != m_pInformations.end()) {
-			MESHINFORMATIONFACEDATA * pData = (*iter)->addFaceData(nNewFaceCount);
-			if (pData)
-				(*iter)->invalidateFace(pData);
-
+			(*iter)->addFaceData(nNewFaceCount);
 			iter++;
 		}
 	}
@@ -104,6 +101,14 @@ namespace NMR {
 		return (nfUint32)m_pInformations.size();
 	}
 
+	nfUint64 CMeshInformationHandler::getMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = 0;
+		for (auto iIterator = m_pInformations.begin(); iIterator != m_pInformations.end(); iIterator++)
+			nMemoryUsage += (*iIterator)->getMemoryUsage();
+		return nMemoryUsage;
+	}
+
 	void CMeshInformationHandler::addInfoTableFrom(_In_ CMeshInformationHandler * pOtherInfoHandler, _In_ nfUint32 nCurrentFaceCount)
 	{
 		nfInt32 eType;
@@ -133,6 +138,15 @@ namespace NMR {
 		}
 	}
 
+	void CMeshInformationHandler::cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIdx, _In_ CMeshInformationHandler * pOtherInfoHandler, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount)
+	{
+		nfInt32 eType;
+		for (eType = emiAbstract; eType < emiLastType; eType++) {
+			if ((pOtherInfoHandler->m_pLookup[eType]) && (m_pLookup[eType]))
+				m_pLookup[eType]->cloneFaceInfoRangeFrom(nFaceIdx, pOtherInfoHandler->m_pLookup[eType], nOtherFaceIndex, nCount);
+		}
+	}
+
 	void CMeshInformationHandler::permuteNodeInformation(_In_ nfUint32 nFaceIdx, _In_ nfUint32 nNodeIndex1, _In_ nfUint32 nNodeIndex2, _In_ nfUint32 nNodeIndex3)
 	{
 		std::vector<PMeshInformation>::iterator iter = m_pInformations.begin();
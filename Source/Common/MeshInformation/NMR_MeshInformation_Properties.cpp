@@ -34,20 +34,52 @@ NMR_MeshInformation_Properties.cpp implements the Texture Mesh Information Class
 #include "Common/NMR_Exception.h"
 #include "Common/Math/NMR_Vector.h"
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 namespace NMR {
 
 
 	CMeshInformation_PropertyIndexMapping::CMeshInformation_PropertyIndexMapping()
 	{
+		m_nLastResourceID = 0;
+		m_pLastResourceMap = nullptr;
+	}
+
+	CMeshInformation_PropertyIndexMapping::sResourceIndexMap * CMeshInformation_PropertyIndexMapping::findResourceMap(nfUint32 nResourceID)
+	{
+		if ((nResourceID == m_nLastResourceID) && (m_pLastResourceMap != nullptr))
+			return m_pLastResourceMap;
+
+		auto iIterator = m_ResourceMaps.find(nResourceID);
+		if (iIterator == m_ResourceMaps.end())
+			return nullptr;
+
+		m_nLastResourceID = nResourceID;
+		m_pLastResourceMap = &iIterator->second;
+		return m_pLastResourceMap;
 	}
 
 	nfUint32 CMeshInformation_PropertyIndexMapping::registerPropertyID(nfUint32 nResourceID, ModelPropertyID nPropertyID, nfUint32 nResourceIndex)
 	{
 		if (nResourceID == 0)
 			throw CNMRException(NMR_ERROR_INVALIDPROPERTYRESOURCEID);
-
-		m_IDMap.insert(std::make_pair(std::make_pair(nResourceID, nPropertyID), nResourceIndex));
+		if (nResourceIndex == MESHINFORMATION_PROPERTYINDEX_UNMAPPED)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Pointers into the unordered_map stay valid on insertion
+		sResourceIndexMap & ResourceMap = m_ResourceMaps[nResourceID];
+
+		// The first registration of a property ID wins
+		if (nPropertyID < MESHINFORMATION_PROPERTYINDEX_DENSELIMIT) {
+			if (nPropertyID >= ResourceMap.m_DenseIndices.size())
+				ResourceMap.m_DenseIndices.resize(nPropertyID + 1, MESHINFORMATION_PROPERTYINDEX_UNMAPPED);
+			if (ResourceMap.m_DenseIndices[nPropertyID] == MESHINFORMATION_PROPERTYINDEX_UNMAPPED)
+				ResourceMap.m_DenseIndices[nPropertyID] = nResourceIndex;
+		}
+		else {
+			ResourceMap.m_SparseIndices.insert(std::make_pair(nPropertyID, nResourceIndex));
+		}
 
 		return nResourceIndex;
 	}
@@ -58,8 +90,21 @@ namespace NMR {
 		if (nResourceID == 0)
 			throw CNMRException(NMR_ERROR_INVALIDPROPERTYRESOURCEID);
 
-		auto iIterator = m_IDMap.find(std::make_pair(nResourceID, nPropertyID));
-		if (iIterator == m_IDMap.end())
+		sResourceIndexMap * pResourceMap = findResourceMap(nResourceID);
+		if (pResourceMap == nullptr)
+			throw CNMRException(NMR_ERROR_PROPERTYIDNOTFOUND);
+
+		if (nPropertyID < MESHINFORMATION_PROPERTYINDEX_DENSELIMIT) {
+			if (nPropertyID < pResourceMap->m_DenseIndices.size()) {
+				nfUint32 nIndex = pResourceMap->m_DenseIndices[nPropertyID];
+				if (nIndex != MESHINFORMATION_PROPERTYINDEX_UNMAPPED)
+					return nIndex;
+			}
+			throw CNMRException(NMR_ERROR_PROPERTYIDNOTFOUND);
+		}
+
+		auto iIterator = pResourceMap->m_SparseIndices.find(nPropertyID);
+		if (iIterator == pResourceMap->m_SparseIndices.end())
 			throw CNMRException(NMR_ERROR_PROPERTYIDNOTFOUND);
 
 		return iIterator->second;
@@ -89,12 +134,12 @@ namespace NMR {
 		m_pContainer = std::make_shared<CMeshInformationContainer>(0, (nfUint32) sizeof(MESHINFORMATION_PROPERTIES));
 	}
 
-	CMeshInformation_Properties::CMeshInformation_Properties(nfUint32 nCurrentFaceCount)
+	CMeshInformation_Properties::CMeshInformation_Properties(nfUint32 nCurrentFaceCount, _In_opt_ PMemoryArena pMemoryArena)
 	{
 		nfUint32 nIdx;
-		m_pContainer = std::make_shared<CMeshInformationContainer>(nCurrentFaceCount, (nfUint32) sizeof(MESHINFORMATION_PROPERTIES));
-		for (nIdx = 0; nIdx < nCurrentFaceCount; nIdx++)
-			invalidateFace(m_pContainer->getFaceData(nIdx));
+		m_pContainer = std::make_shared<CMeshInformationContainer>(0, (nfUint32) sizeof(MESHINFORMATION_PROPERTIES), pMemoryArena);
+		for (nIdx = 1; nIdx <= nCurrentFaceCount; nIdx++)
+			addFaceData(nIdx);
 	}
 
 	void CMeshInformation_Properties::invalidateFace(_In_ MESHINFORMATIONFACEDATA * pData)
@@ -136,31 +181,49 @@ namespace NMR {
 	{
 		__NMRASSERT(pOtherInformation);
 
-		MESHINFORMATION_PROPERTIES * pTargetFaceData = (MESHINFORMATION_PROPERTIES*)getFaceData(nFaceIndex);
-		MESHINFORMATION_PROPERTIES * pSourceFaceData = (MESHINFORMATION_PROPERTIES*)pOtherInformation->getFaceData(nOtherFaceIndex);
+		const MESHINFORMATION_PROPERTIES * pSourceFaceData = (const MESHINFORMATION_PROPERTIES*)pOtherInformation->readFaceData(nOtherFaceIndex);
 
-		if (pTargetFaceData && pSourceFaceData) {
+		if (pSourceFaceData) {
+			MESHINFORMATION_PROPERTIES TargetFaceData;
 			for (nfUint32 j = 0; j < 3; j++)
-				pTargetFaceData->m_nPropertyIDs[j] = pSourceFaceData->m_nPropertyIDs[j];
+				TargetFaceData.m_nPropertyIDs[j] = pSourceFaceData->m_nPropertyIDs[j];
+
+			TargetFaceData.m_nResourceID = pSourceFaceData->m_nResourceID;
+			setFaceData(nFaceIndex, (const MESHINFORMATIONFACEDATA*)&TargetFaceData);
+		}
+	}
+
+	void CMeshInformation_Properties::cloneFaceInfoRangeFrom(_In_ nfUint32 nFaceIndex, _In_ CMeshInformation * pOtherInformation, _In_ nfUint32 nOtherFaceIndex, _In_ nfUint32 nCount)
+	{
+		__NMRASSERT(pOtherInformation);
 
-			pTargetFaceData->m_nResourceID = pSourceFaceData->m_nResourceID;
+		// Property records are copied unchanged, block by block through a buffer
+		std::vector<MESHINFORMATION_PROPERTIES> Buffer(std::min(nCount, (nfUint32)MESHINFORMATIONCOUNTER_BUFFERSIZE));
+		while (nCount > 0) {
+			nfUint32 nBlockCount = std::min(nCount, (nfUint32)Buffer.size());
+			pOtherInformation->readFaceDataRange(nOtherFaceIndex, nBlockCount, (MESHINFORMATIONFACEDATA*)Buffer.data());
+			setFaceDataRange(nFaceIndex, nBlockCount, (const MESHINFORMATIONFACEDATA*)Buffer.data());
+			nFaceIndex += nBlockCount;
+			nOtherFaceIndex += nBlockCount;
+			nCount -= nBlockCount;
 		}
 	}
 
 	PMeshInformation CMeshInformation_Properties::cloneInstance(_In_ nfUint32 nCurrentFaceCount)
 	{
-		return std::make_shared<CMeshInformation_Properties>(nCurrentFaceCount);
+		return std::make_shared<CMeshInformation_Properties>(nCurrentFaceCount, m_pContainer->getMemoryArena());
 	}
 
 	void CMeshInformation_Properties::permuteNodeInformation(_In_ nfUint32 nFaceIndex, _In_ nfUint32 nNodeIndex1, _In_ nfUint32 nNodeIndex2, _In_ nfUint32 nNodeIndex3)
 	{
-		MESHINFORMATION_PROPERTIES * pFaceData = (MESHINFORMATION_PROPERTIES*)getFaceData(nFaceIndex);
+		const MESHINFORMATION_PROPERTIES * pFaceData = (const MESHINFORMATION_PROPERTIES*)readFaceData(nFaceIndex);
 		if (pFaceData && (nNodeIndex1 < 3) && (nNodeIndex2 < 3) && (nNodeIndex3 < 3)) {
-			MESHINFORMATION_PROPERTIES FaceDataCopy = *pFaceData;
+			MESHINFORMATION_PROPERTIES PermutedFaceData = *pFaceData;
 
-			pFaceData->m_nPropertyIDs[0] = FaceDataCopy.m_nPropertyIDs[nNodeIndex1];
-			pFaceData->m_nPropertyIDs[1] = FaceDataCopy.m_nPropertyIDs[nNodeIndex2];
-			pFaceData->m_nPropertyIDs[2] = FaceDataCopy.m_nPropertyIDs[nNodeIndex3];
+			PermutedFaceData.m_nPropertyIDs[0] = pFaceData->m_nPropertyIDs[nNodeIndex1];
+			PermutedFaceData.m_nPropertyIDs[1] = pFaceData->m_nPropertyIDs[nNodeIndex2];
+			PermutedFaceData.m_nPropertyIDs[2] = pFaceData->m_nPropertyIDs[nNodeIndex3];
+			setFaceData(nFaceIndex, (const MESHINFORMATIONFACEDATA*)&PermutedFaceData);
 		}
 	}
 
@@ -177,7 +240,7 @@ namespace NMR {
 
 	nfBool CMeshInformation_Properties::faceHasData(_In_ nfUint32 nFaceIndex)
 	{
-		MESHINFORMATION_PROPERTIES * pFaceData = (MESHINFORMATION_PROPERTIES*)getFaceData(nFaceIndex);
+		const MESHINFORMATION_PROPERTIES * pFaceData = (const MESHINFORMATION_PROPERTIES*)readFaceData(nFaceIndex);
 		if (pFaceData)
 			return (pFaceData->m_nResourceID != 0);
 
@@ -195,6 +195,7 @@ namespace NMR {
 		case NMR_ERROR_INVALIDMESHINFORMATIONDATA: return "Mesh Information Block was not assigned";
 		case NMR_ERROR_INVALIDMESHINFORMATION: return "Mesh Information Object was not assigned";
 		case NMR_ERROR_TOOMANYBEAMS: return "The mesh exceeds more than NMR_MESH_MAXBEAMCOUNT (2^31-1, around two billion) beams";
+		case NMR_ERROR_PIPEABORTED: return "A pipe stream has been aborted";
 
 		// Model error codes (0x8XXX)
 		case NMR_ERROR_OPCREADFAILED: return "3MF Loading - OPC could not be loaded";
@@ -396,6 +397,12 @@ namespace NMR {
 		case NMR_ERROR_MULTIPROPERTIES_INVALID_MULTI_ELEMENT: return "A multi-element is invalid";
 		case NMR_ERROR_INVALID_RESOURCE_INDEX: return "A Resource Index is invalid";
 		case NMR_ERROR_VERSION093_NOT_SUPPORTED: return "This document contains content from Version 093 of the core-specification. This is not fully supported by Lib3MF version 2 or later.";
+		case NMR_ERROR_STREAMWRITERNOTACTIVE: return "A streaming write has not been started";
+		case NMR_ERROR_STREAMWRITERACTIVE: return "A streaming write is already in progress";
+		case NMR_ERROR_OBJECTALREADYSTREAMED: return "Object has already been written to the stream";
+		case NMR_ERROR_REFERENCEDOBJECTNOTSTREAMED: return "Object references an object that has not been written to the stream yet";
+		case NMR_ERROR_WRITEINPROGRESS: return "A write operation of the model writer is still in progress";
+		case NMR_ERROR_STREAMDEDUPLICATIONNOTSUPPORTED: return "Mesh deduplication is not supported by streaming writes";
 
 
 		// XML Parser Error Constants(0x9XXX)
@@ -0,0 +1,144 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MemoryArena.cpp implements a chunked bump allocator, which can be shared by all
+bulk data of a model.
+
+--*/
+
+#include "Common/NMR_MemoryArena.h"
+#include "Common/NMR_Exception.h"
+
+namespace NMR {
+
+	CMemoryArena::CMemoryArena(_In_ size_t nChunkSize)
+		: m_pCurrent(nullptr), m_nRemaining(0), m_nChunkSize(nChunkSize), m_nReservedSize(0), m_nUsedSize(0)
+	{
+		if (nChunkSize == 0)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+	}
+
+	CMemoryArena::~CMemoryArena()
+	{
+		for (auto iIterator = m_Chunks.begin(); iIterator != m_Chunks.end(); iIterator++)
+			delete[] *iIterator;
+		for (auto iIterator = m_LargeChunks.begin(); iIterator != m_LargeChunks.end(); iIterator++)
+			delete[] *iIterator;
+	}
+
+	_Ret_notnull_ nfByte * CMemoryArena::allocateChunk(_In_ size_t nSize)
+	{
+		nfByte * pChunk = new nfByte[nSize];
+		m_Chunks.push_back(pChunk);
+		m_nReservedSize += nSize;
+		return pChunk;
+	}
+
+	_Ret_notnull_ void * CMemoryArena::allocate(_In_ size_t nSize, _In_ size_t nAlignment)
+	{
+		if ((nAlignment == 0) || ((nAlignment & (nAlignment - 1)) != 0) || (nAlignment > alignof(std::max_align_t)))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (nSize == 0)
+			nSize = 1;
+
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+
+		// Large requests get a chunk of their own, so that the current chunk is not wasted
+		if (nSize > m_nChunkSize / 4) {
+			nfByte * pChunk = new nfByte[nSize];
+			m_LargeChunks.insert(pChunk);
+			m_nReservedSize += nSize;
+			m_nUsedSize += nSize;
+			return pChunk;
+		}
+
+		auto iFreeBlocks = m_FreeBlocks.find(std::make_pair(nSize, nAlignment));
+		if ((iFreeBlocks != m_FreeBlocks.end()) && !iFreeBlocks->second.empty()) {
+			void * pResult = iFreeBlocks->second.back();
+			iFreeBlocks->second.pop_back();
+			m_nUsedSize += nSize;
+			return pResult;
+		}
+
+		size_t nPadding = (nAlignment - ((uintptr_t)m_pCurrent & (nAlignment - 1))) & (nAlignment - 1);
+		if ((m_pCurrent == nullptr) || (nPadding + nSize > m_nRemaining)) {
+			m_pCurrent = allocateChunk(m_nChunkSize);
+			m_nRemaining = m_nChunkSize;
+			nPadding = 0;
+		}
+
+		nfByte * pResult = m_pCurrent + nPadding;
+		m_pCurrent += nPadding + nSize;
+		m_nRemaining -= nPadding + nSize;
+		m_nUsedSize += nSize;
+
+		return pResult;
+	}
+
+	void CMemoryArena::deallocate(_In_opt_ void * pData, _In_ size_t nSize, _In_ size_t nAlignment)
+	{
+		if (pData == nullptr)
+			return;
+		if (nSize == 0)
+			nSize = 1;
+
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+		m_nUsedSize -= nSize;
+
+		if (nSize > m_nChunkSize / 4) {
+			auto iChunk = m_LargeChunks.find(static_cast<nfByte *>(pData));
+			if (iChunk != m_LargeChunks.end()) {
+				m_LargeChunks.erase(iChunk);
+				m_nReservedSize -= nSize;
+				delete[] static_cast<nfByte *>(pData);
+			}
+			return;
+		}
+
+		m_FreeBlocks[std::make_pair(nSize, nAlignment)].push_back(pData);
+	}
+
+	nfUint64 CMemoryArena::getReservedSize()
+	{
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+		return m_nReservedSize;
+	}
+
+	nfUint64 CMemoryArena::getUsedSize()
+	{
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+		return m_nUsedSize;
+	}
+
+	nfUint32 CMemoryArena::getChunkCount()
+	{
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+		return (nfUint32)(m_Chunks.size() + m_LargeChunks.size());
+	}
+
+}
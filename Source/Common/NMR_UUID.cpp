@@ -112,6 +112,36 @@ namespace NMR
 		return m_sUUID;
 	}
 
+	CUUID CUUID::derive(_In_ const std::string & sName) const
+	{
+		// Two FNV-1a hashes with different offsets, followed by the splitmix64 finalizer
+		std::string sKey = m_sUUID + "/" + sName;
+		nfUint64 nHashes[2] = { 0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL };
+		const nfChar* hexaDec = "0123456789abcdef";
+		nfChar string[33];
+		for (int j = 0; j < 2; j++) {
+			nfUint64 nHash = nHashes[j];
+			for (size_t i = 0; i < sKey.length(); i++) {
+				nHash ^= (nfByte)sKey[i];
+				nHash *= 0x100000001b3ULL;
+			}
+			nHash ^= nHash >> 30;
+			nHash *= 0xbf58476d1ce4e5b9ULL;
+			nHash ^= nHash >> 27;
+			nHash *= 0x94d049bb133111ebULL;
+			nHash ^= nHash >> 31;
+			for (int i = 0; i < 16; i++)
+				string[j * 16 + i] = hexaDec[(nHash >> (4 * i)) & 15];
+			nHashes[j] = nHash;
+		}
+		// Laid out as a v4 UUID, as 3MF only accepts the versions of RFC 4122
+		string[12] = hexaDec[4];
+		string[16] = hexaDec[8 + (nHashes[1] & 3)];
+		string[32] = 0;
+
+		return CUUID(string);
+	}
+
 	bool InValid(char c)
 	{
 		return !(((c >= '0') && (c <= '9'))
@@ -47,7 +47,8 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		m_pExportStream = pExportStream;
-		m_pZIPWriter = std::make_shared<CPortableZIPWriter>(m_pExportStream, true);
+		// Forward-only streams get sizes and checksums in data descriptors after each entry
+		m_pZIPWriter = std::make_shared<CPortableZIPWriter>(m_pExportStream, true, !m_pExportStream->isSeekable());
 	}
 
 	COpcPackageWriter::~COpcPackageWriter()
@@ -128,6 +128,11 @@ namespace NMR {
 		return m_nPosition;
 	}
 
+	nfBool CExportStream_Callback::isSeekable()
+	{
+		return (m_pSeekCallback != nullptr);
+	}
+
 	nfUint64 CExportStream_Callback::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
 	{
 		if (m_pWriteCallback == nullptr)
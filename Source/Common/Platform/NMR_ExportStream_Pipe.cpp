@@ -0,0 +1,215 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ExportStream_Pipe.cpp implements the pipe ExportStream and the stream pump.
+
+--*/
+
+#include "Common/Platform/NMR_ExportStream_Pipe.h"
+#include "Common/NMR_Exception.h"
+
+namespace NMR {
+
+	CExportStream_Pipe::CExportStream_Pipe(_In_ nfUint32 nChunkSize, _In_ nfUint32 nMaxChunks)
+	{
+		if ((nChunkSize == 0) || (nMaxChunks == 0))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_nChunkSize = nChunkSize;
+		m_nMaxChunks = nMaxChunks;
+		m_nPosition = 0;
+		m_bClosed = false;
+		m_bAborted = false;
+		m_CurrentChunk.reserve(m_nChunkSize);
+	}
+
+	nfBool CExportStream_Pipe::seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed)
+	{
+		if (position == m_nPosition)
+			return true;
+		if (bHasToSucceed)
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+		return false;
+	}
+
+	nfBool CExportStream_Pipe::seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		if (bytes == 0)
+			return true;
+		if (bHasToSucceed)
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+		return false;
+	}
+
+	nfBool CExportStream_Pipe::seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		if (bytes == 0)
+			return true;
+		if (bHasToSucceed)
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+		return false;
+	}
+
+	nfUint64 CExportStream_Pipe::getPosition()
+	{
+		return m_nPosition;
+	}
+
+	nfBool CExportStream_Pipe::isSeekable()
+	{
+		return false;
+	}
+
+	nfUint64 CExportStream_Pipe::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
+	{
+		if (pBuffer == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (m_bClosed)
+			throw CNMRException(NMR_ERROR_COULDNOTWRITESTREAM);
+
+		const nfByte * pByteBuffer = (const nfByte *)pBuffer;
+		nfUint64 cbBytesLeft = cbTotalBytesToWrite;
+		while (cbBytesLeft > 0) {
+			nfUint64 cbFree = m_nChunkSize - m_CurrentChunk.size();
+			nfUint64 cbCount = (cbBytesLeft < cbFree) ? cbBytesLeft : cbFree;
+
+			m_CurrentChunk.insert(m_CurrentChunk.end(), pByteBuffer, pByteBuffer + cbCount);
+			pByteBuffer += cbCount;
+			cbBytesLeft -= cbCount;
+
+			if (m_CurrentChunk.size() == m_nChunkSize)
+				pushCurrentChunk();
+		}
+
+		m_nPosition += cbTotalBytesToWrite;
+		return cbTotalBytesToWrite;
+	}
+
+	void CExportStream_Pipe::pushCurrentChunk()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_SpaceAvailable.wait(lock, [this] { return m_bAborted || (m_Chunks.size() < m_nMaxChunks); });
+		if (m_bAborted)
+			throw CNMRException(NMR_ERROR_PIPEABORTED);
+
+		m_Chunks.push_back(std::move(m_CurrentChunk));
+		m_CurrentChunk.clear();
+		m_CurrentChunk.reserve(m_nChunkSize);
+		m_ChunkAvailable.notify_one();
+	}
+
+	void CExportStream_Pipe::close()
+	{
+		if (m_bClosed)
+			return;
+
+		if (!m_CurrentChunk.empty())
+			pushCurrentChunk();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bClosed = true;
+		m_ChunkAvailable.notify_all();
+	}
+
+	void CExportStream_Pipe::abort()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bAborted = true;
+		m_ChunkAvailable.notify_all();
+		m_SpaceAvailable.notify_all();
+	}
+
+	nfBool CExportStream_Pipe::readChunk(_Out_ std::vector<nfByte> & Chunk)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_ChunkAvailable.wait(lock, [this] { return m_bAborted || m_bClosed || !m_Chunks.empty(); });
+		if (m_bAborted)
+			throw CNMRException(NMR_ERROR_PIPEABORTED);
+
+		if (m_Chunks.empty())
+			return false;
+
+		Chunk = std::move(m_Chunks.front());
+		m_Chunks.pop_front();
+		m_SpaceAvailable.notify_one();
+		return true;
+	}
+
+	CExportStreamPump::CExportStreamPump(_In_ PExportStream_Pipe pSource, _In_ PExportStream pTarget)
+	{
+		if ((pSource.get() == nullptr) || (pTarget.get() == nullptr))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pSource = pSource;
+		m_pTarget = pTarget;
+		m_Thread = std::thread(&CExportStreamPump::run, this);
+	}
+
+	CExportStreamPump::~CExportStreamPump()
+	{
+		if (m_Thread.joinable()) {
+			// Pump has not been finished, e.g. due to an exception of the producer
+			m_pSource->abort();
+			m_Thread.join();
+		}
+	}
+
+	void CExportStreamPump::run()
+	{
+		try {
+			std::vector<nfByte> Chunk;
+			while (m_pSource->readChunk(Chunk)) {
+				m_pTarget->writeBuffer(Chunk.data(), Chunk.size());
+			}
+		}
+		catch (...) {
+			m_pException = std::current_exception();
+			// Release the producer if it is waiting for space
+			m_pSource->abort();
+		}
+	}
+
+	void CExportStreamPump::finish()
+	{
+		try {
+			m_pSource->close();
+		}
+		catch (...) {
+			// The pipe has been aborted by the pump, its error is more specific
+			m_Thread.join();
+			if (m_pException)
+				std::rethrow_exception(m_pException);
+			throw;
+		}
+
+		m_Thread.join();
+		if (m_pException)
+			std::rethrow_exception(m_pException);
+	}
+
+}
@@ -101,6 +101,11 @@ namespace NMR {
 		return false;
 	}
 
+	nfBool CExportStream_ZIP::isSeekable()
+	{
+		return false;
+	}
+
 	nfUint64 CExportStream_ZIP::getPosition()
 	{
 		return m_pZIPWriter->getCurrentSize(m_nEntryKey);
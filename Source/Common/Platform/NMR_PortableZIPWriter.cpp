@@ -37,7 +37,7 @@ NMR_PortableZIPWriter.cpp implements a portable and fast writer of ZIP files
 
 namespace NMR {
 
-	CPortableZIPWriter::CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64)
+	CPortableZIPWriter::CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64, _In_ nfBool bWriteDataDescriptors)
 	{
 		if (pExportStream.get() == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -48,6 +48,7 @@ namespace NMR {
 		m_pCurrentEntry = nullptr;
 		m_bIsFinished = false;
 		m_bWriteZIP64 = bWriteZIP64;
+		m_bWriteDataDescriptors = bWriteDataDescriptors;
 
 		if (m_bWriteZIP64) {
 			m_nVersionMade = ZIPFILEVERSIONNEEDEDZIP64;
@@ -61,6 +62,10 @@ namespace NMR {
 		if (m_pExportStream->getPosition() != 0)
 			throw CNMRException(NMR_ERROR_EXPORTSTREAMNOTEMPTY);
 
+		// Local headers can only be patched if the stream allows to seek back
+		if (!m_bWriteDataDescriptors && !m_pExportStream->isSeekable())
+			throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+
 	}
 
 	CPortableZIPWriter::~CPortableZIPWriter()
@@ -98,7 +103,7 @@ namespace NMR {
 		ZIPLOCALFILEHEADER LocalHeader;
 		LocalHeader.m_nSignature = ZIPFILEHEADERSIGNATURE;
 		LocalHeader.m_nVersion = m_nVersionNeeded;
-		LocalHeader.m_nGeneralPurposeFlags = 0;
+		LocalHeader.m_nGeneralPurposeFlags = m_bWriteDataDescriptors ? ZIPFILEGENERALPURPOSEFLAG_DATADESCRIPTOR : 0;
 		LocalHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
 		LocalHeader.m_nLastModTime = nLastModTime;
 		LocalHeader.m_nLastModDate = nLastModDate;
@@ -159,54 +164,96 @@ namespace NMR {
 				throw CNMRException(NMR_ERROR_NOEXPORTSTREAM);
 			pZipStream->flushZIPStream();
 
-			// Write CRC and Size
-			ZIPLOCALFILEDESCRIPTOR FileDescriptor;
-			FileDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
-			if (m_bWriteZIP64) {
-				FileDescriptor.m_nCompressedSize =0xFFFFFFFF;
-				FileDescriptor.m_nUnCompressedSize = 0xFFFFFFFF;
-			}
-			else {
-				if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
-					(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
-					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
-				FileDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
-				FileDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
-			}
+			if (m_bWriteDataDescriptors)
+				writeDataDescriptor();
+			else
+				patchLocalHeader();
+		}
+
+		m_pCurrentStream = nullptr;
+		m_pCurrentEntry = nullptr;
+		m_nCurrentEntryKey = 0;
+	}
+
+	void CPortableZIPWriter::patchLocalHeader()
+	{
+		// Write CRC and Size
+		ZIPLOCALFILEDESCRIPTOR FileDescriptor;
+		FileDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+		if (m_bWriteZIP64) {
+			FileDescriptor.m_nCompressedSize =0xFFFFFFFF;
+			FileDescriptor.m_nUnCompressedSize = 0xFFFFFFFF;
+		}
+		else {
+			if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+				(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
+			FileDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
+			FileDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
+		}
+
+		ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
+		zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
+		zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
+		zip64ExtraInformation.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
+		zip64ExtraInformation.m_nUncompressedSize = m_pCurrentEntry->getUncompressedSize();
+		
+		// Write File Descriptor to file
+		m_pExportStream->seekPosition(m_pCurrentEntry->getFilePosition() + ZIPFILEDESCRIPTOROFFSET, true);
+		
+		// prepare byte-buffer for big-endian machines
+		if (isBigEndian()) {
+			FileDescriptor.swapByteOrder();
+		}
+		m_pExportStream->writeBuffer(&FileDescriptor, sizeof(FileDescriptor));
+
+		if (m_bWriteZIP64) {
+			// Write Extra Information to file
+			m_pExportStream->seekPosition(m_pCurrentEntry->getExtInfoPosition(), true);
 
-			ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
-			zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
-			zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
-			zip64ExtraInformation.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
-			zip64ExtraInformation.m_nUncompressedSize = m_pCurrentEntry->getUncompressedSize();
-			
-			// Write File Descriptor to file
-			m_pExportStream->seekPosition(m_pCurrentEntry->getFilePosition() + ZIPFILEDESCRIPTOROFFSET, true);
-			
 			// prepare byte-buffer for big-endian machines
 			if (isBigEndian()) {
-				FileDescriptor.swapByteOrder();
+				zip64ExtraInformation.swapByteOrder();
 			}
-			m_pExportStream->writeBuffer(&FileDescriptor, sizeof(FileDescriptor));
+			m_pExportStream->writeBuffer(&zip64ExtraInformation, sizeof(zip64ExtraInformation));
+		}
 
-			if (m_bWriteZIP64) {
-				// Write Extra Information to file
-				m_pExportStream->seekPosition(m_pCurrentEntry->getExtInfoPosition(), true);
+		// Reset file pointer
+		m_pExportStream->seekFromEnd(0, true);
+	}
 
-				// prepare byte-buffer for big-endian machines
-				if (isBigEndian()) {
-					zip64ExtraInformation.swapByteOrder();
-				}
-				m_pExportStream->writeBuffer(&zip64ExtraInformation, sizeof(zip64ExtraInformation));
-			}
+	void CPortableZIPWriter::writeDataDescriptor()
+	{
+		if (m_bWriteZIP64) {
+			ZIP64DATADESCRIPTOR DataDescriptor;
+			DataDescriptor.m_nSignature = ZIPFILEDATADESCRIPTORSIGNATURE;
+			DataDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+			DataDescriptor.m_nCompressedSize = m_pCurrentEntry->getCompressedSize();
+			DataDescriptor.m_nUnCompressedSize = m_pCurrentEntry->getUncompressedSize();
 
-			// Reset file pointer
-			m_pExportStream->seekFromEnd(0, true);
+			// prepare byte-buffer for big-endian machines
+			if (isBigEndian()) {
+				DataDescriptor.swapByteOrder();
+			}
+			m_pExportStream->writeBuffer(&DataDescriptor, sizeof(DataDescriptor));
 		}
+		else {
+			if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+				(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
 
-		m_pCurrentStream = nullptr;
-		m_pCurrentEntry = nullptr;
-		m_nCurrentEntryKey = 0;
+			ZIPDATADESCRIPTOR DataDescriptor;
+			DataDescriptor.m_nSignature = ZIPFILEDATADESCRIPTORSIGNATURE;
+			DataDescriptor.m_nCRC32 = m_pCurrentEntry->getCRC32();
+			DataDescriptor.m_nCompressedSize = (nfUint32)m_pCurrentEntry->getCompressedSize();
+			DataDescriptor.m_nUnCompressedSize = (nfUint32)m_pCurrentEntry->getUncompressedSize();
+
+			// prepare byte-buffer for big-endian machines
+			if (isBigEndian()) {
+				DataDescriptor.swapByteOrder();
+			}
+			m_pExportStream->writeBuffer(&DataDescriptor, sizeof(DataDescriptor));
+		}
 	}
 
 	void CPortableZIPWriter::calculateChecksum(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbUncompressedBytes)
@@ -270,7 +317,7 @@ namespace NMR {
 			DirectoryHeader.m_nSignature = ZIPFILECENTRALHEADERSIGNATURE;
 			DirectoryHeader.m_nVersionMade = m_nVersionMade;
 			DirectoryHeader.m_nVersionNeeded = m_nVersionNeeded;
-			DirectoryHeader.m_nGeneralPurposeFlags = 0;
+			DirectoryHeader.m_nGeneralPurposeFlags = m_bWriteDataDescriptors ? ZIPFILEGENERALPURPOSEFLAG_DATADESCRIPTOR : 0;
 			DirectoryHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
 			DirectoryHeader.m_nLastModTime = pEntry->getLastModTime();
 			DirectoryHeader.m_nLastModDate = pEntry->getLastModDate();
@@ -293,8 +340,8 @@ namespace NMR {
 				DirectoryHeader.m_nRelativeOffsetOfLocalHeader = 0xFFFFFFFF;
 			}
 			else {
-				if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
-					(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				if ((pEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+					(pEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
 					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
 				DirectoryHeader.m_nCompressedSize = (nfUint32)pEntry->getCompressedSize();
 				DirectoryHeader.m_nUnCompressedSize = (nfUint32)pEntry->getUncompressedSize();
@@ -46,4 +46,9 @@ namespace NMR {
 	{
 	}
 
+	nfUint64 CXmlReader::getMemoryUsage()
+	{
+		return 0;
+	}
+
 }
@@ -391,6 +391,14 @@ namespace NMR {
 		return false;
 	}
 
+	nfUint64 CXmlReader_Native::getMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = m_UTF8Buffer1.capacity() + m_UTF8Buffer2.capacity();
+		nMemoryUsage += (m_CurrentEntityList.capacity() + m_CurrentEntityPrefixes.capacity() + m_ZeroInsertArray.capacity()) * sizeof(nfChar *);
+		nMemoryUsage += m_CurrentEntityTypes.capacity();
+		return nMemoryUsage;
+	}
+
 	void CXmlReader_Native::CloseElement()
 	{
 		// Empty by purpose
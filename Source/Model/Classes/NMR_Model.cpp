@@ -49,11 +49,13 @@ A model is an in memory representation of the 3MF file.
 #include "Model/Classes/NMR_ModelMetaDataGroup.h"
 
 #include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshDuplicateFinder.h"
 #include "Common/MeshInformation/NMR_MeshInformation.h"
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include "Common/NMR_Exception.h"
 #include <sstream>
 #include <memory>
+#include <algorithm>
 
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceRefModel.h"
 #include "Common/Platform/NMR_XmlReader.h"
@@ -69,6 +71,11 @@ namespace NMR {
 		m_sLanguage = XML_3MF_LANG_US;
 		m_nHandleCounter = 1;
 		m_sCurPath = "";
+		m_bTrackPeakMemoryUsage = false;
+		m_nPeakMemoryUsage = 0;
+		m_nSampledResourceCount = 0;
+		m_nSampledResourceMemoryUsage = 0;
+		m_bMeshInstancesValid = false;
 
 		setBuildUUID(std::make_shared<CUUID>());
 		m_MetaDataGroup = std::make_shared<CModelMetaDataGroup>();
@@ -99,11 +106,67 @@ namespace NMR {
 		m_sRootPath = sPath;
 	}
 
-	// Merge all build items into one mesh
+	// Merge all build items into one mesh. The output ranges of all mesh instances are
+	// assigned first, so that the instances can be copied in parallel.
 	void CModel::mergeToMesh(_In_ CMesh * pMesh)
+	{
+		__NMRASSERT(pMesh);
+		CModelMeshObject::mergeInstancesToMesh(pMesh, getMeshInstances());
+	}
+
+	void CModel::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances)
 	{
 		for (auto iIterator = m_BuildItems.begin(); iIterator != m_BuildItems.end(); iIterator++) {
-			(*iIterator)->mergeToMesh(pMesh);
+			(*iIterator)->collectMeshInstances(Instances);
+		}
+	}
+
+	const std::vector<MODELMESHINSTANCE> & CModel::getMeshInstances()
+	{
+		if (!m_bMeshInstancesValid) {
+			m_MeshInstances.clear();
+			collectMeshInstances(m_MeshInstances);
+			m_bMeshInstancesValid = true;
+		}
+		return m_MeshInstances;
+	}
+
+	void CModel::invalidateMeshInstances()
+	{
+		m_bMeshInstancesValid = false;
+	}
+
+	void CModel::findDuplicateMeshes(_In_ nfBool bRigidTransforms, _Out_ std::map<CModelMeshObject *, MODELMESHINSTANCE> & Duplicates)
+	{
+		Duplicates.clear();
+
+		CMeshDuplicateFinder DuplicateFinder(bRigidTransforms);
+		std::vector<CModelMeshObject *> MeshObjects;
+
+		std::list<CModelObject *> ObjectList = getSortedObjectList();
+		for (auto iIterator = ObjectList.begin(); iIterator != ObjectList.end(); iIterator++) {
+			CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *> (*iIterator);
+			if (pMeshObject == nullptr)
+				continue;
+
+			CMesh * pMesh = pMeshObject->getMesh();
+			if ((pMesh == nullptr) || (pMesh->getFaceCount() == 0) || (pMesh->getBeamCount() > 0))
+				continue;
+			if ((pMeshObject->getSliceStack().get() != nullptr) || (pMeshObject->getObjectType() == MODELOBJECTTYPE_OTHER))
+				continue;
+
+			nfUint32 nIndex;
+			NMATRIX3 mMatrix;
+			if (DuplicateFinder.addMesh(pMesh, (nfUint64)pMeshObject->getObjectType(), nIndex, mMatrix)) {
+				MODELMESHINSTANCE Instance;
+				Instance.m_pMeshObject = MeshObjects[nIndex];
+				Instance.m_mTransform = mMatrix;
+				Instance.m_pBuildItem = nullptr;
+				Duplicates.insert(std::make_pair(pMeshObject, Instance));
+			}
+			else {
+				MeshObjects.push_back(pMeshObject);
+			}
 		}
 	}
 
@@ -169,6 +232,96 @@ namespace NMR {
 		return m_sLanguage;
 	}
 
+	void CModel::setUseMemoryArena(_In_ nfBool bUseMemoryArena)
+	{
+		if (bUseMemoryArena) {
+			if (!m_pMemoryArena)
+				m_pMemoryArena = std::make_shared<CMemoryArena>();
+		}
+		else {
+			// Data in the arena keeps it alive until it is released
+			m_pMemoryArena = nullptr;
+		}
+	}
+
+	nfBool CModel::getUseMemoryArena()
+	{
+		return m_pMemoryArena.get() != nullptr;
+	}
+
+	PMemoryArena CModel::getMemoryArena()
+	{
+		return m_pMemoryArena;
+	}
+
+	nfUint64 CModel::getMemoryUsage()
+	{
+		return getResourceMemoryUsage() + getAttachmentMemoryUsage();
+	}
+
+	nfUint64 CModel::getResourceMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = 0;
+		std::set<const void *> CountedBuffers;
+		for (auto iIterator = m_Resources.begin(); iIterator != m_Resources.end(); iIterator++)
+			nMemoryUsage += (*iIterator)->getDistinctMemoryUsage(CountedBuffers);
+		return nMemoryUsage;
+	}
+
+	nfUint64 CModel::getAttachmentMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = 0;
+		for (auto iIterator = m_Attachments.begin(); iIterator != m_Attachments.end(); iIterator++)
+			nMemoryUsage += (*iIterator)->getMemoryUsage();
+		for (auto iIterator = m_ProductionAttachments.begin(); iIterator != m_ProductionAttachments.end(); iIterator++)
+			nMemoryUsage += (*iIterator)->getMemoryUsage();
+		return nMemoryUsage;
+	}
+
+	void CModel::setTrackPeakMemoryUsage(_In_ nfBool bTrackPeakMemoryUsage)
+	{
+		m_bTrackPeakMemoryUsage = bTrackPeakMemoryUsage;
+		m_nPeakMemoryUsage = 0;
+		samplePeakMemoryUsage(0);
+	}
+
+	nfBool CModel::getTrackPeakMemoryUsage()
+	{
+		return m_bTrackPeakMemoryUsage;
+	}
+
+	nfUint64 CModel::getPeakMemoryUsage()
+	{
+		return m_nPeakMemoryUsage;
+	}
+
+	void CModel::samplePeakMemoryUsage(_In_ nfUint64 nTransientMemoryUsage)
+	{
+		if (!m_bTrackPeakMemoryUsage)
+			return;
+
+		m_nSampledResourceCount = (nfUint32)m_Resources.size();
+		m_nSampledResourceMemoryUsage = getResourceMemoryUsage();
+		m_nPeakMemoryUsage = std::max(m_nPeakMemoryUsage, m_nSampledResourceMemoryUsage + getAttachmentMemoryUsage() + nTransientMemoryUsage);
+	}
+
+	void CModel::sampleAddedResourcesPeakMemoryUsage(_In_ nfUint64 nTransientMemoryUsage)
+	{
+		if (!m_bTrackPeakMemoryUsage)
+			return;
+
+		// Resources have been removed since the last sample
+		if (m_Resources.size() < m_nSampledResourceCount) {
+			samplePeakMemoryUsage(nTransientMemoryUsage);
+			return;
+		}
+
+		// Freshly read resources do not share buffers with each other
+		for (; m_nSampledResourceCount < m_Resources.size(); m_nSampledResourceCount++)
+			m_nSampledResourceMemoryUsage += m_Resources[m_nSampledResourceCount]->getMemoryUsage();
+		m_nPeakMemoryUsage = std::max(m_nPeakMemoryUsage, m_nSampledResourceMemoryUsage + getAttachmentMemoryUsage() + nTransientMemoryUsage);
+	}
+
 	// General Resource Handling
 	PModelResource CModel::findResource(_In_ std::string path, ModelResourceID nID)
 	{
@@ -192,13 +345,20 @@ namespace NMR {
 	{
 		PackageResourceID uID = pID->getUniqueID();
 
-		auto iIterator = m_ResourceMap.find(uID);
-		if (iIterator != m_ResourceMap.end()) {
-			return iIterator->second;
-		}
+		if (uID < m_ResourceMap.size())
+			return m_ResourceMap[uID];
 		return nullptr;
 	}
 
+	PModelResource CModel::findResource(_In_ PackageResourcePathHandle nPathHandle, ModelResourceID nID)
+	{
+		PPackageResourceID pID = m_resourceHandler.findResourceID(nPathHandle, nID);
+		if (pID.get())
+			return findResource(pID);
+		else
+			return nullptr;
+	}
+
 	PPackageResourceID CModel::findPackageResourceID(_In_ std::string path, ModelResourceID nID)
 	{
 		return m_resourceHandler.findResourceID(path, nID);
@@ -207,6 +367,15 @@ namespace NMR {
 	{
 		return m_resourceHandler.findResourceID(nID);
 	}
+	PPackageResourceID CModel::findPackageResourceID(_In_ PackageResourcePathHandle nPathHandle, ModelResourceID nID)
+	{
+		return m_resourceHandler.findResourceID(nPathHandle, nID);
+	}
+
+	PackageResourcePathHandle CModel::getPathHandle(_In_ const std::string & path)
+	{
+		return m_resourceHandler.getPathHandle(path);
+	}
 
 	nfUint32 CModel::getResourceCount()
 	{
@@ -232,12 +401,13 @@ namespace NMR {
 
 		// Check if ID already exists
 		PackageResourceID nID = pResource->getResourceID()->getUniqueID();
-		auto iIterator = m_ResourceMap.find(nID);
-		if (iIterator != m_ResourceMap.end())
+		if ((nID < m_ResourceMap.size()) && (m_ResourceMap[nID].get() != nullptr))
 			throw CNMRException(NMR_ERROR_DUPLICATEMODELRESOURCE);
 
 		// Add ID to objects
-		m_ResourceMap.insert(std::make_pair(nID, pResource));
+		if (nID >= m_ResourceMap.size())
+			m_ResourceMap.resize(nID + 1);
+		m_ResourceMap[nID] = pResource;
 		m_Resources.push_back(pResource);
 
 		// Create correct lookup table
@@ -290,6 +460,7 @@ namespace NMR {
 		if (m_BuildItems.size() >= XML_3MF_MAXBUILDITEMCOUNT)
 			throw CNMRException(NMR_ERROR_INVALIDBUILDITEMCOUNT);
 		m_BuildItems.push_back(pBuildItem);
+		invalidateMeshInstances();
 	}
 
 	nfUint32 CModel::getBuildItemCount()
@@ -310,6 +481,7 @@ namespace NMR {
 		while (iIterator != m_BuildItems.end()) {
 			if ((*iIterator)->getHandle() == nHandle) {
 				m_BuildItems.erase(iIterator);
+				invalidateMeshInstances();
 				return;
 			}
 			iIterator++;
@@ -358,9 +530,9 @@ namespace NMR {
 	ModelResourceID CModel::generateResourceID()
 	{
 		// TODO: is this truly safe?
-		auto iIterator = m_ResourceMap.rbegin();
-		if (iIterator != m_ResourceMap.rend())
-			return iIterator->first + 1;
+		// The resource map ends with the largest unique ID of all added resources
+		if (!m_ResourceMap.empty())
+			return (ModelResourceID)m_ResourceMap.size();
 		else
 			return 1;
 	}
@@ -484,6 +656,7 @@ namespace NMR {
 		m_BaseMaterialLookup.clear();
 		m_ColorGroupLookup.clear();
 		m_BuildItems.clear();
+		invalidateMeshInstances();
 		m_ResourceMap.clear();
 		m_Resources.clear();
 		m_TextureLookup.clear();
@@ -32,6 +32,7 @@ NMR_ModelAttachment.cpp implements the Model Attachment Class.
 
 #include "Model/Classes/NMR_ModelAttachment.h" 
 #include "Common/NMR_Exception.h" 
+#include "Common/Platform/NMR_ImportStream_Unique_Memory.h" 
 
 namespace NMR {
 
@@ -82,6 +83,13 @@ namespace NMR {
 		m_sRelationShipType = sRelationShipType;
 	}
 
+	nfUint64 CModelAttachment::getMemoryUsage()
+	{
+		if (dynamic_cast<CImportStream_Unique_Memory *>(m_pStream.get()) == nullptr)
+			return 0;
+		return m_pStream->retrieveSize();
+	}
+
 
 
 }
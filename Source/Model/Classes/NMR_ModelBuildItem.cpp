@@ -80,6 +80,7 @@ namespace NMR {
 	void CModelBuildItem::setTransform(_In_ const NMATRIX3 mTransform)
 	{
 		m_mTransform = mTransform;
+		getModel()->invalidateMeshInstances();
 	}
 	
 	PackageResourceID CModelBuildItem::getObjectID()
@@ -144,6 +145,14 @@ namespace NMR {
 		m_pObject->mergeToMesh(pMesh, m_mTransform);
 	}
 
+	void CModelBuildItem::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances)
+	{
+		size_t nFirstInstance = Instances.size();
+		m_pObject->collectMeshInstances(Instances, m_mTransform);
+		for (size_t nIndex = nFirstInstance; nIndex < Instances.size(); nIndex++)
+			Instances[nIndex].m_pBuildItem = this;
+	}
+
 	nfUint32 CModelBuildItem::getHandle()
 	{
 		return m_nHandle;
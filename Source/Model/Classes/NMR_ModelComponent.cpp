@@ -79,6 +79,7 @@ namespace NMR {
 	void CModelComponent::setTransform(_In_ const NMATRIX3 mTransform)
 	{
 		m_mTransform = mTransform;
+		getModel()->invalidateMeshInstances();
 	}
 
 	PackageResourceID CModelComponent::getObjectID()
@@ -108,11 +109,10 @@ namespace NMR {
 		m_UUID = uuid;
 	}
 
-	void CModelComponent::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	void CModelComponent::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances, _In_ const NMATRIX3 mMatrix)
 	{
-		__NMRASSERT(pMesh);
 		NMATRIX3 mLocalMatrix = fnMATRIX3_multiply(mMatrix, m_mTransform);
-		m_pObject->mergeToMesh(pMesh, mLocalMatrix);
+		m_pObject->collectMeshInstances(Instances, mLocalMatrix);
 	}
 
 }
@@ -63,6 +63,7 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_MODELMISMATCH);
 
 		m_Components.push_back(pComponent);
+		pModel->invalidateMeshInstances();
 	}
 
 	nfUint32 CModelComponentsObject::getComponentCount()
@@ -78,11 +79,10 @@ namespace NMR {
 		return m_Components[nIdx];
 	}
 
-	void CModelComponentsObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	void CModelComponentsObject::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances, _In_ const NMATRIX3 mMatrix)
 	{
-		__NMRASSERT(pMesh);
 		for (auto iIterator = m_Components.begin(); iIterator != m_Components.end(); iIterator++)
-			(*iIterator)->mergeToMesh(pMesh, mMatrix);
+			(*iIterator)->collectMeshInstances(Instances, mMatrix);
 	}
 
 	nfBool CModelComponentsObject::isValid()
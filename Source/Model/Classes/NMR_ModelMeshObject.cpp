@@ -34,7 +34,7 @@ mesh object.
 
 #include "Model/Classes/NMR_ModelObject.h" 
 #include "Model/Classes/NMR_ModelMeshObject.h" 
-#include "Common/Math/NMR_PairMatchingTree.h" 
+#include "Common/Mesh/NMR_MeshEdgeTable.h" 
 
 namespace NMR {
 
@@ -42,7 +42,11 @@ namespace NMR {
 		: CModelObject(sID, pModel)
 	{
 		m_pMesh = std::make_shared<CMesh>();
+		m_pMesh->setMemoryArena(pModel->getMemoryArena());
 		m_pBeamLatticeAttributes = std::make_shared<CModelMeshBeamLatticeAttributes>();
+		m_bHasManifoldResult = false;
+		m_bManifoldAndOriented = false;
+		m_nManifoldModificationCount = 0;
 	}
 
 	CModelMeshObject::CModelMeshObject(_In_ const ModelResourceID sID, _In_ CModel * pModel, _In_ PMesh pMesh)
@@ -51,7 +55,12 @@ namespace NMR {
 		m_pMesh = pMesh;
 		if (m_pMesh.get() == nullptr)
 			m_pMesh = std::make_shared<CMesh>();
+		if (!m_pMesh->getMemoryArena())
+			m_pMesh->setMemoryArena(pModel->getMemoryArena());
 		m_pBeamLatticeAttributes = std::make_shared<CModelMeshBeamLatticeAttributes>();
+		m_bHasManifoldResult = false;
+		m_bManifoldAndOriented = false;
+		m_nManifoldModificationCount = 0;
 	}
 
 	CModelMeshObject::~CModelMeshObject()
@@ -70,12 +79,37 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		m_pMesh = pMesh;
+		m_bHasManifoldResult = false;
 	}
 
-	void CModelMeshObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	nfUint64 CModelMeshObject::getMemoryUsage()
+	{
+		return CModelObject::getMemoryUsage() + m_pMesh->getMemoryUsage();
+	}
+
+	nfUint64 CModelMeshObject::getDistinctMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers)
+	{
+		return CModelObject::getMemoryUsage() + m_pMesh->getMemoryUsage(CountedBuffers);
+	}
+
+	void CModelMeshObject::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances, _In_ const NMATRIX3 mMatrix)
+	{
+		MODELMESHINSTANCE Instance;
+		Instance.m_pMeshObject = this;
+		Instance.m_mTransform = mMatrix;
+		Instance.m_pBuildItem = nullptr;
+		Instances.push_back(Instance);
+	}
+
+	void CModelMeshObject::mergeInstancesToMesh(_In_ CMesh * pMesh, _In_ const std::vector<MODELMESHINSTANCE> & Instances)
 	{
 		__NMRASSERT(pMesh);
-		pMesh->mergeMesh(m_pMesh.get(), mMatrix);
+		std::vector<MESHMERGEINSTANCE> MeshInstances(Instances.size());
+		for (size_t nIndex = 0; nIndex < Instances.size(); nIndex++) {
+			MeshInstances[nIndex].m_pMesh = Instances[nIndex].m_pMeshObject->getMesh();
+			MeshInstances[nIndex].m_mMatrix = Instances[nIndex].m_mTransform;
+		}
+		pMesh->mergeMeshes(MeshInstances);
 	}
 
 	void CModelMeshObject::setObjectType(_In_ eModelObjectType ObjectType)
@@ -122,6 +156,17 @@ namespace NMR {
 	}
 
 	nfBool CModelMeshObject::isManifoldAndOriented()
+	{
+		if (m_bHasManifoldResult && (m_nManifoldModificationCount == m_pMesh->getModificationCount()))
+			return m_bManifoldAndOriented;
+
+		m_bManifoldAndOriented = checkManifoldAndOriented();
+		m_nManifoldModificationCount = m_pMesh->getModificationCount();
+		m_bHasManifoldResult = true;
+		return m_bManifoldAndOriented;
+	}
+
+	nfBool CModelMeshObject::checkManifoldAndOriented()
 	{
 		if (!m_pMesh->checkSanity())
 			return false;
@@ -134,77 +179,9 @@ namespace NMR {
 		if (nFaceCount < 3)
 			return false;
 
-		CPairMatchingTree PairMatchingTree;
-		nfUint32 nFaceIndex;
-		nfInt32 nEdgeIndex;
-		nfInt32 nEdgeCounter = 0;
-		nfUint32 j;
-
-		// Build Edge Tree
-		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
-			MESHFACE * pFace = m_pMesh->getFace(nFaceIndex);
-
-			for (j = 0; j < 3; j++) {
-				nfInt32 nNodeIndex1 = pFace->m_nodeindices[j];
-				nfInt32 nNodeIndex2 = pFace->m_nodeindices[(j + 1) % 3];
-
-				if (!PairMatchingTree.checkMatch(nNodeIndex1, nNodeIndex2, nEdgeIndex)) {
-					PairMatchingTree.addMatch(nNodeIndex1, nNodeIndex2, nEdgeCounter);
-					nEdgeCounter++;
-
-					if (nEdgeCounter > NMR_MESH_MAXEDGECOUNT)
-						throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
-				}
-			}
-
-		}
-
-		// Count positively and negatively oriented edges...
-		std::vector<nfInt32> PositiveOrientations;
-		std::vector<nfInt32> NegativeOrientations;
-
-		// Create Edge arrays
-		PositiveOrientations.resize(nEdgeCounter);
-		NegativeOrientations.resize(nEdgeCounter);
-		for (nEdgeIndex = 0; nEdgeIndex < nEdgeCounter; nEdgeIndex++) {
-			PositiveOrientations[nEdgeIndex] = 0;
-			NegativeOrientations[nEdgeIndex] = 0;
-		}
-
-		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
-			MESHFACE * pFace = m_pMesh->getFace(nFaceIndex);
-
-			for (j = 0; j < 3; j++) {
-				nfInt32 nNodeIndex1 = pFace->m_nodeindices[j];
-				nfInt32 nNodeIndex2 = pFace->m_nodeindices[(j + 1) % 3];
-
-				if (PairMatchingTree.checkMatch(nNodeIndex1, nNodeIndex2, nEdgeIndex)) {
-					if ((nEdgeIndex < 0) || (nEdgeIndex >= nEdgeCounter))
-						throw CNMRException(NMR_ERROR_INVALIDEDGEINDEX);
-
-					if (nNodeIndex1 <= nNodeIndex2) {
-						PositiveOrientations[nEdgeIndex]++;
-					}
-					else {
-						NegativeOrientations[nEdgeIndex]++;
-					}
-				}
-				else {
-					throw CNMRException(NMR_ERROR_INVALIDMESHTOPOLOGY);
-				}
-			}
-		}
-
-		// Check Edge Orientations and determine manifoldness
-		for (nEdgeIndex = 0; nEdgeIndex < nEdgeCounter; nEdgeIndex++) {
-			if (PositiveOrientations[nEdgeIndex] != 1)
-				return false;
-			if (NegativeOrientations[nEdgeIndex] != 1)
-				return false;
-		}
-
-		// Mesh is non-empty, oriented and manifold
-		return true;
+		// Mesh is manifold and oriented, if every edge is shared by two faces with opposite orientation
+		CMeshEdgeTable EdgeTable(m_pMesh.get());
+		return EdgeTable.isManifoldAndOriented();
 	}
 
 
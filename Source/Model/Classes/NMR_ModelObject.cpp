@@ -32,6 +32,7 @@ A model object is an in memory representation of the 3MF model object.
 --*/
 
 #include "Model/Classes/NMR_ModelObject.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
 #include "Model/Classes/NMR_ModelConstants.h"
 #include "Common/NMR_Exception.h"
 
@@ -51,7 +52,10 @@ namespace NMR {
 
 	void CModelObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
 	{
-		// empty on purpose, to be implemented by child classes
+		__NMRASSERT(pMesh);
+		std::vector<MODELMESHINSTANCE> Instances;
+		collectMeshInstances(Instances, mMatrix);
+		CModelMeshObject::mergeInstancesToMesh(pMesh, Instances);
 	}
 
 	void CModelObject::mergeToMesh(_In_ CMesh * pMesh)
@@ -59,6 +63,11 @@ namespace NMR {
 		mergeToMesh(pMesh, fnMATRIX3_identity());
 	}
 
+	void CModelObject::collectMeshInstances(_Inout_ std::vector<MODELMESHINSTANCE> & Instances, _In_ const NMATRIX3 mMatrix)
+	{
+		// empty on purpose, to be implemented by child classes
+	}
+
 	eModelObjectType CModelObject::getObjectType()
 	{
 		return m_ObjectType;
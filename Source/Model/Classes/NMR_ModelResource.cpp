@@ -67,6 +67,16 @@ namespace NMR {
 		return m_pModel;
 	}
 
+	nfUint64 CModelResource::getMemoryUsage()
+	{
+		return m_ResourceIndexMap.capacity() * sizeof(ModelPropertyID);
+	}
+
+	nfUint64 CModelResource::getDistinctMemoryUsage(_Inout_ std::set<const void *> & CountedBuffers)
+	{
+		return getMemoryUsage();
+	}
+
 
 	void CModelResource::clearResourceIndexMap()
 	{
@@ -85,6 +95,11 @@ namespace NMR {
 		return m_bHasResourceIndexMap;
 	}
 
+	const std::vector<ModelPropertyID> & CModelResource::getResourceIndexMap()
+	{
+		return m_ResourceIndexMap;
+	}
+
 	bool CModelResource::mapResourceIndexToPropertyID(_In_ ModelResourceIndex nPropertyIndex, _Out_ ModelPropertyID & nPropertyID)
 	{
 		if (nPropertyIndex < m_ResourceIndexMap.size()) {
@@ -35,12 +35,14 @@ A Model Slice represents a single slice as vertices and polygons
 #include "Common/NMR_Exception.h"
 
 namespace NMR {
-	CSlice::CSlice(nfDouble dZTop)
+	CSlice::CSlice(nfDouble dZTop, _In_opt_ PMemoryArena pMemoryArena)
+		: m_pMemoryArena(pMemoryArena), m_Vertices(CArenaAllocator<SLICENODE>(pMemoryArena))
 	{
 		m_dZTop = dZTop;
 	}
 
 	CSlice::CSlice(CSlice& other)
+		: m_pMemoryArena(other.m_pMemoryArena), m_Vertices(CArenaAllocator<SLICENODE>(other.m_pMemoryArena))
 	{
 		m_dZTop = other.m_dZTop;
 		m_Vertices = other.m_Vertices;
@@ -53,7 +55,7 @@ namespace NMR {
 
 	nfUint32 CSlice::beginPolygon()
 	{
-		m_Polygons.push_back(std::vector<nfUint32>());
+		m_Polygons.push_back(SLICEPOLYGON(CArenaAllocator<nfUint32>(m_pMemoryArena)));
 		return (nfUint32)m_Polygons.size() - 1;
 	}
 
@@ -135,7 +137,7 @@ namespace NMR {
 
 	bool CSlice::allPolygonsAreClosed()
 	{
-		for (auto polygon : m_Polygons) {
+		for (auto & polygon : m_Polygons) {
 			if (polygon.size() > 1) {
 				if (*polygon.begin() != *polygon.rbegin()) {
 					return false;
@@ -157,6 +159,15 @@ namespace NMR {
 		return m_Polygons[nPolygonIndex][0] != m_Polygons[nPolygonIndex][1];
 	}
 
+	nfUint64 CSlice::getMemoryUsage()
+	{
+		nfUint64 nMemoryUsage = (nfUint64)m_Vertices.capacity() * sizeof(SLICENODE);
+		nMemoryUsage += (nfUint64)m_Polygons.capacity() * sizeof(SLICEPOLYGON);
+		for (auto & polygon : m_Polygons)
+			nMemoryUsage += (nfUint64)polygon.capacity() * sizeof(nfUint32);
+		return nMemoryUsage;
+	}
+
 	nfUint32 CSlice::getPolygonIndex(nfUint32 nPolygonIndex, nfUint32 nIndexOfIndex)
 	{
 		if (nPolygonIndex >= m_Polygons.size())
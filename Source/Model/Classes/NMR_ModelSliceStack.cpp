@@ -65,7 +65,7 @@ namespace NMR {
 			if (m_dZBottom >= dZTop)
 				throw CNMRException(NMR_ERROR_SLICES_Z_NOTINCREASING);
 		}
-		PSlice pSlice = std::make_shared<CSlice>(dZTop);
+		PSlice pSlice = std::make_shared<CSlice>(dZTop, getModel()->getMemoryArena());
 		m_pSlices.push_back(pSlice);
 		return pSlice;
 	}
@@ -197,6 +197,15 @@ namespace NMR {
 		return true;
 	}
 
+	nfUint64 CModelSliceStack::getMemoryUsage()
+	{
+		// Referenced slice stacks are resources of their own
+		nfUint64 nMemoryUsage = CModelResource::getMemoryUsage();
+		for (auto & pSlice : m_pSlices)
+			nMemoryUsage += pSlice->getMemoryUsage();
+		return nMemoryUsage;
+	}
+
 
 	//nfUint32 CSliceStackGeometry::addSlice(PSlice pSlice)
 	//{
@@ -54,44 +54,67 @@ namespace NMR {
 		return m_uniqueID;
 	}
 
+	nfUint64 CResourceHandler::makePathAndIdKey(PackageResourcePathHandle nPathHandle, ModelResourceID id)
+	{
+		return ((nfUint64)nPathHandle << 32) | (nfUint64)id;
+	}
+
 	PPackageResourceID CResourceHandler::getNewResourceID(std::string path, ModelResourceID id)	// this is supposed to be the only way to generate a CPackageResourceID
 	{
 		PPackageResourceID p = std::make_shared<CPackageResourceID>();
-		if (findResourceID(path, id))
+		nfUint64 nKey = makePathAndIdKey(getPathHandle(path), id);
+		if (m_PathAndIdToResourceIDs.find(nKey) != m_PathAndIdToResourceIDs.end())
 			throw CNMRException(NMR_ERROR_DUPLICATERESOURCEID);
 		p->setPathAndId(path, id);
 		p->setUniqueID(int(m_resourceIDs.size())+1);
-		m_resourceIDs.insert(std::make_pair(p->getUniqueID(), p));
-		m_IdAndPathToResourceIDs.insert(std::make_pair(std::make_pair(id, path), p));
+		m_resourceIDs.push_back(p);
+		m_PathAndIdToResourceIDs.insert(std::make_pair(nKey, p));
 		return p;
 	}
 	PPackageResourceID CResourceHandler::findResourceID(PackageResourceID id)
 	{
-		auto it = m_resourceIDs.find(id);
-		if (it != m_resourceIDs.end())
-		{
-			return it->second;
-		}
-		return nullptr;
+		if ((id == 0) || (id > m_resourceIDs.size()))
+			return nullptr;
+		return m_resourceIDs[id - 1];
 	}
 	
 	PPackageResourceID CResourceHandler::findResourceID(std::string path, ModelResourceID id)
 	{
-		auto it = m_IdAndPathToResourceIDs.find(std::make_pair(id, path));
-		if (it != m_IdAndPathToResourceIDs.end())
+		auto itPath = m_PathHandles.find(path);
+		if (itPath == m_PathHandles.end())
+			return nullptr;
+		return findResourceID(itPath->second, id);
+	}
+
+	PPackageResourceID CResourceHandler::findResourceID(PackageResourcePathHandle nPathHandle, ModelResourceID id)
+	{
+		auto it = m_PathAndIdToResourceIDs.find(makePathAndIdKey(nPathHandle, id));
+		if (it != m_PathAndIdToResourceIDs.end())
 		{
 			return it->second;
 		}
 		return nullptr;
 	}
 
+	PackageResourcePathHandle CResourceHandler::getPathHandle(const std::string & path)
+	{
+		auto it = m_PathHandles.find(path);
+		if (it != m_PathHandles.end())
+			return it->second;
+
+		PackageResourcePathHandle nPathHandle = (PackageResourcePathHandle)m_PathHandles.size();
+		m_PathHandles.insert(std::make_pair(path, nPathHandle));
+		return nPathHandle;
+	}
+
 	void CResourceHandler::FlattenIDs() {
 
 	}
 
 	void CResourceHandler::clear() {
 		m_resourceIDs.clear();
-		m_IdAndPathToResourceIDs.clear();
+		m_PathHandles.clear();
+		m_PathAndIdToResourceIDs.clear();
 	}
 
 }
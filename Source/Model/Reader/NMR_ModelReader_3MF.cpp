@@ -105,6 +105,7 @@ namespace NMR {
 					pXMLNode->setIgnoreBuild(true);
 					pXMLNode->setIgnoreMetaData(true);
 					pXMLNode->parseXML(pXMLReader.get());
+					pModel->samplePeakMemoryUsage(pXMLReader->getMemoryUsage());
 
 					if (!pXMLNode->getHasResources())
 						throw CNMRException(NMR_ERROR_NORESOURCES);
@@ -129,6 +130,9 @@ namespace NMR {
 		// Extract Stream from Package
 		PImportStream pModelStream = extract3MFOPCPackage(pStream);
 		
+		// Resources read from here on are sampled incrementally, on top of the current ones
+		m_pModel->samplePeakMemoryUsage(0);
+
 		// before reading the root model, read the other models in the file
 		readProductionAttachmentModels(m_pModel, m_pWarnings, m_pProgressMonitor);
 
@@ -164,6 +168,7 @@ namespace NMR {
 				m_pModel->setCurPath(m_pModel->rootPath().c_str());
 				PModelReaderNode_Model pXMLNode = std::make_shared<CModelReaderNode_Model>(m_pModel.get(), m_pWarnings, m_pModel->rootPath().c_str(), m_pProgressMonitor);
 				pXMLNode->parseXML(pXMLReader.get());
+				m_pModel->samplePeakMemoryUsage(pXMLReader->getMemoryUsage());
 
 				if (!pXMLNode->getHasResources())
 					throw CNMRException(NMR_ERROR_NORESOURCES);
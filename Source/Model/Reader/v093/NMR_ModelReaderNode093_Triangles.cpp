@@ -99,10 +99,7 @@ namespace NMR {
 
 				// Create face if valid
 				if ((nIndex1 != nIndex2) && (nIndex1 != nIndex3) && (nIndex2 != nIndex3)) {
-					MESHNODE * pNode1 = m_pMesh->getNode(nIndex1);
-					MESHNODE * pNode2 = m_pMesh->getNode(nIndex2);
-					MESHNODE * pNode3 = m_pMesh->getNode(nIndex3);
-					MESHFACE * pFace = m_pMesh->addFace(pNode1, pNode2, pNode3);
+					nfUint32 nFaceIndex = m_pMesh->addFace(nIndex1, nIndex2, nIndex3);
 
 					nfInt32 nColorID1, nColorID2, nColorID3;
 					pXMLNode->retrieveColorIDs(nColorID1, nColorID2, nColorID3);
@@ -120,7 +117,7 @@ namespace NMR {
 					// Create Texture Info
 					if (nTextureID > 0) {
 						CMeshInformation_Properties * pProperties = createPropertiesInformation();
-						MESHINFORMATION_PROPERTIES* pFaceData = (MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(pFace->m_index);
+						MESHINFORMATION_PROPERTIES* pFaceData = (MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(nFaceIndex);
 						if (pFaceData) {
 
 							PModelTexture2DResource pTexture2dResource;
@@ -186,13 +183,12 @@ namespace NMR {
 										pBaseMaterialResource->buildResourceIndexMap();
 
 									CMeshInformation_Properties * pProperties = createPropertiesInformation();
-									MESHINFORMATION_PROPERTIES* pFaceData = (MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(pFace->m_index);
-									if (pFaceData) {
-										pFaceData->m_nResourceID = pBaseMaterialResource->getResourceID()->getUniqueID();
-										pFaceData->m_nPropertyIDs[0] = 1;
-										pFaceData->m_nPropertyIDs[1] = 1;
-										pFaceData->m_nPropertyIDs[2] = 1;
-									}
+									MESHINFORMATION_PROPERTIES FaceData;
+									FaceData.m_nResourceID = pBaseMaterialResource->getResourceID()->getUniqueID();
+									FaceData.m_nPropertyIDs[0] = 1;
+									FaceData.m_nPropertyIDs[1] = 1;
+									FaceData.m_nPropertyIDs[2] = 1;
+									pProperties->setFaceData(nFaceIndex, (const MESHINFORMATIONFACEDATA*)&FaceData);
 
 									MESHINFORMATION_PROPERTIES* pDefaultData = (MESHINFORMATION_PROPERTIES*)pProperties->getDefaultData();
 									if (m_pDefaultMaterialResource != nullptr) {
@@ -229,7 +225,7 @@ namespace NMR {
 			pProperties = dynamic_cast<CMeshInformation_Properties *> (pInformation);
 
 		if (!pProperties) {
-			PMeshInformation_Properties pNewMeshInformation = std::make_shared<CMeshInformation_Properties>(m_pMesh->getFaceCount());
+			PMeshInformation_Properties pNewMeshInformation = std::make_shared<CMeshInformation_Properties>(m_pMesh->getFaceCount(), m_pMesh->getMemoryArena());
 			pMeshInformationHandler->addInformation(pNewMeshInformation);
 
 			pProperties = pNewMeshInformation.get();
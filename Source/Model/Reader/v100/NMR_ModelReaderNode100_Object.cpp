@@ -336,7 +336,7 @@ namespace NMR {
 					auto pInformationHandler = pMesh->createMeshInformationHandler();
 					CMeshInformation_Properties * pInformation = dynamic_cast<CMeshInformation_Properties *> (pInformationHandler->getInformationByType(0, NMR::emiProperties));
 					if (pInformation == nullptr) {
-						NMR::PMeshInformation_Properties pNewInformation = std::make_shared<NMR::CMeshInformation_Properties>(pMesh->getFaceCount());
+						NMR::PMeshInformation_Properties pNewInformation = std::make_shared<NMR::CMeshInformation_Properties>(pMesh->getFaceCount(), pMesh->getMemoryArena());
 						pInformationHandler->addInformation(pNewInformation);
 
 						pInformation = pNewInformation.get();
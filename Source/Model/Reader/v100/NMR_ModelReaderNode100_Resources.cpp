@@ -91,6 +91,7 @@ namespace NMR {
 
 				PModelReaderNode pXMLNode = std::make_shared<CModelReaderNode100_Object>(m_pModel, m_pWarnings, m_pProgressMonitor);
 				pXMLNode->parseXML(pXMLReader);
+				m_pModel->sampleAddedResourcesPeakMemoryUsage(pXMLReader->getMemoryUsage());
 
 			}
 			else if (strcmp(pChildName, XML_3MF_ELEMENT_BASEMATERIALS) == 0) {
@@ -136,6 +137,7 @@ namespace NMR {
 				PModelReaderNode pXMLNode = std::make_shared<CModelReaderNode_Slice1507_SliceStack>(
 					m_pModel, m_pWarnings, m_pProgressMonitor, m_sPath.c_str());
 				pXMLNode->parseXML(pXMLReader);
+				m_pModel->sampleAddedResourcesPeakMemoryUsage(pXMLReader->getMemoryUsage());
 			}
 			else
 				m_pWarnings->addException(CNMRException(NMR_ERROR_NAMESPACE_INVALID_ELEMENT), mrwInvalidOptionalValue);
@@ -56,6 +56,54 @@ namespace NMR {
 
 		m_pModel = pModel;
 		m_pMesh = pMesh;
+
+		m_nPathHandle = pModel->getPathHandle(pModel->curPath());
+		m_pProperties = nullptr;
+	}
+
+	_Ret_notnull_ MODELREADERTRIANGLESRESOURCE * CModelReaderNode100_Triangles::resolveResource(_In_ ModelResourceID nResourceID)
+	{
+		if (nResourceID < NMR_MODELREADER_TRIANGLES_DIRECTRESOURCEIDS) {
+			if ((nResourceID < m_DirectResourceEntries.size()) && (m_DirectResourceEntries[nResourceID] != 0))
+				return &m_Resources[m_DirectResourceEntries[nResourceID] - 1];
+		}
+		else {
+			auto iIterator = m_ResourceEntries.find(nResourceID);
+			if (iIterator != m_ResourceEntries.end())
+				return &m_Resources[iIterator->second - 1];
+		}
+
+		MODELREADERTRIANGLESRESOURCE Resource;
+		Resource.m_nUniqueID = 0;
+		Resource.m_pPropertyIDs = nullptr;
+		Resource.m_nPropertyCount = 0;
+
+		PPackageResourceID pID = m_pModel->findPackageResourceID(m_nPathHandle, nResourceID);
+		if (pID.get()) {
+			Resource.m_nUniqueID = pID->getUniqueID();
+			Resource.m_pResource = m_pModel->findResource(pID);
+			if (Resource.m_pResource.get() != nullptr) {
+				if (!Resource.m_pResource->hasResourceIndexMap())
+					Resource.m_pResource->buildResourceIndexMap();
+
+				const std::vector<ModelPropertyID> & PropertyIDs = Resource.m_pResource->getResourceIndexMap();
+				Resource.m_pPropertyIDs = PropertyIDs.data();
+				Resource.m_nPropertyCount = (nfUint32)PropertyIDs.size();
+			}
+		}
+
+		m_Resources.push_back(Resource);
+		nfUint32 nEntry = (nfUint32)m_Resources.size();
+		if (nResourceID < NMR_MODELREADER_TRIANGLES_DIRECTRESOURCEIDS) {
+			if (nResourceID >= m_DirectResourceEntries.size())
+				m_DirectResourceEntries.resize(nResourceID + 1, 0);
+			m_DirectResourceEntries[nResourceID] = nEntry;
+		}
+		else {
+			m_ResourceEntries.insert(std::make_pair(nResourceID, nEntry));
+		}
+
+		return &m_Resources.back();
 	}
 
 	void CModelReaderNode100_Triangles::parseXML(_In_ CXmlReader * pXMLReader)
@@ -88,7 +136,7 @@ namespace NMR {
 			pProperties = dynamic_cast<CMeshInformation_Properties *> (pInformation);
 
 		if (!pProperties) {
-			PMeshInformation_Properties pNewMeshInformation = std::make_shared<CMeshInformation_Properties>(m_pMesh->getFaceCount());
+			PMeshInformation_Properties pNewMeshInformation = std::make_shared<CMeshInformation_Properties>(m_pMesh->getFaceCount(), m_pMesh->getMemoryArena());
 			pMeshInformationHandler->addInformation(pNewMeshInformation);
 
 			pProperties = pNewMeshInformation.get();
@@ -116,10 +164,7 @@ namespace NMR {
 
 				// Create face if valid
 				if ((nIndex1 != nIndex2) && (nIndex1 != nIndex3) && (nIndex2 != nIndex3)) {
-					MESHNODE * pNode1 = m_pMesh->getNode(nIndex1);
-					MESHNODE * pNode2 = m_pMesh->getNode(nIndex2);
-					MESHNODE * pNode3 = m_pMesh->getNode(nIndex3);
-					MESHFACE * pFace = m_pMesh->addFace(pNode1, pNode2, pNode3);
+					nfUint32 nFaceIndex = m_pMesh->addFace(nIndex1, nIndex2, nIndex3);
 
 					ModelResourceID nResourceID = m_nDefaultResourceID;
 					ModelResourceIndex nResourceIndex1 = m_nDefaultResourceIndex;
@@ -130,29 +175,21 @@ namespace NMR {
 						// set potential default properties (i.e. used pid)
 						m_nUsedResourceID = nResourceID;
 
-						PPackageResourceID pID = m_pModel->findPackageResourceID(m_pModel->curPath(), nResourceID);
-						if (pID.get()) {
-							// Find and Assign Resource of this Property
-							PModelResource pResource = m_pModel->findResource(pID->getUniqueID());
-							if (pResource.get () != nullptr) {
-								if (!pResource->hasResourceIndexMap())
-									pResource->buildResourceIndexMap();
-
-								ModelResourceID pPropertyID1;
-								ModelResourceID pPropertyID2;
-								ModelResourceID pPropertyID3;
-								if (pResource->mapResourceIndexToPropertyID (nResourceIndex1, pPropertyID1)
-									&& pResource->mapResourceIndexToPropertyID(nResourceIndex2, pPropertyID2) 
-									&& pResource->mapResourceIndexToPropertyID(nResourceIndex3, pPropertyID3)) {
-
-									CMeshInformation_Properties * pProperties = createPropertiesInformation();
-									MESHINFORMATION_PROPERTIES* pFaceData = (MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(pFace->m_index);
-									if (pFaceData) {
-										pFaceData->m_nResourceID = pID->getUniqueID();
-										pFaceData->m_nPropertyIDs[0] = pPropertyID1;
-										pFaceData->m_nPropertyIDs[1] = pPropertyID2;
-										pFaceData->m_nPropertyIDs[2] = pPropertyID3;
-									}
+						MODELREADERTRIANGLESRESOURCE * pResource = resolveResource(nResourceID);
+						if (pResource->m_nUniqueID != 0) {
+							// Assign Resource of this Property
+							if (pResource->m_pResource.get() != nullptr) {
+								nfUint32 nPropertyCount = pResource->m_nPropertyCount;
+								if ((nResourceIndex1 < nPropertyCount) && (nResourceIndex2 < nPropertyCount) && (nResourceIndex3 < nPropertyCount)) {
+									if (m_pProperties == nullptr)
+										m_pProperties = createPropertiesInformation();
+
+									MESHINFORMATION_PROPERTIES FaceData;
+									FaceData.m_nResourceID = pResource->m_nUniqueID;
+									FaceData.m_nPropertyIDs[0] = pResource->m_pPropertyIDs[nResourceIndex1];
+									FaceData.m_nPropertyIDs[1] = pResource->m_pPropertyIDs[nResourceIndex2];
+									FaceData.m_nPropertyIDs[2] = pResource->m_pPropertyIDs[nResourceIndex3];
+									m_pProperties->setFaceData(nFaceIndex, (const MESHINFORMATIONFACEDATA*)&FaceData);
 								} else {
 									m_pWarnings->addException(CNMRException(NMR_ERROR_INVALIDMESHINFORMATIONINDEX), mrwInvalidOptionalValue);
 								}
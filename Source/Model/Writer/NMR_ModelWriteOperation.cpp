@@ -0,0 +1,137 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelWriteOperation.cpp implements the asynchronous write of a model.
+
+--*/
+
+#include "Model/Writer/NMR_ModelWriteOperation.h"
+#include "Common/NMR_Exception.h"
+
+#include <chrono>
+
+namespace NMR {
+
+	CModelWriteOperation::CModelWriteOperation(_In_ PModelWriter pWriter, _In_ PExportStream pTargetStream)
+	{
+		if ((pWriter.get() == nullptr) || (pTargetStream.get() == nullptr))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pWriter = pWriter;
+		m_pTargetStream = pTargetStream;
+		m_pPipe = std::make_shared<CExportStream_Pipe>(NMR_EXPORTSTREAM_PIPE_CHUNKSIZE, NMR_EXPORTSTREAM_PIPE_MAXCHUNKS);
+		m_bFinished = false;
+		m_bCancelled = false;
+
+		m_pWriter->ClearCancelRequest();
+		m_bPreviousBackgroundCompression = m_pWriter->GetBackgroundCompression();
+		m_pWriter->SetBackgroundCompression(true);
+
+		m_Thread = std::thread(&CModelWriteOperation::run, this);
+	}
+
+	CModelWriteOperation::~CModelWriteOperation()
+	{
+		cancel();
+		joinThread();
+	}
+
+	void CModelWriteOperation::joinThread()
+	{
+		std::lock_guard<std::mutex> lock(m_JoinMutex);
+		if (m_Thread.joinable())
+			m_Thread.join();
+	}
+
+	void CModelWriteOperation::run()
+	{
+		try {
+			// The pump writes the package to the target stream, while the writer serializes and compresses
+			CExportStreamPump Pump(m_pPipe, m_pTargetStream);
+			try {
+				m_pWriter->exportToStream(m_pPipe);
+			}
+			catch (CNMRException & Exception) {
+				if (Exception.getErrorCode() == NMR_ERROR_PIPEABORTED)
+					Pump.finish();
+				throw;
+			}
+			Pump.finish();
+		}
+		catch (...) {
+			m_pException = std::current_exception();
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_pWriter->SetBackgroundCompression(m_bPreviousBackgroundCompression);
+		m_pWriter->ClearCancelRequest();
+
+		if (m_pException && m_bCancelled)
+			m_pException = std::make_exception_ptr(CNMRException(NMR_USERABORTED));
+
+		m_bFinished = true;
+		m_FinishedCondition.notify_all();
+	}
+
+	nfBool CModelWriteOperation::isFinished()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_bFinished;
+	}
+
+	nfBool CModelWriteOperation::waitFor(_In_ nfUint32 nTimeoutMilliseconds)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		return m_FinishedCondition.wait_for(lock, std::chrono::milliseconds(nTimeoutMilliseconds), [this] { return m_bFinished; });
+	}
+
+	void CModelWriteOperation::cancel()
+	{
+		// Under the lock, so that the cancel request can not outlive the operation
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_bFinished)
+			return;
+
+		m_bCancelled = true;
+		m_pWriter->RequestCancel();
+		m_pPipe->abort();
+	}
+
+	void CModelWriteOperation::finish()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_FinishedCondition.wait(lock, [this] { return m_bFinished; });
+		}
+		joinThread();
+
+		if (m_pException)
+			std::rethrow_exception(m_pException);
+	}
+
+}
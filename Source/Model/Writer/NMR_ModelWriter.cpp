@@ -46,7 +46,8 @@ namespace NMR {
 	const int MAX_DECIMAL_PRECISION = 16;
 
 	CModelWriter::CModelWriter(_In_ PModel pModel):
-		m_nDecimalPrecision(6)
+		m_nDecimalPrecision(6), m_bBackgroundCompression(false), m_bVertexCacheOptimization(false),
+		m_bMeshDeduplication(false), m_bRigidMeshDeduplication(false), m_bReleaseStreamedMeshes(false)
 	{
 		if (!pModel.get())
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
@@ -72,4 +73,64 @@ namespace NMR {
 		return m_nDecimalPrecision;
 	}
 
+	void CModelWriter::SetBackgroundCompression(nfBool bBackgroundCompression)
+	{
+		m_bBackgroundCompression = bBackgroundCompression;
+	}
+
+	nfBool CModelWriter::GetBackgroundCompression()
+	{
+		return m_bBackgroundCompression;
+	}
+
+	void CModelWriter::SetVertexCacheOptimization(nfBool bVertexCacheOptimization)
+	{
+		m_bVertexCacheOptimization = bVertexCacheOptimization;
+	}
+
+	nfBool CModelWriter::GetVertexCacheOptimization()
+	{
+		return m_bVertexCacheOptimization;
+	}
+
+	void CModelWriter::SetMeshDeduplication(nfBool bMeshDeduplication)
+	{
+		m_bMeshDeduplication = bMeshDeduplication;
+	}
+
+	nfBool CModelWriter::GetMeshDeduplication()
+	{
+		return m_bMeshDeduplication;
+	}
+
+	void CModelWriter::SetRigidMeshDeduplication(nfBool bRigidMeshDeduplication)
+	{
+		m_bRigidMeshDeduplication = bRigidMeshDeduplication;
+	}
+
+	nfBool CModelWriter::GetRigidMeshDeduplication()
+	{
+		return m_bRigidMeshDeduplication;
+	}
+
+	void CModelWriter::SetReleaseStreamedMeshes(nfBool bReleaseStreamedMeshes)
+	{
+		m_bReleaseStreamedMeshes = bReleaseStreamedMeshes;
+	}
+
+	nfBool CModelWriter::GetReleaseStreamedMeshes()
+	{
+		return m_bReleaseStreamedMeshes;
+	}
+
+	void CModelWriter::RequestCancel()
+	{
+		m_pProgressMonitor->RequestCancel();
+	}
+
+	void CModelWriter::ClearCancelRequest()
+	{
+		m_pProgressMonitor->ClearCancelRequest();
+	}
+
 }
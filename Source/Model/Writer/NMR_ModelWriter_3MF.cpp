@@ -101,7 +101,10 @@ namespace NMR {
 		pXMLWriter->WriteStartDocument();
 
 		CModelWriterNode100_Model ModelNode(pModel, pXMLWriter, m_pProgressMonitor, GetDecimalPrecision());
+		ModelNode.setOptimizeVertexCache(GetVertexCacheOptimization());
+		ModelNode.setMeshDeduplication(GetMeshDeduplication(), GetRigidMeshDeduplication());
 		ModelNode.writeToXML();
+		pModel->samplePeakMemoryUsage(ModelNode.getPeakTransientMemoryUsage());
 
 		pXMLWriter->WriteEndDocument();
 
@@ -38,12 +38,15 @@ using LibZ and a native XML writer implementation.
 #include "Model/Classes/NMR_ModelAttachment.h" 
 #include "Model/Classes/NMR_ModelTextureAttachment.h" 
 #include "Model/Classes/NMR_ModelSliceStack.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelComponentsObject.h"
 #include "Common/Platform/NMR_ImportStream.h" 
 #include "Common/NMR_Exception.h" 
 #include "Common/Platform/NMR_XmlWriter.h" 
 #include "Common/Platform/NMR_XmlWriter_Native.h" 
 #include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
 #include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ExportStream_Pipe.h"
 #include "Common/NMR_StringUtils.h" 
 #include "Common/3MF_ProgressMonitor.h"
 #include <functional>
@@ -61,6 +64,9 @@ namespace NMR {
 	void CModelWriter_3MF_Native::createPackage(_In_ CModel * pModel)
 	{
 		__NMRASSERT(pModel != nullptr);
+		if (isStreaming())
+			throw CNMRException(NMR_ERROR_STREAMWRITERACTIVE);
+
 		m_pModel = pModel;
 
 		m_nRelationIDCounter = 0;
@@ -84,12 +90,38 @@ namespace NMR {
 		// Write Model Stream
 		POpcPackageWriter pPackageWriter = std::make_shared<COpcPackageWriter>(pStream);
 		POpcPackagePart pModelPart = pPackageWriter->addPart(PACKAGE_3D_MODEL_URI);
-		PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pModelPart->getExportStream());
 
 		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEROOTMODEL);
 		m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
 
-		writeModelStream(pXMLWriter.get(), m_pModel);
+		if (GetBackgroundCompression()) {
+			// The XML is serialized into a pipe, while the pump deflates it into the package
+			PExportStream_Pipe pPipe = std::make_shared<CExportStream_Pipe>(NMR_EXPORTSTREAM_PIPE_CHUNKSIZE, NMR_EXPORTSTREAM_PIPE_MAXCHUNKS);
+			CExportStreamPump Pump(pPipe, pModelPart->getExportStream());
+			try {
+				PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pPipe);
+				writeModelStream(pXMLWriter.get(), m_pModel);
+			}
+			catch (CNMRException & Exception) {
+				// An aborted pipe hides the error of the compression stage
+				if (Exception.getErrorCode() == NMR_ERROR_PIPEABORTED)
+					Pump.finish();
+				throw;
+			}
+			Pump.finish();
+		}
+		else {
+			PXmlWriter_Native pXMLWriter = std::make_shared<CXmlWriter_Native>(pModelPart->getExportStream());
+			writeModelStream(pXMLWriter.get(), m_pModel);
+		}
+
+		writePackageParts(pPackageWriter, pModelPart);
+	}
+
+	void CModelWriter_3MF_Native::writePackageParts(_In_ POpcPackageWriter pPackageWriter, _In_ POpcPackagePart pModelPart)
+	{
+		__NMRASSERT(pPackageWriter.get() != nullptr);
+		__NMRASSERT(pModelPart.get() != nullptr);
 
 		// add Root relationships
 		pPackageWriter->addRootRelationship(generateRelationShipID(), PACKAGE_START_PART_RELATIONSHIP_TYPE, pModelPart.get());
@@ -142,6 +174,147 @@ namespace NMR {
 
 	}
 
+	void CModelWriter_3MF_Native::beginStream(_In_ PExportStream pStream)
+	{
+		if (pStream.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (isStreaming())
+			throw CNMRException(NMR_ERROR_STREAMWRITERACTIVE);
+		// Duplicates can only be found once all meshes are known, but objects are written while the model is still being built
+		if (GetMeshDeduplication())
+			throw CNMRException(NMR_ERROR_STREAMDEDUPLICATIONNOTSUPPORTED);
+
+		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_CREATEOPCPACKAGE);
+		m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+		m_pModel = CModelWriter::m_pModel.get();
+		m_nRelationIDCounter = 0;
+		m_StreamedObjects.clear();
+
+		try {
+			m_pStreamPackageWriter = std::make_shared<COpcPackageWriter>(pStream);
+			m_pStreamModelPart = m_pStreamPackageWriter->addPart(PACKAGE_3D_MODEL_URI);
+			m_pStreamXMLWriter = std::make_shared<CXmlWriter_Native>(m_pStreamModelPart->getExportStream());
+
+			m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEROOTMODEL);
+			m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+			// Header, metadata and all non-object resources must be known at this point
+			m_pStreamXMLWriter->WriteStartDocument();
+			m_pStreamModelNode.reset(new CModelWriterNode100_Model(m_pModel, m_pStreamXMLWriter.get(), m_pProgressMonitor, GetDecimalPrecision()));
+			m_pStreamModelNode->setOptimizeVertexCache(GetVertexCacheOptimization());
+			m_pStreamModelNode->writeStreamHeader();
+		}
+		catch (...) {
+			resetStream();
+			throw;
+		}
+	}
+
+	void CModelWriter_3MF_Native::appendObject(_In_ PackageResourceID nResourceID)
+	{
+		if (!isStreaming())
+			throw CNMRException(NMR_ERROR_STREAMWRITERNOTACTIVE);
+
+		CModelObject * pObject = m_pModel->findObject(nResourceID);
+		if (pObject == nullptr)
+			throw CNMRException(NMR_ERROR_RESOURCENOTFOUND);
+		if (m_StreamedObjects.find(nResourceID) != m_StreamedObjects.end())
+			throw CNMRException(NMR_ERROR_OBJECTALREADYSTREAMED);
+
+		// Components may only reference objects that are already part of the stream
+		CModelComponentsObject * pComponentsObject = dynamic_cast<CModelComponentsObject *> (pObject);
+		if (pComponentsObject != nullptr) {
+			nfUint32 nCount = pComponentsObject->getComponentCount();
+			for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+				CModelObject * pReferencedObject = pComponentsObject->getComponent(nIndex)->getObject();
+				if (m_StreamedObjects.find(pReferencedObject->getResourceID()->getUniqueID()) == m_StreamedObjects.end())
+					throw CNMRException(NMR_ERROR_REFERENCEDOBJECTNOTSTREAMED);
+			}
+		}
+
+		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEOBJECTS);
+		m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+		writeStreamedObject(pObject);
+	}
+
+	void CModelWriter_3MF_Native::finishStream()
+	{
+		if (!isStreaming())
+			throw CNMRException(NMR_ERROR_STREAMWRITERNOTACTIVE);
+
+		try {
+			// Write all objects that have not been appended, in dependency order
+			std::list<CModelObject *> objectList = m_pModel->getSortedObjectList();
+			for (auto iIterator = objectList.begin(); iIterator != objectList.end(); iIterator++) {
+				CModelObject * pObject = *iIterator;
+				if (m_StreamedObjects.find(pObject->getResourceID()->getUniqueID()) == m_StreamedObjects.end()) {
+					m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEOBJECTS);
+					m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+					writeStreamedObject(pObject);
+				}
+			}
+
+			m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEROOTMODEL);
+			m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+			m_pStreamModelNode->writeStreamFooter();
+			m_pStreamXMLWriter->WriteEndDocument();
+			m_pStreamXMLWriter->Flush();
+
+			writePackageParts(m_pStreamPackageWriter, m_pStreamModelPart);
+
+			// Releasing the package writer writes the content types and the central directory
+			m_pStreamModelNode.reset();
+			m_pStreamXMLWriter.reset();
+			m_pStreamModelPart.reset();
+			m_pStreamPackageWriter.reset();
+		}
+		catch (...) {
+			resetStream();
+			throw;
+		}
+
+		resetStream();
+
+		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_DONE);
+		m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+	}
+
+	nfBool CModelWriter_3MF_Native::isStreaming()
+	{
+		return (m_pStreamModelNode.get() != nullptr);
+	}
+
+	void CModelWriter_3MF_Native::writeStreamedObject(_In_ CModelObject * pObject)
+	{
+		__NMRASSERT(pObject != nullptr);
+
+		m_pStreamModelNode->writeObject(pObject);
+		m_StreamedObjects.insert(pObject->getResourceID()->getUniqueID());
+		m_pModel->samplePeakMemoryUsage(m_pStreamModelNode->getPeakTransientMemoryUsage());
+
+		// The caller may trade the geometry of written objects for memory
+		if (GetReleaseStreamedMeshes()) {
+			CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *> (pObject);
+			if (pMeshObject != nullptr)
+				pMeshObject->getMesh()->clear();
+		}
+	}
+
+	void CModelWriter_3MF_Native::resetStream()
+	{
+		m_pStreamModelNode.reset();
+		m_pStreamXMLWriter.reset();
+		m_pStreamModelPart.reset();
+		m_pStreamPackageWriter.reset();
+		m_StreamedObjects.clear();
+		m_pModel = nullptr;
+	}
+
+
 
 	std::string CModelWriter_3MF_Native::generateRelationShipID()
 	{
@@ -51,7 +51,8 @@ This is the class for exporting the 3mf mesh node.
 namespace NMR {
 
 	CModelWriterNode100_Mesh::CModelWriterNode100_Mesh(_In_ CModelMeshObject * pModelMeshObject, _In_ CXmlWriter * pXMLWriter, _In_ PProgressMonitor pProgressMonitor,
-		_In_ PMeshInformation_PropertyIndexMapping pPropertyIndexMapping, _In_ int nPosAfterDecPoint, _In_ nfBool bWriteMaterialExtension, _In_ nfBool bWriteBeamLatticeExtension)
+		_In_ PMeshInformation_PropertyIndexMapping pPropertyIndexMapping, _In_ int nPosAfterDecPoint, _In_ nfBool bWriteMaterialExtension, _In_ nfBool bWriteBeamLatticeExtension,
+		_In_ nfBool bOptimizeVertexCache)
 		:CModelWriterNode(pModelMeshObject->getModel(), pXMLWriter, pProgressMonitor), m_nPosAfterDecPoint(nPosAfterDecPoint), m_nPutDoubleFactor((int)(pow(10, CModelWriterNode100_Mesh::m_nPosAfterDecPoint)))
 	{
 		__NMRASSERT(pModelMeshObject != nullptr);
@@ -60,6 +61,8 @@ namespace NMR {
 
 		m_bWriteMaterialExtension = bWriteMaterialExtension;
 		m_bWriteBeamLatticeExtension = bWriteBeamLatticeExtension;
+		m_bOptimizeVertexCache = bOptimizeVertexCache;
+		m_nTransientMemoryUsage = 0;
 
 		m_pModelMeshObject = pModelMeshObject;
 		m_pPropertyIndexMapping = pPropertyIndexMapping;
@@ -108,16 +111,37 @@ namespace NMR {
 		const nfUint32 nBeamCount = pMesh->getBeamCount();
 		nfUint32 nNodeIndex, nFaceIndex, nBeamIndex;
 
+		// Optional output order with better index locality. Faces and nodes are only written in a different order,
+		// so per-face properties stay attached to the original faces.
+		PMeshVertexCacheOptimizer pOptimizer;
+		if (m_bOptimizeVertexCache && (nFaceCount > 0))
+			pOptimizer = std::make_shared<CMeshVertexCacheOptimizer>(pMesh);
+		m_nTransientMemoryUsage = pOptimizer ? pOptimizer->getMemoryUsage() : 0;
+
 		// Write Mesh Element
 		writeStartElement(XML_3MF_ELEMENT_MESH);
 
 		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITENODES);
 		// Write Vertices
 		writeStartElement(XML_3MF_ELEMENT_VERTICES);
+		// Quantized nodes are decoded one by one, so that writing does not expand the mesh.
+		// If they have been quantized with the output precision, their fixed point values are written directly.
+		const MESHNODE * pMeshNodes = pMesh->hasQuantizedNodes() ? nullptr : pMesh->getReadOnlyNodes();
+		nfBool bWriteFixedPoint = pMesh->hasQuantizedNodes() && (pMesh->getQuantizationPrecision() == (nfUint32)m_nPosAfterDecPoint);
 		for (nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
 			// Get Mesh Node
-			MESHNODE * pMeshNode = pMesh->getNode(nNodeIndex);
-			writeVertexData(pMeshNode);
+			nfUint32 nSourceNodeIndex = pOptimizer ? pOptimizer->getNodeIndex(nNodeIndex) : nNodeIndex;
+			if (pMeshNodes) {
+				writeVertexData(pMeshNodes[nSourceNodeIndex].m_position);
+			}
+			else if (bWriteFixedPoint) {
+				nfInt64 nValues[3];
+				pMesh->getQuantizedNode(nSourceNodeIndex, nValues);
+				writeVertexData_FixedPoint(nValues);
+			}
+			else {
+				writeVertexData(pMesh->getNodePosition(nSourceNodeIndex));
+			}
 
 			/* The following works, but would be a major output speed bottleneck!
 
@@ -138,6 +162,7 @@ namespace NMR {
 		CMeshInformation_Properties * pProperties = NULL;
 
 		ModelResourceID nObjectLevelPropertyID = 0;
+		ModelPropertyID nObjectLevelPropertyPropertyID = 0;
 		ModelResourceIndex nObjectLevelPropertyIndex = 0;
 
 		CMeshInformationHandler * pMeshInformationHandler = pMesh->getMeshInformationHandler();
@@ -150,6 +175,7 @@ namespace NMR {
 
 				if (pDefaultData && pDefaultData->m_nResourceID != 0) {
 					nObjectLevelPropertyID = pDefaultData->m_nResourceID;
+					nObjectLevelPropertyPropertyID = pDefaultData->m_nPropertyIDs[0];
 					nObjectLevelPropertyIndex = m_pPropertyIndexMapping->mapPropertyIDToIndex(nObjectLevelPropertyID, pDefaultData->m_nPropertyIDs[0]);
 				}
 			}
@@ -160,13 +186,26 @@ namespace NMR {
 		m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITETRIANGLES);
 		// Write Triangles
 		writeStartElement(XML_3MF_ELEMENT_TRIANGLES);
+		const MESHFACE * pMeshFaces = pMesh->getReadOnlyFaces();
 		for (nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
 			if (nFaceIndex % PROGRESS_TRIANGLEUPDATE == PROGRESS_TRIANGLEUPDATE - 1) {
 				m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
 			}
 
 			// Get Mesh Face
-			MESHFACE * pMeshFace = pMesh->getFace(nFaceIndex);
+			nfUint32 nSourceFaceIndex = nFaceIndex;
+			const MESHFACE * pMeshFace;
+			MESHFACE RemappedFace;
+			if (pOptimizer) {
+				nSourceFaceIndex = pOptimizer->getFaceIndex(nFaceIndex);
+				const MESHFACE * pSourceFace = &pMeshFaces[nSourceFaceIndex];
+				for (nfUint32 j = 0; j < 3; j++)
+					RemappedFace.m_nodeindices[j] = pOptimizer->mapNodeIndex(pSourceFace->m_nodeindices[j]);
+				pMeshFace = &RemappedFace;
+			}
+			else {
+				pMeshFace = &pMeshFaces[nFaceIndex];
+			}
 
 			ModelResourceID nPropertyID = 0;
 			ModelResourceIndex nPropertyIndex1 = 0;
@@ -176,9 +215,19 @@ namespace NMR {
 			nfChar * pAdditionalString = nullptr;
 			// Retrieve Property Indices
 			if (pProperties != nullptr) {
-				MESHINFORMATION_PROPERTIES* pFaceData = (MESHINFORMATION_PROPERTIES*)pProperties->getFaceData(nFaceIndex);
+				const MESHINFORMATION_PROPERTIES* pFaceData = (const MESHINFORMATION_PROPERTIES*)pProperties->readFaceData(nSourceFaceIndex);
 				if (pFaceData != nullptr) {
-					if (pFaceData->m_nResourceID) {
+					if ((pFaceData->m_nResourceID == nObjectLevelPropertyID) && (nObjectLevelPropertyID != 0) &&
+						(pFaceData->m_nPropertyIDs[0] == nObjectLevelPropertyPropertyID) &&
+						(pFaceData->m_nPropertyIDs[1] == nObjectLevelPropertyPropertyID) &&
+						(pFaceData->m_nPropertyIDs[2] == nObjectLevelPropertyPropertyID)) {
+						// Fast path: the face has the object level property, which needs no lookup
+						nPropertyID = nObjectLevelPropertyID;
+						nPropertyIndex1 = nObjectLevelPropertyIndex;
+						nPropertyIndex2 = nObjectLevelPropertyIndex;
+						nPropertyIndex3 = nObjectLevelPropertyIndex;
+					}
+					else if (pFaceData->m_nResourceID) {
 						nPropertyID = pFaceData->m_nResourceID;
 						nPropertyIndex1 = m_pPropertyIndexMapping->mapPropertyIDToIndex(nPropertyID, pFaceData->m_nPropertyIDs[0]);
 						nPropertyIndex2 = m_pPropertyIndexMapping->mapPropertyIDToIndex(nPropertyID, pFaceData->m_nPropertyIDs[1]);
@@ -254,10 +303,18 @@ namespace NMR {
 				{
 					// write beamlattice: beams
 					writeStartElementWithPrefix(XML_3MF_ELEMENT_BEAMS, XML_3MF_NAMESPACEPREFIX_BEAMLATTICE);
-					for (nBeamIndex = 0; nBeamIndex < nBeamCount; nBeamIndex++) {
+					MESHBEAMS::const_iterator iBeamIterator = pMesh->getReadOnlyBeams().begin();
+					for (nBeamIndex = 0; nBeamIndex < nBeamCount; nBeamIndex++, iBeamIterator++) {
 						// write beamlattice: beam
-						MESHBEAM * pMeshBeam = pMesh->getBeam(nBeamIndex);
-						writeBeamData(pMeshBeam, dDefaultRadius, eDefaultCapMode);
+						const MESHBEAM * pMeshBeam = &(*iBeamIterator);
+						if (pOptimizer) {
+							MESHBEAM RemappedBeam = *pMeshBeam;
+							RemappedBeam.m_nodeindices[0] = pOptimizer->mapNodeIndex(pMeshBeam->m_nodeindices[0]);
+							RemappedBeam.m_nodeindices[1] = pOptimizer->mapNodeIndex(pMeshBeam->m_nodeindices[1]);
+							writeBeamData(&RemappedBeam, dDefaultRadius, eDefaultCapMode);
+						}
+						else
+							writeBeamData(pMeshBeam, dDefaultRadius, eDefaultCapMode);
 					}
 					writeFullEndElement();
 
@@ -294,6 +351,11 @@ namespace NMR {
 	}
 
 
+	nfUint64 CModelWriterNode100_Mesh::getTransientMemoryUsage()
+	{
+		return m_nTransientMemoryUsage;
+	}
+
 	void CModelWriterNode100_Mesh::putVertexString(_In_ const nfChar * pszString)
 	{
 		__NMRASSERT(pszString);
@@ -310,52 +372,18 @@ namespace NMR {
 
 	void CModelWriterNode100_Mesh::putFloat(_In_ const nfFloat fValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos) {
 		// Format float with "%.$ACCf" syntax where $ACC = m_snPosAfterDecPoint
-		nfInt64 nAbsValue = (nfInt64)(fValue * m_nPutDoubleFactor);
-		nAbsValue = MAX(nAbsValue, -nAbsValue);
-		nfBool bIsNegative = fValue < 0;
-
-		int nStart = nBufferPos;
-		int nCount = 0;
-
-		if (!nAbsValue) {
-			line[nBufferPos++] = '0';
-		}
-		else {
-			// Write the string in reverse order
-			while (nAbsValue || nCount < m_nPosAfterDecPoint) {
-				line[nBufferPos++] = '0' + (nAbsValue % 10);
-				nAbsValue /= 10;
-				nCount++;
-				if (nCount == m_nPosAfterDecPoint) {
-					line[nBufferPos++] = '.';
-					if (!nAbsValue) {
-						line[nBufferPos++] = '0';
-					}
-					nCount++;
-				}
-			}
-			if (bIsNegative) {
-				line[nBufferPos++] = '-';
-				nCount++;
-			}
-		}
-
-		// Reverse the float string
-		int nEnd = nBufferPos - 1;
-		while (nStart < nEnd) {
-			char temp = line[nStart];
-			line[nStart] = line[nEnd];
-			line[nEnd] = temp;
-			nStart++;
-			nEnd--;
-		}
+		putFixedPoint((nfInt64)(fValue * m_nPutDoubleFactor), line, nBufferPos);
 	}
 
 	void CModelWriterNode100_Mesh::putDouble(_In_ const nfDouble dValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos) {
-		// Format float with "%.$ACCf" syntax where $ACC = m_snPosAfterDecPoint
-		nfInt64 nAbsValue = (nfInt64)(dValue * m_nPutDoubleFactor);
-		nAbsValue = MAX(nAbsValue, -nAbsValue);
-		nfBool bIsNegative = dValue < 0;
+		// Format double with "%.$ACCf" syntax where $ACC = m_snPosAfterDecPoint
+		putFixedPoint((nfInt64)(dValue * m_nPutDoubleFactor), line, nBufferPos);
+	}
+
+	void CModelWriterNode100_Mesh::putFixedPoint(_In_ const nfInt64 nValue, _In_ std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> & line, _In_ nfUint32 & nBufferPos) {
+		// nValue is given in units of 10^-m_nPosAfterDecPoint
+		nfInt64 nAbsValue = MAX(nValue, -nValue);
+		nfBool bIsNegative = nValue < 0;
 
 		int nStart = nBufferPos;
 		int nCount = 0;
@@ -399,6 +427,11 @@ namespace NMR {
 		putFloat(fValue, m_VertexLine, m_nVertexBufferPos);
 	}
 
+	void CModelWriterNode100_Mesh::putVertexFixedPoint(_In_ const nfInt64 nValue)
+	{
+		putFixedPoint(nValue, m_VertexLine, m_nVertexBufferPos);
+	}
+
 
 	void CModelWriterNode100_Mesh::putTriangleString(_In_ const nfChar * pszString)
 	{
@@ -489,21 +522,34 @@ namespace NMR {
 	}
 
 
-	void CModelWriterNode100_Mesh::writeVertexData(_In_ MESHNODE * pNode)
+	void CModelWriterNode100_Mesh::writeVertexData(_In_ const NVEC3 & vPosition)
+	{
+		m_nVertexBufferPos = MODELWRITERMESH100_VERTEXLINESTARTLENGTH;
+		putVertexFloat(vPosition.m_values.x);
+		putVertexString("\" y=\"");
+		putVertexFloat(vPosition.m_values.y);
+		putVertexString("\" z=\"");
+		putVertexFloat(vPosition.m_values.z);
+		putVertexString("\" />");
+
+		m_pXMLWriter->WriteRawLine(&m_VertexLine[0], m_nVertexBufferPos);
+	}
+
+	void CModelWriterNode100_Mesh::writeVertexData_FixedPoint(_In_ const nfInt64 * pValues)
 	{
-		__NMRASSERT(pNode);
+		__NMRASSERT(pValues);
 		m_nVertexBufferPos = MODELWRITERMESH100_VERTEXLINESTARTLENGTH;
-		putVertexFloat(pNode->m_position.m_values.x);
+		putVertexFixedPoint(pValues[0]);
 		putVertexString("\" y=\"");
-		putVertexFloat(pNode->m_position.m_values.y);
+		putVertexFixedPoint(pValues[1]);
 		putVertexString("\" z=\"");
-		putVertexFloat(pNode->m_position.m_values.z);
+		putVertexFixedPoint(pValues[2]);
 		putVertexString("\" />");
 
 		m_pXMLWriter->WriteRawLine(&m_VertexLine[0], m_nVertexBufferPos);
 	}
 
-	void CModelWriterNode100_Mesh::writeFaceData_Plain(_In_ MESHFACE * pFace, _In_opt_ const nfChar * pszAdditionalString)
+	void CModelWriterNode100_Mesh::writeFaceData_Plain(_In_ const MESHFACE * pFace, _In_opt_ const nfChar * pszAdditionalString)
 	{
 		__NMRASSERT(pFace);
 		m_nTriangleBufferPos = MODELWRITERMESH100_TRIANGLELINESTARTLENGTH;
@@ -520,7 +566,7 @@ namespace NMR {
 		m_pXMLWriter->WriteRawLine(&m_TriangleLine[0], m_nTriangleBufferPos);
 	}
 
-	void CModelWriterNode100_Mesh::writeFaceData_OneProperty(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex, _In_opt_ const nfChar * pszAdditionalString)
+	void CModelWriterNode100_Mesh::writeFaceData_OneProperty(_In_ const MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex, _In_opt_ const nfChar * pszAdditionalString)
 	{
 		__NMRASSERT(pFace);
 		m_nTriangleBufferPos = MODELWRITERMESH100_TRIANGLELINESTARTLENGTH;
@@ -543,7 +589,7 @@ namespace NMR {
 		m_pXMLWriter->WriteRawLine(&m_TriangleLine[0], m_nTriangleBufferPos);
 	}
 
-	void CModelWriterNode100_Mesh::writeFaceData_ThreeProperties(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex1, _In_ const ModelResourceIndex nPropertyIndex2, _In_ const ModelResourceIndex nPropertyIndex3, _In_opt_ const nfChar * pszAdditionalString)
+	void CModelWriterNode100_Mesh::writeFaceData_ThreeProperties(_In_ const MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex1, _In_ const ModelResourceIndex nPropertyIndex2, _In_ const ModelResourceIndex nPropertyIndex3, _In_opt_ const nfChar * pszAdditionalString)
 	{
 		__NMRASSERT(pFace);
 		m_nTriangleBufferPos = MODELWRITERMESH100_TRIANGLELINESTARTLENGTH;
@@ -575,7 +621,7 @@ namespace NMR {
 		return  fabs(a - b) * putFactor > 0.1;
 	}
 
-	__NMR_INLINE void CModelWriterNode100_Mesh::writeBeamData(_In_ MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode)
+	__NMR_INLINE void CModelWriterNode100_Mesh::writeBeamData(_In_ const MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode)
 	{
 		__NMRASSERT(pBeam);
 		m_nBeamBufferPos = MODELWRITERMESH100_BEAMLATTICE_BEAMSTARTLENGTH;
@@ -54,6 +54,8 @@ This is the class for exporting the 3mf model stream root node.
 
 #include "Common/3MF_ProgressMonitor.h"
 
+#include <algorithm>
+
 
 namespace NMR {
 
@@ -73,6 +75,10 @@ namespace NMR {
 
 		m_bIsRootModel = true;
 		m_bWriteCustomNamespaces = true;
+		m_bOptimizeVertexCache = false;
+		m_bDeduplicateMeshes = false;
+		m_bRigidMeshDeduplication = false;
+		m_nPeakTransientMemoryUsage = 0;
 
 		// register custom NameSpaces from metadata in objects, build items and the model itself
 		RegisterMetaDataNameSpaces();
@@ -94,6 +100,10 @@ namespace NMR {
 		m_bIsRootModel = false;
 		m_bWriteSliceExtension = true;
 		m_bWriteCustomNamespaces = true;
+		m_bOptimizeVertexCache = false;
+		m_bDeduplicateMeshes = false;
+		m_bRigidMeshDeduplication = false;
+		m_nPeakTransientMemoryUsage = 0;
 	}
 
 
@@ -133,6 +143,53 @@ namespace NMR {
 	}
 
 	void CModelWriterNode100_Model::writeToXML()
+	{
+		writeModelStartElement();
+
+		writeResources();
+		writeBuild();
+
+		writeFullEndElement();
+	}
+
+	void CModelWriterNode100_Model::setOptimizeVertexCache(_In_ nfBool bOptimizeVertexCache)
+	{
+		m_bOptimizeVertexCache = bOptimizeVertexCache;
+	}
+
+	void CModelWriterNode100_Model::setMeshDeduplication(_In_ nfBool bDeduplicateMeshes, _In_ nfBool bRigidTransforms)
+	{
+		m_bDeduplicateMeshes = bDeduplicateMeshes;
+		m_bRigidMeshDeduplication = bRigidTransforms;
+	}
+
+	nfUint64 CModelWriterNode100_Model::getPeakTransientMemoryUsage()
+	{
+		return m_nPeakTransientMemoryUsage;
+	}
+
+	void CModelWriterNode100_Model::writeStreamHeader()
+	{
+		if (!m_bIsRootModel)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		writeModelStartElement();
+
+		writeStartElement(XML_3MF_ELEMENT_RESOURCES);
+		writeNonObjectResources();
+	}
+
+	void CModelWriterNode100_Model::writeStreamFooter()
+	{
+		// Close resources element
+		writeFullEndElement();
+
+		writeBuild();
+
+		writeFullEndElement();
+	}
+
+	void CModelWriterNode100_Model::writeModelStartElement()
 	{
 		std::string sLanguage = m_pModel->getLanguage();
 
@@ -176,6 +233,7 @@ namespace NMR {
 			nfUint32 nNSCount = m_pXMLWriter->GetNamespaceCount();
 			for (nfUint32 iNSCount = 0; iNSCount < nNSCount; iNSCount++) {
 				writeConstPrefixedStringAttribute(XML_3MF_ATTRIBUTE_XMLNS, m_pXMLWriter->GetNamespacePrefix(iNSCount).c_str(), m_pXMLWriter->GetNamespace(iNSCount).c_str());
+				m_RootNameSpaces.insert(m_pXMLWriter->GetNamespace(iNSCount));
 			}
 		}
 
@@ -184,11 +242,6 @@ namespace NMR {
 
 		if (m_bIsRootModel)
 			writeModelMetaData();
-
-		writeResources();
-		writeBuild();
-
-		writeFullEndElement();
 	}
 
 	void CModelWriterNode100_Model::writeTextures2D()
@@ -392,111 +445,131 @@ namespace NMR {
 	{
 		std::list <CModelObject *> objectList = m_pModel->getSortedObjectList();
 
+		// Duplicates always follow the mesh object they refer to in the sorted list
+		m_MeshDuplicates.clear();
+		if (m_bDeduplicateMeshes)
+			m_pModel->findDuplicateMeshes(m_bRigidMeshDeduplication, m_MeshDuplicates);
+
 		for (auto iIterator = objectList.begin(); iIterator != objectList.end(); iIterator++) {
 
 			m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEOBJECTS);
 			m_pProgressMonitor->IncrementProgress(1);
 			m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
 
-			CModelObject * pObject = *iIterator;
+			writeObject(*iIterator);
+		}
 
-			writeStartElement(XML_3MF_ELEMENT_OBJECT);
-			// Write Object ID (mandatory)
-			writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_ID, pObject->getResourceID()->getUniqueID());
-
-			// Write Object Name (optional)
-			std::string sObjectName = pObject->getName();
-			if (sObjectName.length() > 0)
-				writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_NAME, sObjectName);
-
-			// Write Object Partnumber (optional)
-			std::string sObjectPartNumber = pObject->getPartNumber();
-			if (sObjectPartNumber.length() > 0)
-				writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_PARTNUMBER, sObjectPartNumber);
-
-			// Write Object Type (optional)
-			writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_TYPE, pObject->getObjectTypeString());
-
-			// Write Object Thumbnail (optional)
-			PModelAttachment pThumbnail = pObject->getThumbnailAttachment();
-			if (pThumbnail) {
-				PModelAttachment pModelAttachment = m_pModel->findModelAttachment(pThumbnail->getPathURI());
-				if (!pModelAttachment)
-					throw CNMRException(NMR_ERROR_NOTEXTURESTREAM);
-				if (!((pModelAttachment->getRelationShipType() == PACKAGE_TEXTURE_RELATIONSHIP_TYPE) || (pModelAttachment->getRelationShipType() == PACKAGE_THUMBNAIL_RELATIONSHIP_TYPE)))
-					throw CNMRException(NMR_ERROR_NOTEXTURESTREAM);
-
-				writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_THUMBNAIL, pThumbnail->getPathURI());
-			}
+	}
 
-			if (m_bWriteProductionExtension) {
-				if (!pObject->uuid().get())
-					throw CNMRException(NMR_ERROR_MISSINGUUID);
-				writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_PRODUCTION, XML_3MF_PRODUCTION_UUID, pObject->uuid()->toString());
-			}
+	void CModelWriterNode100_Model::writeObject(_In_ CModelObject * pObject)
+	{
+		if (pObject == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-			// Slice extension content
-			if (m_bWriteSliceExtension) {
-				if (pObject->getSliceStack().get()) {
-					writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_SLICE, XML_3MF_ATTRIBUTE_OBJECT_SLICESTACKID,
-						fnUint32ToString(pObject->getSliceStack()->getResourceID()->getUniqueID()));
-				}
-				if (pObject->slicesMeshResolution() != MODELSLICESMESHRESOLUTION_FULL) {
-					writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_SLICE, XML_3MF_ATTRIBUTE_OBJECT_MESHRESOLUTION,
-						XML_3MF_VALUE_OBJECT_MESHRESOLUTION_LOW);
-				}
+		writeStartElement(XML_3MF_ELEMENT_OBJECT);
+		writeMetaDataGroupNameSpaces(pObject->metaDataGroup());
+		// Write Object ID (mandatory)
+		writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_ID, pObject->getResourceID()->getUniqueID());
+
+		// Write Object Name (optional)
+		std::string sObjectName = pObject->getName();
+		if (sObjectName.length() > 0)
+			writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_NAME, sObjectName);
+
+		// Write Object Partnumber (optional)
+		std::string sObjectPartNumber = pObject->getPartNumber();
+		if (sObjectPartNumber.length() > 0)
+			writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_PARTNUMBER, sObjectPartNumber);
+
+		// Write Object Type (optional)
+		writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_TYPE, pObject->getObjectTypeString());
+
+		// Write Object Thumbnail (optional)
+		PModelAttachment pThumbnail = pObject->getThumbnailAttachment();
+		if (pThumbnail) {
+			PModelAttachment pModelAttachment = m_pModel->findModelAttachment(pThumbnail->getPathURI());
+			if (!pModelAttachment)
+				throw CNMRException(NMR_ERROR_NOTEXTURESTREAM);
+			if (!((pModelAttachment->getRelationShipType() == PACKAGE_TEXTURE_RELATIONSHIP_TYPE) || (pModelAttachment->getRelationShipType() == PACKAGE_THUMBNAIL_RELATIONSHIP_TYPE)))
+				throw CNMRException(NMR_ERROR_NOTEXTURESTREAM);
+
+			writeStringAttribute(XML_3MF_ATTRIBUTE_OBJECT_THUMBNAIL, pThumbnail->getPathURI());
+		}
+
+		if (m_bWriteProductionExtension) {
+			if (!pObject->uuid().get())
+				throw CNMRException(NMR_ERROR_MISSINGUUID);
+			writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_PRODUCTION, XML_3MF_PRODUCTION_UUID, pObject->uuid()->toString());
+		}
+
+		// Slice extension content
+		if (m_bWriteSliceExtension) {
+			if (pObject->getSliceStack().get()) {
+				writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_SLICE, XML_3MF_ATTRIBUTE_OBJECT_SLICESTACKID,
+					fnUint32ToString(pObject->getSliceStack()->getResourceID()->getUniqueID()));
+			}
+			if (pObject->slicesMeshResolution() != MODELSLICESMESHRESOLUTION_FULL) {
+				writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_SLICE, XML_3MF_ATTRIBUTE_OBJECT_MESHRESOLUTION,
+					XML_3MF_VALUE_OBJECT_MESHRESOLUTION_LOW);
 			}
+		}
 
-			writeMetaDataGroup(pObject->metaDataGroup());
+		writeMetaDataGroup(pObject->metaDataGroup());
 
-			// Check if object is a mesh Object
-			CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *> (pObject);
-			if (pMeshObject) {
-				// Prepare Object Level Property ID and Index
-				ModelResourceID nObjectLevelPropertyID = 0;
-				ModelResourceIndex nObjectLevelPropertyIndex = 0;
+		// Check if object is a mesh Object
+		CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *> (pObject);
+		auto iDuplicate = m_MeshDuplicates.end();
+		if (pMeshObject)
+			iDuplicate = m_MeshDuplicates.find(pMeshObject);
 
-				CMesh* pMesh = pMeshObject->getMesh();
-				
-				if (pMesh) {
-					CMeshInformationHandler * pMeshInformationHandler = pMesh->getMeshInformationHandler();
-					if (pMeshInformationHandler) {
-						// Get generic property handler
-						CMeshInformation *pInformation = pMeshInformationHandler->getInformationByType(0, emiProperties);
-						if (pInformation) {
-							auto pProperties = dynamic_cast<CMeshInformation_Properties *> (pInformation);
-							NMR::MESHINFORMATION_PROPERTIES * pDefaultData = (NMR::MESHINFORMATION_PROPERTIES*)pProperties->getDefaultData();
-							
-							if (pDefaultData && pDefaultData->m_nResourceID != 0) {
-								nObjectLevelPropertyID = pDefaultData->m_nResourceID;
-								nObjectLevelPropertyIndex = m_pPropertyIndexMapping->mapPropertyIDToIndex(nObjectLevelPropertyID, pDefaultData->m_nPropertyIDs[0]);
-							}
-						}
+		if (iDuplicate != m_MeshDuplicates.end()) {
+			writeMeshDuplicateComponents(pMeshObject, iDuplicate->second);
+		}
+		else if (pMeshObject) {
+			// Prepare Object Level Property ID and Index
+			ModelResourceID nObjectLevelPropertyID = 0;
+			ModelResourceIndex nObjectLevelPropertyIndex = 0;
 
+			CMesh* pMesh = pMeshObject->getMesh();
+			
+			if (pMesh) {
+				CMeshInformationHandler * pMeshInformationHandler = pMesh->getMeshInformationHandler();
+				if (pMeshInformationHandler) {
+					// Get generic property handler
+					CMeshInformation *pInformation = pMeshInformationHandler->getInformationByType(0, emiProperties);
+					if (pInformation) {
+						auto pProperties = dynamic_cast<CMeshInformation_Properties *> (pInformation);
+						NMR::MESHINFORMATION_PROPERTIES * pDefaultData = (NMR::MESHINFORMATION_PROPERTIES*)pProperties->getDefaultData();
+						
+						if (pDefaultData && pDefaultData->m_nResourceID != 0) {
+							nObjectLevelPropertyID = pDefaultData->m_nResourceID;
+							nObjectLevelPropertyIndex = m_pPropertyIndexMapping->mapPropertyIDToIndex(nObjectLevelPropertyID, pDefaultData->m_nPropertyIDs[0]);
+						}
 					}
-				}
 
-				// Write Object Level Attributes (only for meshes)
-				if (nObjectLevelPropertyID != 0) {
-					writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_PID, nObjectLevelPropertyID);
-					writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_PINDEX, nObjectLevelPropertyIndex);
 				}
-
-				CModelWriterNode100_Mesh ModelWriter_Mesh(pMeshObject, m_pXMLWriter, m_pProgressMonitor,
-					m_pPropertyIndexMapping, m_nDecimalPrecision, m_bWriteMaterialExtension, m_bWriteBeamLatticeExtension);
-
-				ModelWriter_Mesh.writeToXML();
 			}
 
-			// Check if object is a component Object
-			CModelComponentsObject * pComponentObject = dynamic_cast<CModelComponentsObject *> (pObject);
-			if (pComponentObject) {
-				writeComponentsObject(pComponentObject);
+			// Write Object Level Attributes (only for meshes)
+			if (nObjectLevelPropertyID != 0) {
+				writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_PID, nObjectLevelPropertyID);
+				writeIntAttribute(XML_3MF_ATTRIBUTE_OBJECT_PINDEX, nObjectLevelPropertyIndex);
 			}
 
-			writeFullEndElement();
+			CModelWriterNode100_Mesh ModelWriter_Mesh(pMeshObject, m_pXMLWriter, m_pProgressMonitor,
+				m_pPropertyIndexMapping, m_nDecimalPrecision, m_bWriteMaterialExtension, m_bWriteBeamLatticeExtension, m_bOptimizeVertexCache);
+
+			ModelWriter_Mesh.writeToXML();
+			m_nPeakTransientMemoryUsage = std::max(m_nPeakTransientMemoryUsage, ModelWriter_Mesh.getTransientMemoryUsage());
+		}
+
+		// Check if object is a component Object
+		CModelComponentsObject * pComponentObject = dynamic_cast<CModelComponentsObject *> (pObject);
+		if (pComponentObject) {
+			writeComponentsObject(pComponentObject);
 		}
 
+		writeFullEndElement();
 	}
 
 	void CModelWriterNode100_Model::writeMetaData(_In_ PModelMetaData pMetaData)
@@ -531,6 +604,27 @@ namespace NMR {
 		writeEndElement();
 	}
 
+	void CModelWriterNode100_Model::writeMetaDataGroupNameSpaces(_In_ PModelMetaDataGroup pMetaDataGroup)
+	{
+		// Objects and build items added during a streaming write may use namespaces that the model element does not declare
+		if (!m_bWriteCustomNamespaces)
+			return;
+		RegisterMetaDataGroupNameSpaces(pMetaDataGroup);
+
+		std::set<std::string> DeclaredNameSpaces = m_RootNameSpaces;
+		for (nfUint32 i = 0; i < pMetaDataGroup->getMetaDataCount(); i++) {
+			std::string sNameSpace = pMetaDataGroup->getMetaData(i)->getNameSpace();
+			if (sNameSpace.empty() || (DeclaredNameSpaces.find(sNameSpace) != DeclaredNameSpaces.end()))
+				continue;
+
+			std::string sNameSpacePrefix;
+			if (!m_pXMLWriter->GetNamespacePrefix(sNameSpace, sNameSpacePrefix))
+				throw CNMRException(NMR_ERROR_INVALIDBUFFERSIZE);
+			writeConstPrefixedStringAttribute(XML_3MF_ATTRIBUTE_XMLNS, sNameSpacePrefix.c_str(), sNameSpace.c_str());
+			DeclaredNameSpaces.insert(sNameSpace);
+		}
+	}
+
 	void CModelWriterNode100_Model::writeMetaDataGroup(_In_ PModelMetaDataGroup pMetaDataGroup)
 	{
 		if (pMetaDataGroup->getMetaDataCount() > 0)
@@ -762,6 +856,15 @@ namespace NMR {
 	{
 		writeStartElement(XML_3MF_ELEMENT_RESOURCES);
 
+		writeNonObjectResources();
+		if (m_bIsRootModel && m_bWriteObjects)
+			writeObjects();
+
+		writeFullEndElement();
+	}
+
+	void CModelWriterNode100_Model::writeNonObjectResources()
+	{
 		if (m_bIsRootModel)
 		{
 			if (m_bWriteBaseMaterials)
@@ -774,19 +877,10 @@ namespace NMR {
 				writeCompositeMaterials();
 				writeMultiProperties();
 			}
-			if (m_bWriteSliceExtension) {
-				writeSliceStacks();
-			}
-			if (m_bWriteObjects)
-				writeObjects();
 		}
-		else {
-			if (m_bWriteSliceExtension) {
-				writeSliceStacks();
-			}
+		if (m_bWriteSliceExtension) {
+			writeSliceStacks();
 		}
-		
-		writeFullEndElement();
 	}
 
 	void CModelWriterNode100_Model::writeBuild()
@@ -809,6 +903,7 @@ namespace NMR {
 				PModelBuildItem pBuildItem = m_pModel->getBuildItem(nIndex);
 
 				writeStartElement(XML_3MF_ELEMENT_ITEM);
+				writeMetaDataGroupNameSpaces(pBuildItem->metaDataGroup());
 				writeIntAttribute(XML_3MF_ATTRIBUTE_ITEM_OBJECTID, pBuildItem->getObjectID());
 				if (!pBuildItem->getPartNumber().empty())
 					writeStringAttribute(XML_3MF_ATTRIBUTE_ITEM_PARTNUMBER, pBuildItem->getPartNumber());
@@ -864,6 +959,23 @@ namespace NMR {
 	}
 
 
+	void CModelWriterNode100_Model::writeMeshDuplicateComponents(_In_ CModelMeshObject * pDuplicateObject, _In_ const MODELMESHINSTANCE & Instance)
+	{
+		__NMRASSERT(pDuplicateObject);
+		__NMRASSERT(Instance.m_pMeshObject);
+
+		writeStartElement(XML_3MF_ELEMENT_COMPONENTS);
+		writeStartElement(XML_3MF_ELEMENT_COMPONENT);
+		writeIntAttribute(XML_3MF_ATTRIBUTE_COMPONENT_OBJECTID, Instance.m_pMeshObject->getResourceID()->getUniqueID());
+		if (!fnMATRIX3_isIdentity(Instance.m_mTransform))
+			writeStringAttribute(XML_3MF_ATTRIBUTE_COMPONENT_TRANSFORM, fnMATRIX3_toString(Instance.m_mTransform));
+		// The component UUID follows from the object UUID, so that writing the same model twice gives the same output
+		if (m_bWriteProductionExtension)
+			writePrefixedStringAttribute(XML_3MF_NAMESPACEPREFIX_PRODUCTION, XML_3MF_PRODUCTION_UUID, pDuplicateObject->uuid()->derive(XML_3MF_ELEMENT_COMPONENT).toString());
+		writeEndElement();
+		writeFullEndElement();
+	}
+
 	ModelResourceID CModelWriterNode100_Model::generateOutputResourceID()
 	{
 		ModelResourceID nResourceID = m_ResourceCounter;
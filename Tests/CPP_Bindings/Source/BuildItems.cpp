@@ -165,4 +165,49 @@ namespace Lib3MF
 		ASSERT_FALSE(buildItems->MoveNext());
 	}
 
+
+	TEST_F(BuildItems, TestMeshInstances)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		mesh->SetGeometry(vertices, triangles);
+
+		auto components = pModel->AddComponentsObject();
+		sTransform t = getIdentityTransform();
+		components->AddComponent(mesh.get(), t);
+		t.m_Fields[3][2] = 10;
+		auto component = components->AddComponent(mesh.get(), t);
+
+		sTransform tItem = getIdentityTransform();
+		tItem.m_Fields[3][0] = 5;
+		pModel->AddBuildItem(components.get(), tItem);
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		auto instances = pModel->GetMeshInstances();
+		ASSERT_EQ(instances->Count(), 3);
+		Lib3MF_single expectedTranslations[3][3] = { { 5, 0, 0 }, { 5, 0, 10 }, { 0, 0, 0 } };
+		for (int i = 0; i < 3; i++) {
+			ASSERT_TRUE(instances->MoveNext());
+			EXPECT_EQ(instances->GetCurrentMeshObject()->GetResourceID(), mesh->GetResourceID());
+			EXPECT_EQ(instances->GetCurrentBuildItem()->GetObjectResourceID(), (i < 2) ? components->GetResourceID() : mesh->GetResourceID());
+			sTransform transform = instances->GetCurrentTransform();
+			for (int j = 0; j < 3; j++)
+				EXPECT_EQ(transform.m_Fields[3][j], expectedTranslations[i][j]);
+		}
+		ASSERT_FALSE(instances->MoveNext());
+
+		// A new iterator reflects component changes, an existing one keeps its instances
+		t.m_Fields[3][2] = 20;
+		component->SetTransform(t);
+		auto changedInstances = pModel->GetMeshInstances();
+		ASSERT_TRUE(changedInstances->MoveNext());
+		ASSERT_TRUE(changedInstances->MoveNext());
+		EXPECT_EQ(changedInstances->GetCurrentTransform().m_Fields[3][2], 20);
+		ASSERT_TRUE(instances->MovePrevious());
+		ASSERT_TRUE(instances->MovePrevious());
+		EXPECT_EQ(instances->GetCurrentTransform().m_Fields[3][2], 10);
+	}
+
 }
@@ -0,0 +1,151 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UnitTest_MatrixBatch.cpp: Defines Unittests for the batched matrix and triangle normal kernels,
+which are compared against the corresponding single vector functions
+
+--*/
+
+#include "gtest/gtest.h"
+#include "Common/Math/NMR_MatrixBatch.h"
+#include "Common/Math/NMR_Matrix.h"
+#include "Common/Math/NMR_Vector.h"
+#include <vector>
+
+namespace NMR
+{
+	// Counts up to two blocks of AVX vectors plus a remainder
+	const size_t nMaxBatchCount = 33;
+
+	// Deterministic coordinates in [-100, 100]
+	static std::vector<NVEC3> createVectors(size_t nCount, nfUint32 nSeed)
+	{
+		std::vector<NVEC3> Vectors(nCount);
+		for (size_t nIdx = 0; nIdx < nCount; nIdx++) {
+			for (int j = 0; j < 3; j++) {
+				nSeed = nSeed * 1664525 + 1013904223;
+				Vectors[nIdx].m_fields[j] = (nfFloat)(nSeed >> 8) / (nfFloat)(1 << 24) * 200.0f - 100.0f;
+			}
+		}
+		return Vectors;
+	}
+
+	static std::vector<NMATRIX3> createMatrices()
+	{
+		std::vector<NMATRIX3> Matrices;
+		Matrices.push_back(fnMATRIX3_identity());
+		Matrices.push_back(fnMATRIX3_translation(fnVEC3_make(1.5f, -2.25f, 1000.0f)));
+		Matrices.push_back(fnMATRIX3_scale(2.0f, 0.5f, -3.0f));
+		Matrices.push_back(fnMATRIX3_transformation(fnVEC3_make(1.0f, 2.0f, 3.0f), 0.7f, fnVEC3_make(-10.0f, 20.0f, 0.125f)));
+		return Matrices;
+	}
+
+	static void expectEqualVectors(const NVEC3 & vExpected, const NVEC3 & vActual, size_t nIdx)
+	{
+		for (int j = 0; j < 3; j++)
+			EXPECT_EQ(vExpected.m_fields[j], vActual.m_fields[j]) << "vector " << nIdx << ", coordinate " << j;
+	}
+
+	TEST(MatrixBatch, ApplyBatch)
+	{
+		std::vector<NMATRIX3> Matrices = createMatrices();
+		for (auto iMatrix = Matrices.begin(); iMatrix != Matrices.end(); iMatrix++) {
+			for (size_t nCount = 0; nCount <= nMaxBatchCount; nCount++) {
+				std::vector<NVEC3> Source = createVectors(nCount, (nfUint32)nCount);
+				// One more vector than transformed, which must stay untouched
+				std::vector<NVEC3> Target(nCount + 1, fnVEC3_make(7.0f, 7.0f, 7.0f));
+				fnMATRIX3_applyBatch(*iMatrix, Source.data(), Target.data(), nCount);
+
+				for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+					expectEqualVectors(fnMATRIX3_apply(*iMatrix, Source[nIdx]), Target[nIdx], nIdx);
+				expectEqualVectors(fnVEC3_make(7.0f, 7.0f, 7.0f), Target[nCount], nCount);
+			}
+		}
+	}
+
+	TEST(MatrixBatch, ApplyBatchInPlace)
+	{
+		std::vector<NMATRIX3> Matrices = createMatrices();
+		for (auto iMatrix = Matrices.begin(); iMatrix != Matrices.end(); iMatrix++) {
+			for (size_t nCount = 0; nCount <= nMaxBatchCount; nCount++) {
+				std::vector<NVEC3> Source = createVectors(nCount, (nfUint32)nCount + 100);
+				std::vector<NVEC3> Vectors = Source;
+				fnMATRIX3_applyBatch(*iMatrix, Vectors.data(), Vectors.data(), nCount);
+
+				for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+					expectEqualVectors(fnMATRIX3_apply(*iMatrix, Source[nIdx]), Vectors[nIdx], nIdx);
+			}
+		}
+	}
+
+	TEST(MatrixBatch, CalcTriangleNormalBatch)
+	{
+		for (size_t nCount = 0; nCount <= nMaxBatchCount; nCount++) {
+			std::vector<NVEC3> Vertices = createVectors(3 * nCount, (nfUint32)nCount + 200);
+			// Every third triangle is degenerate: repeated corners, collinear corners or a tiny area
+			for (size_t nIdx = 0; nIdx < nCount; nIdx += 3) {
+				NVEC3 * pCorners = &Vertices[3 * nIdx];
+				switch ((nIdx / 3) % 3) {
+				case 0:
+					pCorners[1] = pCorners[0];
+					break;
+				case 1:
+					pCorners[2] = fnVEC3_add(pCorners[1], fnVEC3_sub(pCorners[1], pCorners[0]));
+					break;
+				default:
+					pCorners[1] = fnVEC3_add(pCorners[0], fnVEC3_make(1.0E-6f, 0.0f, 0.0f));
+					pCorners[2] = fnVEC3_add(pCorners[0], fnVEC3_make(0.0f, 1.0E-6f, 0.0f));
+					break;
+				}
+			}
+
+			std::vector<NVEC3> Normals(nCount + 1, fnVEC3_make(7.0f, 7.0f, 7.0f));
+			fnVEC3_calcTriangleNormalBatch(Vertices.data(), Normals.data(), nCount);
+
+			for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+				expectEqualVectors(fnVEC3_calcTriangleNormal(Vertices[3 * nIdx], Vertices[3 * nIdx + 1], Vertices[3 * nIdx + 2]), Normals[nIdx], nIdx);
+			expectEqualVectors(fnVEC3_make(7.0f, 7.0f, 7.0f), Normals[nCount], nCount);
+		}
+	}
+
+	TEST(MatrixBatch, CalcTriangleNormalBatchInPlace)
+	{
+		// The normals overwrite the first corners of the input
+		for (size_t nCount = 0; nCount <= nMaxBatchCount; nCount++) {
+			std::vector<NVEC3> Source = createVectors(3 * nCount, (nfUint32)nCount + 300);
+			if (nCount > 0)
+				Source[1] = Source[0];
+			std::vector<NVEC3> Vertices = Source;
+			fnVEC3_calcTriangleNormalBatch(Vertices.data(), Vertices.data(), nCount);
+
+			for (size_t nIdx = 0; nIdx < nCount; nIdx++)
+				expectEqualVectors(fnVEC3_calcTriangleNormal(Source[3 * nIdx], Source[3 * nIdx + 1], Source[3 * nIdx + 2]), Vertices[nIdx], nIdx);
+		}
+	}
+
+}
@@ -65,6 +65,18 @@ namespace Lib3MF
 		EXPECT_EQ(p1->GetMultiPropertyGroups()->Count(), p2->GetMultiPropertyGroups()->Count());
 	}
 
+	// Strip of nTriangleCount triangles along the x axis
+	void CreateTriangleStrip(PMeshObject pMesh, Lib3MF_uint32 nTriangleCount)
+	{
+		std::vector<sPosition> vertices(nTriangleCount + 2);
+		std::vector<sTriangle> triangles(nTriangleCount);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount + 2; i++)
+			vertices[i] = fnCreateVertex(0.5f * (i / 2), (float)(i % 2), 0.0f);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++)
+			triangles[i] = (i % 2) ? fnCreateTriangle(i, i + 2, i + 1) : fnCreateTriangle(i, i + 1, i + 2);
+		pMesh->SetGeometry(vertices, triangles);
+	}
+
 	TEST_F(MergeModels, MergeModel)
 	{
 		std::vector<Lib3MF_uint8> buffer;
@@ -88,4 +100,329 @@ namespace Lib3MF
 		ExpectEqModels(m_pModel, pReadModel);
 	}
 
+	TEST_F(MergeModels, MergeToModelLargeSparseProperties)
+	{
+		// Large enough to merge on several threads, with properties which stay run-length compressed
+		const Lib3MF_uint32 nTriangleCount = 200000;
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		CreateTriangleStrip(mesh, nTriangleCount);
+
+		auto baseMaterialGroup = pModel->AddBaseMaterialGroup();
+		auto someMaterial = baseMaterialGroup->AddMaterial("SomeMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+		auto anotherMaterial = baseMaterialGroup->AddMaterial("AnotherMaterial", wrapper->RGBAToColor(200, 100, 150, 255));
+
+		sTriangleProperties properties;
+		properties.m_ResourceID = baseMaterialGroup->GetResourceID();
+		for (int j = 0; j < 3; j++)
+			properties.m_PropertyIDs[j] = someMaterial;
+		std::vector<sTriangleProperties> allProperties(nTriangleCount, properties);
+		mesh->SetAllTriangleProperties(allProperties);
+		for (int j = 0; j < 3; j++)
+			properties.m_PropertyIDs[j] = anotherMaterial;
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i += 1000)
+			mesh->SetTriangleProperties(i, properties);
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		auto pMergedModel = pModel->MergeToModel();
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(mergedMesh->GetTriangleCount(), nTriangleCount);
+		auto mergedGroups = pMergedModel->GetBaseMaterialGroups();
+		ASSERT_TRUE(mergedGroups->MoveNext());
+		Lib3MF_uint32 nMergedResourceID = mergedGroups->GetCurrentBaseMaterialGroup()->GetResourceID();
+
+		std::vector<sTriangleProperties> mergedProperties;
+		mergedMesh->GetAllTriangleProperties(mergedProperties);
+		Lib3MF_uint32 nMismatchCount = 0;
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			Lib3MF_uint32 nExpectedPropertyID = (i % 1000 == 0) ? anotherMaterial : someMaterial;
+			if ((mergedProperties[i].m_ResourceID != nMergedResourceID) || (mergedProperties[i].m_PropertyIDs[0] != nExpectedPropertyID) ||
+				(mergedProperties[i].m_PropertyIDs[1] != nExpectedPropertyID) || (mergedProperties[i].m_PropertyIDs[2] != nExpectedPropertyID))
+				nMismatchCount++;
+		}
+		EXPECT_EQ(nMismatchCount, 0);
+	}
+
+	TEST_F(MergeModels, MergeToModelInvalidCoordinates)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		CreateTriangleStrip(mesh, 100);
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		// The second instance moves its vertices out of the valid coordinate range
+		sTransform t = getIdentityTransform();
+		t.m_Fields[3][0] = 2.0E9f;
+		auto buildItem = pModel->AddBuildItem(mesh.get(), t);
+		ASSERT_SPECIFIC_THROW(pModel->MergeToModel(), ELib3MFException);
+
+		// The failed merge leaves the model as it was, and merging again after fixing the input succeeds
+		EXPECT_EQ(mesh->GetVertexCount(), 102);
+		EXPECT_EQ(mesh->GetTriangleCount(), 100);
+		EXPECT_EQ(mesh->GetVertex(101).m_Coordinates[0], 25.0f);
+		EXPECT_EQ(pModel->GetBuildItems()->Count(), 2);
+
+		t.m_Fields[3][0] = 100.0f;
+		buildItem->SetObjectTransform(t);
+		auto pMergedModel = pModel->MergeToModel();
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(mergedMesh->GetVertexCount(), 204);
+		ASSERT_EQ(mergedMesh->GetTriangleCount(), 200);
+		EXPECT_EQ(mergedMesh->GetVertex(101).m_Coordinates[0], 25.0f);
+		EXPECT_EQ(mergedMesh->GetVertex(203).m_Coordinates[0], 125.0f);
+		EXPECT_EQ(mergedMesh->GetTriangle(100).m_Indices[0], 102);
+	}
+
+	TEST_F(MergeModels, MergeToModelQuantized)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.125f, 0.0f, 0.0f } }, { { 0.0f, 1.3333f, 0.0f } }, { { 0.0f, 0.0f, 1.7f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		mesh->SetGeometry(vertices, triangles);
+		ASSERT_TRUE(mesh->QuantizeVertices(3));
+
+		sTransform t = getIdentityTransform();
+		for (int i = 0; i < 3; i++)
+			t.m_Fields[i][i] = 2.0f;
+		t.m_Fields[3][2] = 10.0f;
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+		pModel->AddBuildItem(mesh.get(), t);
+
+		auto pMergedModel = pModel->MergeToModel();
+		ASSERT_TRUE(mesh->HasQuantizedVertices());
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(mergedMesh->GetVertexCount(), 8);
+		ASSERT_EQ(mergedMesh->GetTriangleCount(), 8);
+
+		// Merged vertices are the stored fixed point positions, transformed per instance
+		for (Lib3MF_uint32 i = 0; i < 4; i++) {
+			sPosition source = mesh->GetVertex(i);
+			sPosition first = mergedMesh->GetVertex(i);
+			sPosition second = mergedMesh->GetVertex(i + 4);
+			for (int j = 0; j < 3; j++) {
+				EXPECT_EQ(first.m_Coordinates[j], source.m_Coordinates[j]);
+				EXPECT_FLOAT_EQ(second.m_Coordinates[j], 2.0f * source.m_Coordinates[j] + ((j == 2) ? 10.0f : 0.0f));
+			}
+		}
+		EXPECT_FLOAT_EQ(mergedMesh->GetVertex(2).m_Coordinates[1], 1.333f);
+		EXPECT_EQ(mergedMesh->GetTriangle(7).m_Indices[0], 5);
+	}
+
+	TEST_F(MergeModels, MergeToModelThreadedProperties)
+	{
+		// Several instances of the same meshes, with more than two threads worth of faces in total.
+		// Each instance has properties, which are copied range by range in instance order.
+		const Lib3MF_uint32 nTriangleCount = 70000;
+		auto pModel = wrapper->CreateModel();
+		auto baseMaterialGroup = pModel->AddBaseMaterialGroup();
+		Lib3MF_uint32 materials[3];
+		materials[0] = baseMaterialGroup->AddMaterial("Material0", wrapper->RGBAToColor(255, 0, 0, 255));
+		materials[1] = baseMaterialGroup->AddMaterial("Material1", wrapper->RGBAToColor(0, 255, 0, 255));
+		materials[2] = baseMaterialGroup->AddMaterial("Material2", wrapper->RGBAToColor(0, 0, 255, 255));
+
+		auto stripedMesh = pModel->AddMeshObject();
+		CreateTriangleStrip(stripedMesh, nTriangleCount);
+		std::vector<sTriangleProperties> stripedProperties(nTriangleCount);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			stripedProperties[i].m_ResourceID = baseMaterialGroup->GetResourceID();
+			for (int j = 0; j < 3; j++)
+				stripedProperties[i].m_PropertyIDs[j] = materials[(i / 7) % 3];
+		}
+		stripedMesh->SetAllTriangleProperties(stripedProperties);
+
+		auto uniformMesh = pModel->AddMeshObject();
+		CreateTriangleStrip(uniformMesh, nTriangleCount);
+		sTriangleProperties uniformProperties;
+		uniformProperties.m_ResourceID = baseMaterialGroup->GetResourceID();
+		for (int j = 0; j < 3; j++)
+			uniformProperties.m_PropertyIDs[j] = materials[2];
+		uniformMesh->SetAllTriangleProperties(std::vector<sTriangleProperties>(nTriangleCount, uniformProperties));
+
+		sTransform t = getIdentityTransform();
+		pModel->AddBuildItem(stripedMesh.get(), t);
+		t.m_Fields[3][1] = 10.0f;
+		pModel->AddBuildItem(uniformMesh.get(), t);
+		t.m_Fields[3][1] = 20.0f;
+		pModel->AddBuildItem(stripedMesh.get(), t);
+
+		auto pMergedModel = pModel->MergeToModel();
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(mergedMesh->GetVertexCount(), 3 * (nTriangleCount + 2));
+		ASSERT_EQ(mergedMesh->GetTriangleCount(), 3 * nTriangleCount);
+		auto mergedGroups = pMergedModel->GetBaseMaterialGroups();
+		ASSERT_TRUE(mergedGroups->MoveNext());
+		Lib3MF_uint32 nMergedResourceID = mergedGroups->GetCurrentBaseMaterialGroup()->GetResourceID();
+
+		std::vector<sTriangleProperties> mergedProperties;
+		mergedMesh->GetAllTriangleProperties(mergedProperties);
+		std::vector<sPosition> mergedVertices;
+		mergedMesh->GetVertices(mergedVertices);
+		std::vector<sTriangle> mergedTriangles;
+		mergedMesh->GetTriangleIndices(mergedTriangles);
+
+		Lib3MF_uint32 nMismatchCount = 0;
+		for (Lib3MF_uint32 nInstance = 0; nInstance < 3; nInstance++) {
+			Lib3MF_uint32 nVertexOffset = nInstance * (nTriangleCount + 2);
+			for (Lib3MF_uint32 i = 0; i < nTriangleCount + 2; i++) {
+				const sPosition & vertex = mergedVertices[nVertexOffset + i];
+				if ((vertex.m_Coordinates[0] != 0.5f * (i / 2)) || (vertex.m_Coordinates[1] != (float)(i % 2) + 10.0f * nInstance))
+					nMismatchCount++;
+			}
+			for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+				Lib3MF_uint32 nFace = nInstance * nTriangleCount + i;
+				Lib3MF_uint32 nExpectedPropertyID = (nInstance == 1) ? materials[2] : materials[(i / 7) % 3];
+				if ((mergedTriangles[nFace].m_Indices[0] != nVertexOffset + i) || (mergedProperties[nFace].m_ResourceID != nMergedResourceID) ||
+					(mergedProperties[nFace].m_PropertyIDs[0] != nExpectedPropertyID) || (mergedProperties[nFace].m_PropertyIDs[2] != nExpectedPropertyID))
+					nMismatchCount++;
+			}
+		}
+		EXPECT_EQ(nMismatchCount, 0);
+	}
+
+	TEST_F(MergeModels, MergeToInstancedModel)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		mesh->SetGeometry(vertices, triangles);
+		mesh->SetName("Tetrahedron");
+
+		auto components = pModel->AddComponentsObject();
+		sTransform t = getIdentityTransform();
+		components->AddComponent(mesh.get(), t);
+		t.m_Fields[3][2] = 10;
+		components->AddComponent(mesh.get(), t);
+
+		sTransform tItem = getIdentityTransform();
+		tItem.m_Fields[3][0] = 5;
+		pModel->AddBuildItem(components.get(), tItem);
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		auto pMergedModel = pModel->MergeToInstancedModel();
+		EXPECT_EQ(pMergedModel->GetMeshObjects()->Count(), 1);
+		EXPECT_EQ(pMergedModel->GetComponentsObjects()->Count(), 0);
+		EXPECT_EQ(pMergedModel->GetBuildItems()->Count(), 3);
+
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+		EXPECT_EQ(mergedMesh->GetName(), "Tetrahedron");
+		EXPECT_EQ(mergedMesh->GetVertexCount(), 4);
+		EXPECT_EQ(mergedMesh->GetTriangleCount(), 4);
+
+		auto buildItems = pMergedModel->GetBuildItems();
+		ASSERT_TRUE(buildItems->MoveNext());
+		auto transform = buildItems->GetCurrent()->GetObjectTransform();
+		EXPECT_EQ(transform.m_Fields[3][0], 5.0f);
+		EXPECT_EQ(transform.m_Fields[3][2], 0.0f);
+		ASSERT_TRUE(buildItems->MoveNext());
+		transform = buildItems->GetCurrent()->GetObjectTransform();
+		EXPECT_EQ(transform.m_Fields[3][0], 5.0f);
+		EXPECT_EQ(transform.m_Fields[3][2], 10.0f);
+		ASSERT_TRUE(buildItems->MoveNext());
+		EXPECT_EQ(buildItems->GetCurrent()->GetObjectResourceID(), mergedMesh->GetResourceID());
+	}
+
+	TEST_F(MergeModels, MergeToInstancedModelObjectAttributes)
+	{
+		auto pModel = wrapper->CreateModel();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		auto clippingMesh = pModel->AddMeshObject();
+		clippingMesh->SetGeometry(vertices, triangles);
+		auto mesh = pModel->AddMeshObject();
+		mesh->SetGeometry(vertices, triangles);
+		mesh->SetUUID("a6f4b8d2-3c1e-4f5a-9b7d-2e8c0f1a3b5d");
+		mesh->GetMetaDataGroup()->AddMetaData("http://www.example.com/merge", "Origin", "Source", "xs:string", false);
+
+		std::string sThumbnailPath("/Metadata/thumbnail.png");
+		std::vector<Lib3MF_uint8> thumbnailData = { 0x89, 0x50, 0x4E, 0x47 };
+		auto attachment = pModel->AddAttachment(sThumbnailPath, "http://schemas.openxmlformats.org/package/2006/relationships/metadata/thumbnail");
+		attachment->ReadFromBuffer(thumbnailData);
+		mesh->SetAttachmentAsThumbnail(attachment.get());
+
+		auto beamLattice = mesh->BeamLattice();
+		beamLattice->SetMinLength(0.5);
+		beamLattice->SetClipping(eBeamLatticeClipMode::Inside, clippingMesh->GetResourceID());
+		beamLattice->SetRepresentation(clippingMesh->GetResourceID());
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		auto pMergedModel = pModel->MergeToInstancedModel();
+		EXPECT_EQ(pMergedModel->GetBuildItems()->Count(), 1);
+
+		// The clipping mesh is copied as well, ahead of the object which refers to it
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_EQ(meshObjects->Count(), 2);
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedClippingMesh = meshObjects->GetCurrentMeshObject();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+
+		bool bHasUUID = false;
+		EXPECT_EQ(mergedMesh->GetUUID(bHasUUID), "a6f4b8d2-3c1e-4f5a-9b7d-2e8c0f1a3b5d");
+		EXPECT_TRUE(bHasUUID);
+
+		auto metaDataGroup = mergedMesh->GetMetaDataGroup();
+		ASSERT_EQ(metaDataGroup->GetMetaDataCount(), 1);
+		EXPECT_EQ(metaDataGroup->GetMetaDataByKey("http://www.example.com/merge", "Origin")->GetValue(), "Source");
+
+		auto thumbnail = mergedMesh->GetThumbnailAttachment();
+		ASSERT_TRUE(thumbnail != nullptr);
+		EXPECT_EQ(thumbnail->GetPath(), sThumbnailPath);
+		EXPECT_EQ(thumbnail->GetStreamSize(), thumbnailData.size());
+
+		auto mergedBeamLattice = mergedMesh->BeamLattice();
+		EXPECT_EQ(mergedBeamLattice->GetMinLength(), 0.5);
+		eBeamLatticeClipMode eClipMode;
+		Lib3MF_uint32 nResourceID;
+		mergedBeamLattice->GetClipping(eClipMode, nResourceID);
+		EXPECT_EQ(eClipMode, eBeamLatticeClipMode::Inside);
+		EXPECT_EQ(nResourceID, mergedClippingMesh->GetResourceID());
+		ASSERT_TRUE(mergedBeamLattice->GetRepresentation(nResourceID));
+		EXPECT_EQ(nResourceID, mergedClippingMesh->GetResourceID());
+
+		std::vector<Lib3MF_uint8> buffer;
+		pMergedModel->QueryWriter("3mf")->WriteToBuffer(buffer);
+	}
+
+	TEST_F(MergeModels, MergeToInstancedModelCopyOnWrite)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto mesh = pModel->AddMeshObject();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		mesh->SetGeometry(vertices, triangles);
+		pModel->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		auto pMergedModel = pModel->MergeToInstancedModel();
+		auto meshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_TRUE(meshObjects->MoveNext());
+		auto mergedMesh = meshObjects->GetCurrentMeshObject();
+
+		// Editing the merged mesh leaves the source mesh unchanged and vice versa
+		sPosition position = { { 2.0f, 0.0f, 0.0f } };
+		mergedMesh->SetVertex(1, position);
+		EXPECT_EQ(mergedMesh->GetVertex(1).m_Coordinates[0], 2.0f);
+		EXPECT_EQ(mesh->GetVertex(1).m_Coordinates[0], 1.0f);
+
+		sTriangle triangle = { { 0, 1, 2 } };
+		mesh->SetTriangle(0, triangle);
+		EXPECT_EQ(mesh->GetTriangle(0).m_Indices[1], 1);
+		EXPECT_EQ(mergedMesh->GetTriangle(0).m_Indices[1], 2);
+
+		mesh->AddVertex(position);
+		EXPECT_EQ(mesh->GetVertexCount(), 5);
+		EXPECT_EQ(mergedMesh->GetVertexCount(), 4);
+	}
+
 }
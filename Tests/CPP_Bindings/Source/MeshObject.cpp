@@ -191,11 +191,144 @@ namespace Lib3MF
 		
 	}
 
+	TEST_F(MeshObject, GeometryDataViews)
+	{
+		Lib3MF_uint32 nCount, nStride;
+		ASSERT_EQ(mesh->GetVertexData(nCount, nStride), nullptr);
+		ASSERT_EQ(nCount, 0);
+
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		auto pVertexData = reinterpret_cast<const Lib3MF_uint8 *>(mesh->GetVertexData(nCount, nStride));
+		ASSERT_EQ(nCount, 8);
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			const Lib3MF_single * pCoordinates = reinterpret_cast<const Lib3MF_single *>(pVertexData + i * nStride);
+			for (int j = 0; j < 3; j++)
+				ASSERT_EQ(pCoordinates[j], pVertices[i].m_Coordinates[j]);
+		}
+
+		auto pIndexData = reinterpret_cast<const Lib3MF_uint8 *>(mesh->GetTriangleIndexData(nCount, nStride));
+		ASSERT_EQ(nCount, 12);
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			const Lib3MF_uint32 * pIndices = reinterpret_cast<const Lib3MF_uint32 *>(pIndexData + i * nStride);
+			for (int j = 0; j < 3; j++)
+				ASSERT_EQ(pIndices[j], pTriangles[i].m_Indices[j]);
+		}
+	}
+
+	TEST_F(MeshObject, QuantizedVertices)
+	{
+		ASSERT_FALSE(mesh->QuantizeVertices(3));
+		ASSERT_SPECIFIC_THROW(mesh->QuantizeVertices(0), ELib3MFException);
+
+		// Coordinates with more digits than the precision, which the writer truncates
+		sPosition pFractionalVertices[8];
+		for (Lib3MF_uint32 i = 0; i < 8; i++) {
+			for (int j = 0; j < 3; j++)
+				pFractionalVertices[i].m_Coordinates[j] = pVertices[i].m_Coordinates[j] * 0.01f + 0.123456f * (i + 1);
+		}
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pFractionalVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		model->AddBuildItem(mesh.get(), getIdentityTransform());
+		auto writer = model->QueryWriter("3mf");
+		writer->SetDecimalPrecision(3);
+		std::vector<Lib3MF_uint8> floatBuffer;
+		writer->WriteToBuffer(floatBuffer);
+
+		ASSERT_TRUE(mesh->QuantizeVertices(3));
+		ASSERT_TRUE(mesh->HasQuantizedVertices());
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+		for (Lib3MF_uint32 i = 0; i < 8; i++) {
+			sPosition vertex = mesh->GetVertex(i);
+			for (int j = 0; j < 3; j++)
+				ASSERT_NEAR(vertex.m_Coordinates[j], pFractionalVertices[i].m_Coordinates[j], 1E-3);
+		}
+
+		// Writing with the same precision gives the same vertex elements and thus the same package
+		std::vector<Lib3MF_uint8> quantizedBuffer;
+		writer->WriteToBuffer(quantizedBuffer);
+		ASSERT_TRUE(floatBuffer == quantizedBuffer);
+		ASSERT_TRUE(mesh->HasQuantizedVertices());
+
+		// Modifying a vertex returns the mesh to float storage
+		mesh->SetVertex(0, pFractionalVertices[0]);
+		ASSERT_FALSE(mesh->HasQuantizedVertices());
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+	}
+
+	TEST_F(MeshObject, QuantizedVerticesExtent)
+	{
+		// The range is taken from the extent of the mesh, which may be far from the origin
+		sPosition pLargeVertices[8];
+		for (Lib3MF_uint32 i = 0; i < 8; i++) {
+			for (int j = 0; j < 3; j++)
+				pLargeVertices[i].m_Coordinates[j] = pVertices[i].m_Coordinates[j] * 10.0f + 5000.0f + 0.123456f * (i + 1);
+		}
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pLargeVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		ASSERT_TRUE(mesh->QuantizeVertices(6));
+
+		// Reading the vertices decodes them without leaving the quantized storage
+		std::vector<sPosition> vertices;
+		mesh->GetVertices(vertices);
+		ASSERT_EQ(vertices.size(), 8);
+		for (Lib3MF_uint32 i = 0; i < 8; i++) {
+			sPosition vertex = mesh->GetVertex(i);
+			for (int j = 0; j < 3; j++) {
+				ASSERT_EQ(vertex.m_Coordinates[j], vertices[i].m_Coordinates[j]);
+				ASSERT_NEAR(vertex.m_Coordinates[j], pLargeVertices[i].m_Coordinates[j], 1E-3);
+			}
+		}
+		ASSERT_TRUE(mesh->HasQuantizedVertices());
+	}
+
+	TEST_F(MeshObject, BulkGeometryOperations)
+	{
+		ASSERT_EQ(mesh->AddVertices(CLib3MFInputVector<sPosition>(pVertices, 4)), 0);
+		ASSERT_EQ(mesh->AddVertices(CLib3MFInputVector<sPosition>(&pVertices[4], 4)), 4);
+		ASSERT_EQ(mesh->AddTriangles(CLib3MFInputVector<sTriangle>(pTriangles, 12)), 0);
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+		ASSERT_EQ(mesh->GetTriangleCount(), 12);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		// Invalid triangles are rejected as a whole
+		sTriangle pInvalidTriangles[2] = { fnCreateTriangle(0, 1, 2), fnCreateTriangle(0, 1, 8) };
+		ASSERT_SPECIFIC_THROW(mesh->AddTriangles(CLib3MFInputVector<sTriangle>(pInvalidTriangles, 2)), ELib3MFException);
+		pInvalidTriangles[1] = fnCreateTriangle(3, 3, 4);
+		ASSERT_SPECIFIC_THROW(mesh->AddTriangles(CLib3MFInputVector<sTriangle>(pInvalidTriangles, 2)), ELib3MFException);
+		ASSERT_EQ(mesh->GetTriangleCount(), 12);
+
+		sPosition pInvalidVertices[2] = { fnCreateVertex(0.0f, 0.0f, 0.0f), fnCreateVertex(0.0f, 1.0e10f, 0.0f) };
+		ASSERT_SPECIFIC_THROW(mesh->AddVertices(CLib3MFInputVector<sPosition>(pInvalidVertices, 2)), ELib3MFException);
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+	}
+
 	TEST_F(MeshObject, IsManifoldAndOriented)
 	{
 		ASSERT_FALSE(mesh->IsManifoldAndOriented());
 		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
 		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		// A flipped triangle breaks the orientation
+		mesh->SetTriangle(0, fnCreateTriangle(0, 1, 2));
+		ASSERT_FALSE(mesh->IsManifoldAndOriented());
+		mesh->SetTriangle(0, pTriangles[0]);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		// A vertex out of the coordinate range makes the mesh invalid
+		mesh->SetVertex(0, fnCreateVertex(2.0E9f, 0.0f, 0.0f));
+		ASSERT_FALSE(mesh->IsManifoldAndOriented());
+		mesh->SetVertex(0, pVertices[0]);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		// A duplicated triangle makes its edges non-manifold
+		mesh->AddTriangle(pTriangles[0]);
+		ASSERT_FALSE(mesh->IsManifoldAndOriented());
+
+		// New geometry replaces the result of the previous check
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 11));
+		ASSERT_FALSE(mesh->IsManifoldAndOriented());
 	}
 
 	TEST_F(MeshObject, IsValid)
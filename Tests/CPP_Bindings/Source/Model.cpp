@@ -80,6 +80,99 @@ namespace Lib3MF
 		ASSERT_FALSE(m_pModel->GetLanguage().compare(otherLanguage));
 	}
 
+	TEST_F(Model, Set_GetUseMemoryArena)
+	{
+		Lib3MF_uint64 nReservedSize;
+		ASSERT_FALSE(m_pModel->GetUseMemoryArena());
+		ASSERT_EQ(m_pModel->GetMemoryArenaUsage(nReservedSize), 0);
+		ASSERT_EQ(nReservedSize, 0);
+		m_pModel->SetUseMemoryArena(true);
+		ASSERT_TRUE(m_pModel->GetUseMemoryArena());
+		ASSERT_EQ(m_pModel->GetMemoryArenaUsage(nReservedSize), 0);
+
+		auto sliceStack = m_pModel->AddSliceStack(0.0);
+		auto slice = sliceStack->AddSlice(1.0);
+		std::vector<sPosition2D> vertices = { { 0, 0 }, { 1, 0 }, { 1, 1 } };
+		slice->SetVertices(vertices);
+		std::vector<Lib3MF_uint32> indices = { 0, 1, 2, 0 };
+		slice->AddPolygon(indices);
+
+		// Slice data is allocated from the arena
+		Lib3MF_uint64 nSliceUsedSize = m_pModel->GetMemoryArenaUsage(nReservedSize);
+		ASSERT_GE(nSliceUsedSize, 3 * sizeof(sPosition2D) + 4 * sizeof(Lib3MF_uint32));
+		ASSERT_GE(nReservedSize, nSliceUsedSize);
+
+		// Beams are allocated from the arena as well. Replacing them reuses the freed blocks, so the arena does not grow.
+		auto mesh = m_pModel->AddMeshObject();
+		std::vector<sPosition> meshVertices(1000);
+		std::vector<sBeam> beams(999);
+		for (Lib3MF_uint32 i = 0; i < 1000; i++)
+			meshVertices[i] = { { (Lib3MF_single)i, 0.0f, 0.0f } };
+		for (Lib3MF_uint32 i = 0; i < 999; i++) {
+			beams[i].m_Indices[0] = i;
+			beams[i].m_Indices[1] = i + 1;
+			beams[i].m_Radii[0] = 1.0;
+			beams[i].m_Radii[1] = 1.0;
+			beams[i].m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+			beams[i].m_CapModes[1] = eBeamLatticeCapMode::Sphere;
+		}
+		mesh->SetGeometry(meshVertices, std::vector<sTriangle>());
+		auto beamLattice = mesh->BeamLattice();
+		beamLattice->SetBeams(beams);
+		Lib3MF_uint64 nBeamReservedSize;
+		Lib3MF_uint64 nBeamUsedSize = m_pModel->GetMemoryArenaUsage(nBeamReservedSize);
+		ASSERT_GT(nBeamUsedSize, nSliceUsedSize);
+		for (int i = 0; i < 10; i++)
+			beamLattice->SetBeams(beams);
+		ASSERT_EQ(m_pModel->GetMemoryArenaUsage(nReservedSize), nBeamUsedSize);
+		ASSERT_EQ(nReservedSize, nBeamReservedSize);
+
+		// Slices outlive the arena switch and keep their data
+		m_pModel->SetUseMemoryArena(false);
+		ASSERT_FALSE(m_pModel->GetUseMemoryArena());
+		ASSERT_EQ(m_pModel->GetMemoryArenaUsage(nReservedSize), 0);
+		ASSERT_EQ(slice->GetVertexCount(), 3);
+		ASSERT_EQ(slice->GetPolygonIndexCount(0), 4);
+	}
+
+	TEST_F(Model, GetMemoryUsage)
+	{
+		Lib3MF_uint64 nResourceMemory, nAttachmentMemory;
+		Lib3MF_uint64 nEmptyMemory = m_pModel->GetMemoryUsage(nResourceMemory, nAttachmentMemory);
+		ASSERT_EQ(nResourceMemory, 0);
+		ASSERT_EQ(nAttachmentMemory, 0);
+		m_pModel->SetTrackPeakMemoryUsage(true);
+
+		auto mesh = m_pModel->AddMeshObject();
+		std::vector<sPosition> vertices(100);
+		std::vector<sTriangle> triangles(100);
+		for (Lib3MF_uint32 i = 0; i < 100; i++) {
+			vertices[i] = { { (Lib3MF_single)i, 0.0f, 0.0f } };
+			triangles[i] = { { i, (i + 1) % 100, (i + 2) % 100 } };
+		}
+		mesh->SetGeometry(vertices, triangles);
+
+		Lib3MF_uint64 nMemory = m_pModel->GetMemoryUsage(nResourceMemory, nAttachmentMemory);
+		ASSERT_GT(nMemory, nEmptyMemory);
+		ASSERT_GE(nResourceMemory, mesh->GetMemoryUsage());
+		ASSERT_GE(mesh->GetMemoryUsage(), 100 * (sizeof(sPosition) + sizeof(sTriangle)));
+
+		std::vector<Lib3MF_uint8> buffer;
+		m_pModel->QueryWriter("3mf")->WriteToBuffer(buffer);
+		ASSERT_GE(m_pModel->GetPeakMemoryUsage(), nMemory);
+
+		// Reading samples the model after every object
+		auto readModel = wrapper->CreateModel();
+		readModel->SetTrackPeakMemoryUsage(true);
+		readModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+		Lib3MF_uint64 nReadMemory = readModel->GetMemoryUsage(nResourceMemory, nAttachmentMemory);
+		ASSERT_GE(nResourceMemory, 100 * (sizeof(sPosition) + sizeof(sTriangle)));
+		ASSERT_GE(readModel->GetPeakMemoryUsage(), nReadMemory);
+
+		m_pModel->SetTrackPeakMemoryUsage(false);
+		ASSERT_EQ(m_pModel->GetPeakMemoryUsage(), 0);
+	}
+
 
 	TEST_F(Model, GetBuildItems)
 	{
@@ -82,6 +82,27 @@ namespace Lib3MF
 		CompareBoxes(sOutbox, sExpectedOutbox);
 	}
 
+	TEST_F(Outbox, CheckMeshAfterModification)
+	{
+		auto meshes = model->GetMeshObjects();
+		meshes->MoveNext();
+		auto mesh = meshes->GetCurrentMeshObject();
+		Lib3MF::sBox sOutbox = mesh->GetOutbox();
+
+		// Added vertices extend the box
+		sPosition vertex = { { 200.0f, 1.0f, 50.0f } };
+		Lib3MF_uint32 nIndex = mesh->AddVertex(vertex);
+		Lib3MF::sBox sExpectedOutbox = sOutbox;
+		sExpectedOutbox.m_MinCoordinate[1] = 1.0f;
+		sExpectedOutbox.m_MaxCoordinate[0] = 200.0f;
+		CompareBoxes(mesh->GetOutbox(), sExpectedOutbox);
+
+		// Moving a vertex back inside shrinks it again
+		vertex = { { 50.0f, 50.0f, 50.0f } };
+		mesh->SetVertex(nIndex, vertex);
+		CompareBoxes(mesh->GetOutbox(), sOutbox);
+	}
+
 	TEST_F(Outbox, CheckComponent)
 	{
 		auto components = model->GetComponentsObjects();
@@ -102,6 +102,113 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(Properties, SetGetUniformWithOverrides)
+	{
+		auto baseMaterialGroup = model->AddBaseMaterialGroup();
+		auto someMaterial = baseMaterialGroup->AddMaterial("SomeMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+		auto anotherMaterial = baseMaterialGroup->AddMaterial("AnotherMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+
+		std::vector<sTriangleProperties> properties(mesh->GetTriangleCount());
+		for (Lib3MF_uint64 i = 0; i < mesh->GetTriangleCount(); i++) {
+			properties[i].m_ResourceID = baseMaterialGroup->GetResourceID();
+			for (int j = 0; j < 3; j++) {
+				properties[i].m_PropertyIDs[j] = someMaterial;
+			}
+		}
+		mesh->SetAllTriangleProperties(properties);
+
+		sTriangleProperties otherProperties;
+		otherProperties.m_ResourceID = baseMaterialGroup->GetResourceID();
+		for (int j = 0; j < 3; j++) {
+			otherProperties.m_PropertyIDs[j] = anotherMaterial;
+		}
+		mesh->SetTriangleProperties(0, otherProperties);
+		mesh->SetTriangleProperties(5, otherProperties);
+		mesh->SetTriangleProperties(6, otherProperties);
+		mesh->SetTriangleProperties(5, properties[5]);
+
+		mesh->GetAllTriangleProperties(properties);
+		for (Lib3MF_uint64 i = 0; i < mesh->GetTriangleCount(); i++) {
+			EXPECT_EQ(properties[i].m_ResourceID, baseMaterialGroup->GetResourceID());
+			for (Lib3MF_uint64 j = 0; j < 3; j++) {
+				EXPECT_EQ(properties[i].m_PropertyIDs[j], ((i == 0) || (i == 6)) ? anotherMaterial : someMaterial);
+			}
+		}
+	}
+
+	TEST_F(Properties, SetGetRange)
+	{
+		auto baseMaterialGroup = model->AddBaseMaterialGroup();
+		auto someMaterial = baseMaterialGroup->AddMaterial("SomeMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+		auto anotherMaterial = baseMaterialGroup->AddMaterial("AnotherMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+
+		std::vector<sTriangleProperties> properties(4);
+		for (Lib3MF_uint64 i = 0; i < properties.size(); i++) {
+			properties[i].m_ResourceID = baseMaterialGroup->GetResourceID();
+			for (int j = 0; j < 3; j++) {
+				properties[i].m_PropertyIDs[j] = (i % 2) ? anotherMaterial : someMaterial;
+			}
+		}
+		mesh->SetTrianglePropertiesRange(3, properties);
+
+		std::vector<sTriangleProperties> rangeProperties;
+		mesh->GetTrianglePropertiesRange(2, 6, rangeProperties);
+		ASSERT_EQ(rangeProperties.size(), 6);
+		EXPECT_EQ(rangeProperties[0].m_ResourceID, 0);
+		EXPECT_EQ(rangeProperties[5].m_ResourceID, 0);
+		for (Lib3MF_uint64 i = 0; i < properties.size(); i++) {
+			EXPECT_EQ(rangeProperties[i + 1].m_ResourceID, properties[i].m_ResourceID);
+			for (Lib3MF_uint64 j = 0; j < 3; j++) {
+				EXPECT_EQ(rangeProperties[i + 1].m_PropertyIDs[j], properties[i].m_PropertyIDs[j]);
+			}
+		}
+
+		ASSERT_SPECIFIC_THROW(mesh->SetTrianglePropertiesRange(mesh->GetTriangleCount() - 3, properties), ELib3MFException);
+		ASSERT_SPECIFIC_THROW(mesh->GetTrianglePropertiesRange(mesh->GetTriangleCount(), 1, rangeProperties), ELib3MFException);
+	}
+
+	TEST_F(Properties, SetSparseDescending)
+	{
+		// Many sparse writes in descending order, which split runs in front of all existing ones
+		const Lib3MF_uint32 nTriangleCount = 100000;
+		std::vector<sPosition> vertices(nTriangleCount + 2);
+		std::vector<sTriangle> triangles(nTriangleCount);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount + 2; i++)
+			vertices[i] = fnCreateVertex(0.5f * (i / 2), (float)(i % 2), 0.0f);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++)
+			triangles[i] = fnCreateTriangle(i, i + 1, i + 2);
+		auto largeMesh = model->AddMeshObject();
+		largeMesh->SetGeometry(vertices, triangles);
+
+		auto baseMaterialGroup = model->AddBaseMaterialGroup();
+		auto someMaterial = baseMaterialGroup->AddMaterial("SomeMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+		auto anotherMaterial = baseMaterialGroup->AddMaterial("AnotherMaterial", wrapper->RGBAToColor(100, 200, 150, 255));
+
+		sTriangleProperties properties;
+		properties.m_ResourceID = baseMaterialGroup->GetResourceID();
+		for (Lib3MF_uint32 i = nTriangleCount / 7; i > 0; i--) {
+			for (int j = 0; j < 3; j++)
+				properties.m_PropertyIDs[j] = (i % 2) ? anotherMaterial : someMaterial;
+			largeMesh->SetTriangleProperties((i - 1) * 7, properties);
+		}
+
+		std::vector<sTriangleProperties> allProperties;
+		largeMesh->GetAllTriangleProperties(allProperties);
+		ASSERT_EQ(allProperties.size(), nTriangleCount);
+		Lib3MF_uint32 nMismatchCount = 0;
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			Lib3MF_uint32 nExpectedResourceID = 0;
+			Lib3MF_uint32 nExpectedPropertyID = 0;
+			if ((i % 7 == 0) && (i / 7 < nTriangleCount / 7)) {
+				nExpectedResourceID = baseMaterialGroup->GetResourceID();
+				nExpectedPropertyID = ((i / 7 + 1) % 2) ? anotherMaterial : someMaterial;
+			}
+			if ((allProperties[i].m_ResourceID != nExpectedResourceID) || (allProperties[i].m_PropertyIDs[0] != nExpectedPropertyID))
+				nMismatchCount++;
+		}
+		EXPECT_EQ(nMismatchCount, 0);
+	}
+
 	TEST_F(Properties, ObjectLevelPropertiesSetGet)
 	{
 		auto baseMaterialGroup = model->AddBaseMaterialGroup();
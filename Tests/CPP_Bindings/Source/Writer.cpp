@@ -32,6 +32,9 @@ UnitTest_Writer.cpp: Defines Unittests for the Writer classes
 
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
+#include <algorithm>
+#include <atomic>
+#include <future>
 
 namespace Lib3MF
 {
@@ -147,6 +150,384 @@ namespace Lib3MF
 		ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), callbackBuffer.vec.begin()));
 	}
 
+	TEST_F(Writer, 3MFWriteToCallbackWithoutSeek)
+	{
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		Writer::writer3MF->WriteToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer));
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromBuffer(callbackBuffer.vec);
+
+		ASSERT_EQ(readModel->GetMeshObjects()->Count(), model->GetMeshObjects()->Count());
+		ASSERT_EQ(readModel->GetBuildItems()->Count(), model->GetBuildItems()->Count());
+	}
+
+	TEST_F(Writer, 3MFWriteToFileAsync)
+	{
+		auto writeOperation = Writer::writer3MF->WriteToFileAsync(Writer::OutFolder + "PyramidAsync.3mf");
+		while (!writeOperation->WaitFor(10)) {
+		}
+		ASSERT_TRUE(writeOperation->IsFinished());
+		writeOperation->Finish();
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromFile(Writer::OutFolder + "PyramidAsync.3mf");
+		ASSERT_EQ(readModel->GetMeshObjects()->Count(), model->GetMeshObjects()->Count());
+
+		// The writer can be used again once the operation has finished
+		Writer::writer3MF->WriteToFile(Writer::OutFolder + "Pyramid.3mf");
+	}
+
+	// Holds the write operation in its first progress callback until the test has cancelled it
+	struct sCancelGate {
+		std::promise<void> m_Started;
+		std::promise<void> m_Released;
+		std::atomic<bool> m_bWaited;
+	};
+
+	void Callback_WaitForCancel(bool* pAbort, Lib3MF_double dProgress, eProgressIdentifier identifier, Lib3MF_pvoid pUserData)
+	{
+		sCancelGate * pGate = reinterpret_cast<sCancelGate *>(pUserData);
+		if (!pGate->m_bWaited.exchange(true)) {
+			pGate->m_Started.set_value();
+			pGate->m_Released.get_future().wait();
+		}
+		*pAbort = false;
+	}
+
+	TEST_F(Writer, 3MFWriteToFileAsyncCancel)
+	{
+		sCancelGate gate;
+		gate.m_bWaited = false;
+		Writer::writer3MF->SetProgressCallback(Callback_WaitForCancel, reinterpret_cast<Lib3MF_pvoid>(&gate));
+
+		auto writeOperation = Writer::writer3MF->WriteToFileAsync(Writer::OutFolder + "PyramidCancelled.3mf");
+		gate.m_Started.get_future().wait();
+		writeOperation->Cancel();
+		gate.m_Released.set_value();
+
+		try {
+			writeOperation->Finish();
+			FAIL() << "A cancelled write operation must fail";
+		}
+		catch (ELib3MFException &e) {
+			ASSERT_EQ(e.getErrorCode(), LIB3MF_ERROR_CALCULATIONABORTED);
+		}
+		ASSERT_TRUE(writeOperation->IsFinished());
+
+		// A cancelled operation does not affect the next write
+		Writer::writer3MF->WriteToFile(Writer::OutFolder + "Pyramid.3mf");
+	}
+
+	// Corner coordinates and properties of every triangle, in sorted order. Colors are described by value,
+	// since resource and property IDs may change when a model is written and read again.
+	std::vector<std::vector<float>> DescribeTriangles(PModel pModel, PMeshObject pMesh)
+	{
+		std::vector<sPosition> vertices;
+		std::vector<sTriangle> triangles;
+		std::vector<sTriangleProperties> properties;
+		pMesh->GetVertices(vertices);
+		pMesh->GetTriangleIndices(triangles);
+		pMesh->GetAllTriangleProperties(properties);
+
+		std::vector<std::vector<float>> descriptions(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++) {
+			for (int j = 0; j < 3; j++)
+				for (int k = 0; k < 3; k++)
+					descriptions[i].push_back(vertices[triangles[i].m_Indices[j]].m_Coordinates[k]);
+
+			if ((properties[i].m_ResourceID != 0) && (pModel->GetPropertyTypeByID(properties[i].m_ResourceID) == ePropertyType::Colors)) {
+				auto colorGroup = pModel->GetColorGroupByID(properties[i].m_ResourceID);
+				for (int j = 0; j < 3; j++) {
+					sColor color = colorGroup->GetColor(properties[i].m_PropertyIDs[j]);
+					descriptions[i].push_back(color.m_Red);
+					descriptions[i].push_back(color.m_Green);
+					descriptions[i].push_back(color.m_Blue);
+					descriptions[i].push_back(color.m_Alpha);
+				}
+			}
+			else {
+				for (int j = 0; j < 3; j++)
+					descriptions[i].push_back((float)properties[i].m_PropertyIDs[j]);
+			}
+		}
+		std::sort(descriptions.begin(), descriptions.end());
+		return descriptions;
+	}
+
+	TEST_F(Writer, 3MFVertexCacheOptimization)
+	{
+		// Per-corner colors, which have to stay attached to their corners when triangles and vertices are reordered
+		auto coloredMesh = model->AddMeshObject();
+		std::vector<sPosition> vertices;
+		std::vector<sTriangle> triangles;
+		for (int i = 0; i < 8; i++)
+			vertices.push_back(fnCreateVertex((float)(i & 1), (float)((i >> 1) & 1), (float)((i >> 2) & 1)));
+		int faces[12][3] = { { 0, 2, 1 }, { 1, 2, 3 }, { 4, 5, 6 }, { 5, 7, 6 }, { 0, 1, 4 }, { 1, 5, 4 }, { 2, 6, 3 }, { 3, 6, 7 }, { 0, 4, 2 }, { 2, 4, 6 }, { 1, 3, 5 }, { 3, 7, 5 } };
+		for (int i = 0; i < 12; i++)
+			triangles.push_back(fnCreateTriangle(faces[i][0], faces[i][1], faces[i][2]));
+		coloredMesh->SetGeometry(vertices, triangles);
+
+		auto colorGroup = model->AddColorGroup();
+		std::vector<sTriangleProperties> properties(12);
+		for (int i = 0; i < 12; i++) {
+			properties[i].m_ResourceID = colorGroup->GetResourceID();
+			for (int j = 0; j < 3; j++)
+				properties[i].m_PropertyIDs[j] = colorGroup->AddColor(wrapper->RGBAToColor((Lib3MF_uint8)(20 * i), (Lib3MF_uint8)(80 * j), 100, 255));
+		}
+		coloredMesh->SetAllTriangleProperties(properties);
+		model->AddBuildItem(coloredMesh.get(), getIdentityTransform());
+
+		ASSERT_FALSE(Writer::writer3MF->GetVertexCacheOptimization());
+		Writer::writer3MF->SetVertexCacheOptimization(true);
+		ASSERT_TRUE(Writer::writer3MF->GetVertexCacheOptimization());
+		Writer::writer3MF->WriteToFile(Writer::OutFolder + "PyramidOptimized.3mf");
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromFile(Writer::OutFolder + "PyramidOptimized.3mf");
+
+		auto meshObjects = model->GetMeshObjects();
+		auto readMeshObjects = readModel->GetMeshObjects();
+		ASSERT_EQ(readMeshObjects->Count(), meshObjects->Count());
+		while (meshObjects->MoveNext()) {
+			ASSERT_TRUE(readMeshObjects->MoveNext());
+			auto mesh = meshObjects->GetCurrentMeshObject();
+			auto readMesh = readMeshObjects->GetCurrentMeshObject();
+			ASSERT_EQ(readMesh->GetVertexCount(), mesh->GetVertexCount());
+			ASSERT_EQ(readMesh->GetTriangleCount(), mesh->GetTriangleCount());
+			ASSERT_TRUE(DescribeTriangles(readModel, readMesh) == DescribeTriangles(model, mesh));
+		}
+	}
+
+	TEST_F(Writer, 3MFVertexCacheOptimizationBeamLattice)
+	{
+		// Beams between the corners of a tetrahedron and a vertex which is only used by beams
+		auto mesh = model->AddMeshObject();
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } }, { { 5.0f, 5.0f, 5.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		mesh->SetGeometry(vertices, triangles);
+
+		auto beamLattice = mesh->BeamLattice();
+		for (Lib3MF_uint32 i = 0; i < 4; i++) {
+			sBeam beam;
+			beam.m_Indices[0] = i;
+			beam.m_Indices[1] = (i == 3) ? 0 : 4;
+			beam.m_Radii[0] = 0.5 + 0.125 * i;
+			beam.m_Radii[1] = 0.25;
+			beam.m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+			beam.m_CapModes[1] = eBeamLatticeCapMode::Butt;
+			beamLattice->AddBeam(beam);
+		}
+		model->AddBuildItem(mesh.get(), getIdentityTransform());
+
+		Writer::writer3MF->SetVertexCacheOptimization(true);
+		std::vector<Lib3MF_uint8> buffer;
+		Writer::writer3MF->WriteToBuffer(buffer);
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromBuffer(buffer);
+
+		auto readMeshObjects = readModel->GetMeshObjects();
+		PMeshObject readMesh;
+		while (readMeshObjects->MoveNext()) {
+			if (readMeshObjects->GetCurrentMeshObject()->BeamLattice()->GetBeamCount() > 0)
+				readMesh = readMeshObjects->GetCurrentMeshObject();
+		}
+		ASSERT_TRUE(readMesh.get() != nullptr);
+		ASSERT_EQ(readMesh->GetVertexCount(), mesh->GetVertexCount());
+		ASSERT_TRUE(DescribeTriangles(readModel, readMesh) == DescribeTriangles(model, mesh));
+
+		// Beams are written in their original order, with their end points remapped to the new vertex order
+		std::vector<sBeam> beams, readBeams;
+		beamLattice->GetBeams(beams);
+		readMesh->BeamLattice()->GetBeams(readBeams);
+		ASSERT_EQ(readBeams.size(), beams.size());
+		for (size_t i = 0; i < beams.size(); i++) {
+			for (int j = 0; j < 2; j++) {
+				sPosition vertex = mesh->GetVertex(beams[i].m_Indices[j]);
+				sPosition readVertex = readMesh->GetVertex(readBeams[i].m_Indices[j]);
+				for (int k = 0; k < 3; k++)
+					EXPECT_EQ(readVertex.m_Coordinates[k], vertex.m_Coordinates[k]);
+				EXPECT_EQ(readBeams[i].m_Radii[j], beams[i].m_Radii[j]);
+				EXPECT_EQ(readBeams[i].m_CapModes[j], beams[i].m_CapModes[j]);
+			}
+		}
+	}
+
+	TEST_F(Writer, 3MFMeshDeduplication)
+	{
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 0, 2, 1 } }, { { 0, 1, 3 } }, { { 0, 3, 2 } }, { { 1, 2, 3 } } };
+		for (int i = 0; i < 3; i++) {
+			auto copy = model->AddMeshObject();
+			copy->SetGeometry(vertices, triangles);
+			model->AddBuildItem(copy.get(), getIdentityTransform());
+		}
+
+		ASSERT_FALSE(Writer::writer3MF->GetMeshDeduplication());
+		Writer::writer3MF->SetMeshDeduplication(true);
+		ASSERT_TRUE(Writer::writer3MF->GetMeshDeduplication());
+		ASSERT_FALSE(Writer::writer3MF->GetRigidMeshDeduplication());
+		std::vector<Lib3MF_uint8> buffer;
+		Writer::writer3MF->WriteToBuffer(buffer);
+
+		auto readModel = wrapper->CreateModel();
+		readModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+		ASSERT_EQ(readModel->GetMeshObjects()->Count(), model->GetMeshObjects()->Count() - 2);
+		ASSERT_EQ(readModel->GetComponentsObjects()->Count(), model->GetComponentsObjects()->Count() + 2);
+		ASSERT_EQ(readModel->GetBuildItems()->Count(), model->GetBuildItems()->Count());
+
+		// The UUIDs of the generated components are derived from the object UUIDs
+		std::vector<Lib3MF_uint8> secondBuffer;
+		Writer::writer3MF->WriteToBuffer(secondBuffer);
+		ASSERT_TRUE(secondBuffer == buffer);
+
+		// Streamed meshes are released before all duplicates are known
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		ASSERT_SPECIFIC_THROW(Writer::writer3MF->BeginStreamToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer)), ELib3MFException);
+	}
+
+	TEST_F(Writer, 3MFStreamToCallback)
+	{
+		auto streamModel = wrapper->CreateModel();
+		auto streamWriter = streamModel->QueryWriter("3mf");
+
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		streamWriter->BeginStreamToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer));
+
+		std::vector<sPosition> vctVertices;
+		std::vector<sTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+
+		const Lib3MF_uint32 nMeshCount = 10;
+		for (Lib3MF_uint32 nIndex = 0; nIndex < nMeshCount; nIndex++) {
+			auto mesh = streamModel->AddMeshObject();
+			mesh->SetGeometry(vctVertices, vctTriangles);
+			streamModel->AddBuildItem(mesh.get(), getIdentityTransform());
+			streamWriter->AppendObject(mesh.get());
+			ASSERT_EQ(mesh->GetVertexCount(), vctVertices.size());
+			ASSERT_SPECIFIC_THROW(streamWriter->AppendObject(mesh.get()), ELib3MFException);
+		}
+		streamWriter->FinishStream();
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromBuffer(callbackBuffer.vec);
+
+		ASSERT_EQ(readModel->GetMeshObjects()->Count(), nMeshCount);
+		ASSERT_EQ(readModel->GetBuildItems()->Count(), nMeshCount);
+		auto meshObjects = readModel->GetMeshObjects();
+		while (meshObjects->MoveNext()) {
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), vctVertices.size());
+		}
+
+		// The streamed model is left intact and can be written again
+		meshObjects = streamModel->GetMeshObjects();
+		while (meshObjects->MoveNext()) {
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), vctVertices.size());
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetTriangleCount(), vctTriangles.size());
+		}
+		std::vector<Lib3MF_uint8> buffer;
+		streamWriter->WriteToBuffer(buffer);
+		auto rereadModel = wrapper->CreateModel();
+		rereadModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+		meshObjects = rereadModel->GetMeshObjects();
+		ASSERT_EQ(meshObjects->Count(), nMeshCount);
+		while (meshObjects->MoveNext()) {
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), vctVertices.size());
+		}
+	}
+
+	TEST_F(Writer, 3MFStreamReleaseMeshes)
+	{
+		auto streamModel = wrapper->CreateModel();
+		auto streamWriter = streamModel->QueryWriter("3mf");
+		ASSERT_FALSE(streamWriter->GetReleaseStreamedMeshes());
+		streamWriter->SetReleaseStreamedMeshes(true);
+		ASSERT_TRUE(streamWriter->GetReleaseStreamedMeshes());
+
+		std::vector<sPosition> vctVertices;
+		std::vector<sTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+
+		// One object is appended explicitly, the other one is written by FinishStream
+		auto appendedMesh = streamModel->AddMeshObject();
+		appendedMesh->SetGeometry(vctVertices, vctTriangles);
+		streamModel->AddBuildItem(appendedMesh.get(), getIdentityTransform());
+
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		streamWriter->BeginStreamToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer));
+		streamWriter->AppendObject(appendedMesh.get());
+		ASSERT_EQ(appendedMesh->GetVertexCount(), 0);
+
+		auto finishedMesh = streamModel->AddMeshObject();
+		finishedMesh->SetGeometry(vctVertices, vctTriangles);
+		streamModel->AddBuildItem(finishedMesh.get(), getIdentityTransform());
+		streamWriter->FinishStream();
+		ASSERT_EQ(finishedMesh->GetVertexCount(), 0);
+		ASSERT_EQ(finishedMesh->GetTriangleCount(), 0);
+
+		auto readModel = wrapper->CreateModel();
+		readModel->QueryReader("3mf")->ReadFromBuffer(callbackBuffer.vec);
+		auto meshObjects = readModel->GetMeshObjects();
+		ASSERT_EQ(meshObjects->Count(), 2);
+		while (meshObjects->MoveNext()) {
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), vctVertices.size());
+		}
+	}
+
+	TEST_F(Writer, 3MFStreamMetaDataNameSpace)
+	{
+		auto streamModel = wrapper->CreateModel();
+		auto streamWriter = streamModel->QueryWriter("3mf");
+		streamModel->GetMetaDataGroup()->AddMetaData("http://www.example.com/model", "Name", "Model", "string", false);
+
+		PositionedVector<Lib3MF_uint8> callbackBuffer;
+		streamWriter->BeginStreamToCallback(PositionedVector<Lib3MF_uint8>::writeCallback,
+			nullptr, reinterpret_cast<Lib3MF_pvoid>(&callbackBuffer));
+
+		std::vector<sPosition> vctVertices;
+		std::vector<sTriangle> vctTriangles;
+		fnCreateBox(vctVertices, vctTriangles);
+
+		// The namespaces of objects and build items that are added after the stream has begun are declared on their elements
+		for (int i = 0; i < 2; i++) {
+			auto mesh = streamModel->AddMeshObject();
+			mesh->SetGeometry(vctVertices, vctTriangles);
+			mesh->GetMetaDataGroup()->AddMetaData("http://www.example.com/object", "Index", std::to_string(i), "string", false);
+			mesh->GetMetaDataGroup()->AddMetaData("http://www.example.com/model", "Name", "Object", "string", false);
+			auto buildItem = streamModel->AddBuildItem(mesh.get(), getIdentityTransform());
+			buildItem->GetMetaDataGroup()->AddMetaData("http://www.example.com/item", "Index", std::to_string(i), "string", false);
+			streamWriter->AppendObject(mesh.get());
+		}
+		streamWriter->FinishStream();
+
+		auto readModel = wrapper->CreateModel();
+		readModel->QueryReader("3mf")->ReadFromBuffer(callbackBuffer.vec);
+		ASSERT_EQ(readModel->GetMetaDataGroup()->GetMetaDataByKey("http://www.example.com/model", "Name")->GetValue(), "Model");
+		auto meshObjects = readModel->GetMeshObjects();
+		ASSERT_EQ(meshObjects->Count(), 2);
+		while (meshObjects->MoveNext()) {
+			auto metaDataGroup = meshObjects->GetCurrentMeshObject()->GetMetaDataGroup();
+			ASSERT_EQ(metaDataGroup->GetMetaDataCount(), 2);
+			ASSERT_EQ(metaDataGroup->GetMetaDataByKey("http://www.example.com/model", "Name")->GetValue(), "Object");
+			metaDataGroup->GetMetaDataByKey("http://www.example.com/object", "Index");
+		}
+		auto buildItems = readModel->GetBuildItems();
+		ASSERT_EQ(buildItems->Count(), 2);
+		while (buildItems->MoveNext()) {
+			buildItems->GetCurrentBuildItem()->GetMetaDataGroup()->GetMetaDataByKey("http://www.example.com/item", "Index");
+		}
+	}
+
 	TEST_F(Writer, STLWriteToCallback)
 	{
 		PositionedVector<Lib3MF_uint8> callbackBuffer;